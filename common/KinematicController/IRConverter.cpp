@@ -0,0 +1,73 @@
+#include <cmath>
+
+#include <common/KinematicController/IRConverter.h>
+
+constexpr unsigned int IRConverter::ADC_BITS;
+constexpr unsigned int IRConverter::TABLE_SIZE;
+constexpr double IRConverter::METERS_PER_UNIT;
+
+namespace {
+
+/// \brief ADC counts (10 bit) measured at every centimeter from .01 to .18 meters
+const int ir_lookup[18] = {
+    755, // .01
+    648, // .02
+    492, // .03
+    409, // .04
+    315, // .05
+    268, // .06
+    224, // .07
+    192, // .08
+    165, // .09
+    147, // .10
+    134, // .11
+    115, // .12
+    105, // .13
+    93,  // .14
+    86,  // .15
+    75,  // .16
+    68,  // .17
+    58,  // .18
+};
+
+}
+
+IRConverter::IRConverter() : calibration_offset(0) {
+  buildTable();
+}
+
+double IRConverter::curveToMeters(double adc, double calibration_offset) {
+  if (adc > 751) {
+    return 0.01;
+  } else if (adc <= 53) {
+    return 0.18;
+  } else {
+    for (int i = 1; i < 18; i++) {
+      if (adc >= ir_lookup[i]) {
+        // linear map between i and i+1, .01 meters spacing
+        return (adc - ir_lookup[i]) * 0.01 / (ir_lookup[i] - ir_lookup[i - 1]) + (i + 1) * .01 + calibration_offset;
+      }
+    }
+    return 0.18;
+  }
+}
+
+void IRConverter::calibrate(int avg_adc, double actual_dist_m) {
+  double scale = 1 << 10;
+  double expected_distance = curveToMeters(avg_adc * scale / TABLE_SIZE, 0);
+  calibration_offset = actual_dist_m - expected_distance;
+  buildTable();
+}
+
+double IRConverter::getCalibrationOffset() const {
+  return calibration_offset;
+}
+
+void IRConverter::buildTable() {
+  double scale = 1 << 10;
+  for (unsigned int adc = 0; adc < TABLE_SIZE; adc++) {
+    double meters = curveToMeters(adc * scale / TABLE_SIZE, calibration_offset);
+    meters = std::fmax(meters, 0);
+    table[adc] = (uint16_t) std::lround(meters / METERS_PER_UNIT);
+  }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * \brief turns raw ADC readings from one IR range sensor into meters with a single table lookup.
+ * The table has an entry for every possible reading, so it's rebuilt (not searched) whenever the sensor is
+ * calibrated. Every sensor gets its own converter, and so its own curve.
+ * Entries are stored in hundredths of a millimeter, so a converter is 2 bytes per ADC count.
+ */
+class IRConverter {
+public:
+  /// \brief must match analogReadResolution. The measured curve is in 10 bit counts, and is scaled to fit.
+  static constexpr unsigned int ADC_BITS = 10;
+  static constexpr unsigned int TABLE_SIZE = 1u << ADC_BITS;
+  static constexpr double METERS_PER_UNIT = 1e-5;
+
+  IRConverter();
+
+  double adcToMeters(int adc) const {
+    if (adc < 0) {
+      adc = 0;
+    } else if (adc >= (int) TABLE_SIZE) {
+      adc = TABLE_SIZE - 1;
+    }
+    return table[adc] * METERS_PER_UNIT;
+  }
+
+  /**
+   * \brief shift this sensor's curve so that a reading of avg_adc means actual_dist_m.
+   * This rewrites the table in place, so pause any RangeSampler that converts with it first.
+   */
+  void calibrate(int avg_adc, double actual_dist_m);
+
+  /** \brief how far the curve is shifted from the measured one */
+  double getCalibrationOffset() const;
+
+  /** \brief the measured curve shifted by an offset, found by searching the measured points. Only used to build the
+   * table, since it's the slow way to do a conversion.
+   */
+  static double curveToMeters(double adc_10_bit, double calibration_offset);
+
+private:
+  void buildTable();
+
+  double calibration_offset;
+  uint16_t table[TABLE_SIZE];
+};
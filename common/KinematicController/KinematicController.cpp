@@ -9,11 +9,14 @@
 const double KinematicController::DROP_SAFETY = 0.8;
 const double KinematicController::kPWall = 0.80;
 const double KinematicController::kPYaw = 7.0;
+const double KinematicController::kPProfile = 2.0;
 
 KinematicController::KinematicController(Mouse *mouse)
     : enable_sensor_pose_estimate(false), enabled(true), kinematics_enabled(true), initialized(false),
       ignoring_left(false), ignoring_right(false), mouse(mouse),
-      d_until_left_drop(0), d_until_right_drop(0) {
+      d_until_left_drop(0), d_until_right_drop(0), acceleration_cellpss(smartmouse::kc::MAX_ACCEL_CUPSS), dt_s(0),
+      following(&profile), profile_s(0), profile_t(0), trajectory(), trajectory_t(0), last_front_left_analog_dist(0), last_front_right_analog_dist(0),
+      last_back_left_analog_dist(0), last_back_right_analog_dist(0), abstract_forces(0, 0), executive(nullptr) {
   current_pose_estimate.col = 0;
   current_pose_estimate.row = 0;
   current_pose_estimate.yaw = 0;
@@ -70,10 +73,21 @@ void KinematicController::reset_yaw_to(double new_yaw) {
 
 std::pair<double, double>
 KinematicController::run(double dt_s, double left_angle_rad, double right_angle_rad, RangeData range_data) {
-  static std::pair<double, double> abstract_forces;
+  WheelState wheels = {};
+  if (executive) {
+    sendCommand();
+    wheels = executive->state();
+    left_motor.velocity_rps = wheels.left_velocity_rps;
+    right_motor.velocity_rps = wheels.right_velocity_rps;
+    left_motor.abstract_force = wheels.left_force;
+    right_motor.abstract_force = wheels.right_force;
+  }
 
   if (!initialized) {
     initialized = true;
+    if (executive) {
+      last_odometry = wheels.odometry;
+    }
     abstract_forces.first = 0;
     abstract_forces.second = 0;
     return abstract_forces;
@@ -85,12 +99,22 @@ KinematicController::run(double dt_s, double left_angle_rad, double right_angle_
 
   if (enabled) {
     if (kinematics_enabled) {
-      // equations based on docs/dynamics_model.pdf
-      double vl_cu = smartmouse::kc::radToCU(left_motor.velocity_rps);
-      double vr_cu = smartmouse::kc::radToCU(right_motor.velocity_rps);
-
       GlobalPose d_pose;
-      d_pose = forwardKinematics(vr_cu, vl_cu, current_pose_estimate.yaw, dt_s);
+      if (executive) {
+        // the executive integrated the odometry at the fast rate in its own frame, so rotate its change since the
+        // last run into our frame
+        double dcol = wheels.odometry.col - last_odometry.col;
+        double drow = wheels.odometry.row - last_odometry.row;
+        double frame_yaw = current_pose_estimate.yaw - last_odometry.yaw;
+        d_pose.col = dcol * cos(frame_yaw) - drow * sin(frame_yaw);
+        d_pose.row = dcol * sin(frame_yaw) + drow * cos(frame_yaw);
+        d_pose.yaw = wheels.odometry.yaw - last_odometry.yaw;
+      } else {
+        // equations based on docs/dynamics_model.pdf
+        double vl_cu = smartmouse::kc::radToCU(left_motor.velocity_rps);
+        double vr_cu = smartmouse::kc::radToCU(right_motor.velocity_rps);
+        d_pose = forwardKinematics(vr_cu, vl_cu, current_pose_estimate.yaw, dt_s);
+      }
       current_pose_estimate.col += d_pose.col;
       current_pose_estimate.row += d_pose.row;
       current_pose_estimate.yaw += d_pose.yaw;
@@ -143,14 +167,24 @@ KinematicController::run(double dt_s, double left_angle_rad, double right_angle_
       }
     }
 
-    // run PID, which will update the velocities of the wheels
-    abstract_forces.first = left_motor.runPid(dt_s, left_angle_rad);
-    abstract_forces.second = right_motor.runPid(dt_s, right_angle_rad);
+    if (executive) {
+      // the executive already applied these
+      abstract_forces.first = wheels.left_force;
+      abstract_forces.second = wheels.right_force;
+    } else {
+      // run PID, which will update the velocities of the wheels
+      abstract_forces.first = left_motor.runPid(dt_s, left_angle_rad);
+      abstract_forces.second = right_motor.runPid(dt_s, right_angle_rad);
+    }
   } else {
     abstract_forces.first = 0;
     abstract_forces.second = 0;
   }
 
+  if (executive) {
+    last_odometry = wheels.odometry;
+  }
+
   return abstract_forces;
 }
 
@@ -180,10 +214,6 @@ GlobalPose KinematicController::forwardKinematics(double vl_cups, double vr_cups
 }
 
 std::tuple<double, double, bool> KinematicController::estimate_pose(RangeData range_data, Mouse *mouse) {
-  static double last_front_left_analog_dist;
-  static double last_front_right_analog_dist;
-  static double last_back_left_analog_dist;
-  static double last_back_right_analog_dist;
   std::tuple<double, double, bool> newest_estimate;
 
   double *yaw = &std::get<0>(newest_estimate);
@@ -268,12 +298,37 @@ void KinematicController::setAccelerationCpss(double acceleration_cpss) {
   this->acceleration_cellpss = acceleration_cpss;
   left_motor.setAccelerationCpss(acceleration_cpss);
   right_motor.setAccelerationCpss(acceleration_cpss);
+  sendCommand();
 }
 
 void KinematicController::setSpeedCps(double left_setpoint_cps,
                                       double right_setpoint_cps) {
   left_motor.setSetpointCps(left_setpoint_cps);
   right_motor.setSetpointCps(right_setpoint_cps);
+  sendCommand();
+}
+
+void KinematicController::useExecutive(MultiRateExecutive *executive) {
+  this->executive = executive;
+  sendCommand();
+}
+
+void KinematicController::sendCommand() {
+  if (!executive) {
+    return;
+  }
+
+  MotorCommand cmd;
+  cmd.left_setpoint_rps = left_motor.setpoint_rps;
+  cmd.right_setpoint_rps = right_motor.setpoint_rps;
+  cmd.acceleration_rpss = left_motor.acceleration_rpss;
+  cmd.kP = left_motor.kP;
+  cmd.kI = left_motor.kI;
+  cmd.kD = left_motor.kD;
+  cmd.ff_scale = left_motor.ff_scale;
+  cmd.ff_offset = left_motor.ff_offset;
+  cmd.enabled = enabled;
+  executive->command(cmd);
 }
 
 void KinematicController::start(GlobalPose start_pose, double goalDisp, double v_final) {
@@ -281,13 +336,59 @@ void KinematicController::start(GlobalPose start_pose, double goalDisp, double v
   drive_straight_state.dispError = goalDisp;
   drive_straight_state.goalDisp = goalDisp;
   drive_straight_state.start_pose = start_pose;
-  drive_straight_state.forward_v = (left_motor.velocity_rps + right_motor.velocity_rps) / 2;
+  drive_straight_state.forward_v = smartmouse::kc::radToCU((left_motor.velocity_rps + right_motor.velocity_rps) / 2);
   drive_straight_state.v_final = v_final;
+
+  profile.planStraight(goalDisp, std::max(drive_straight_state.forward_v, 0.0), v_final, profileLimits());
+  following = &profile;
+  profile_s = 0;
+  profile_t = 0;
+}
+
+void KinematicController::startAlong(GlobalPose start_pose, double goalDisp, const VelocityProfile *route_profile,
+                                     double s) {
+  drive_straight_state.disp = 0;
+  drive_straight_state.dispError = goalDisp;
+  drive_straight_state.goalDisp = goalDisp;
+  drive_straight_state.start_pose = start_pose;
+  drive_straight_state.forward_v = smartmouse::kc::radToCU((left_motor.velocity_rps + right_motor.velocity_rps) / 2);
+  drive_straight_state.v_final = route_profile->speedAt(s + goalDisp);
+
+  // turns aren't part of the profile, so pick it up again where this straight starts
+  following = route_profile;
+  profile_s = s;
+  profile_t = route_profile->timeAt(s);
 }
 
-void KinematicController::planTraj(Waypoints waypoints) {
-  TrajectoryPlanner planner(waypoints);
-  Eigen::Matrix<double, 10, 1> plan = planner.plan();
+const VelocityProfile &KinematicController::currentProfile() const {
+  return *following;
+}
+
+ProfileLimits KinematicController::profileLimits() {
+  return {smartmouse::kc::MAX_SPEED_CUPS, acceleration_cellpss, smartmouse::kc::MAX_JERK_CUPSSS};
+}
+
+bool KinematicController::planTraj(std::initializer_list<Waypoint> waypoints) {
+  TrajectoryPlanner planner;
+  for (const Waypoint &waypoint : waypoints) {
+    if (!planner.addWaypoint(waypoint)) {
+      return false;
+    }
+  }
+  if (!planner.plan(&trajectory)) {
+    return false;
+  }
+  trajectory_t = 0;
+  return true;
+}
+
+std::pair<double, double> KinematicController::trajectoryWheelVelocities() {
+  trajectory_t += dt_s;
+  return trajectory.wheelVelocities(trajectory_t);
+}
+
+bool KinematicController::trajectoryFinished() {
+  return trajectory_t >= trajectory.start_time + trajectory.duration;
 }
 
 std::pair<double, double> KinematicController::compute_wheel_velocities(Mouse *mouse) {
@@ -302,23 +403,16 @@ std::pair<double, double> KinematicController::compute_wheel_velocities(Mouse *m
   // To achieve this, we control our yaw as a function of our error in wall distance
   double yawError = KinematicController::yawDiff(goalYaw, current_pose.yaw);
 
-  // given starting velocity, fixed acceleration, and final velocity
-  // generate the velocity profile for achieving this as fast as possible
-  double ramp_d =
-      (pow(drive_straight_state.forward_v, 2) - pow(drive_straight_state.v_final, 2)) / (2.0 * acceleration_cellpss);
-  double acc = acceleration_cellpss * dt_s;
-  if (drive_straight_state.dispError < ramp_d) {
-    drive_straight_state.forward_v -= acc;
-  } else if (drive_straight_state.forward_v < smartmouse::kc::MAX_SPEED_CUPS) {
-    drive_straight_state.forward_v += acc;
-  }
+  // follow the profile, and make up for falling behind or getting ahead of it
+  profile_t += dt_s;
+  ProfileSample target = following->sample(profile_t);
+  drive_straight_state.forward_v = target.v + kPProfile * (target.s - profile_s - drive_straight_state.disp);
 
+  // the profile does the speeding up and slowing down, so only keep it from creeping to the edge once it's over
   if (drive_straight_state.forward_v > smartmouse::kc::MAX_SPEED_CUPS) {
     drive_straight_state.forward_v = smartmouse::kc::MAX_SPEED_CUPS;
-  }
-    // TODO: this is problematic, at 180's we always stop and this is wrong
-  else if (drive_straight_state.forward_v < drive_straight_state.v_final) {
-    drive_straight_state.forward_v = drive_straight_state.v_final;
+  } else if (drive_straight_state.forward_v < smartmouse::kc::MIN_SPEED_CUPS) {
+    drive_straight_state.forward_v = smartmouse::kc::MIN_SPEED_CUPS;
   }
 
   drive_straight_state.left_speed_cellps = drive_straight_state.forward_v;
@@ -399,4 +493,5 @@ double KinematicController::fwdDispToCenter(Mouse *mouse) {
 void KinematicController::setParams(double kP, double kI, double kD, double ff_scale, double ff_offset) {
   left_motor.setParams(kP, kI, kD, ff_scale, ff_offset);
   right_motor.setParams(kP, kI, kD, ff_scale, ff_offset);
+  sendCommand();
 }
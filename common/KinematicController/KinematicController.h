@@ -1,5 +1,6 @@
 #pragma once
 
+#include <initializer_list>
 #include <utility>
 #include <common/core/util.h>
 #include <common/core/Pose.h>
@@ -7,6 +8,8 @@
 #include <common/KinematicController/TrajectoryPlanner.h>
 #include <common/core/Mouse.h>
 #include <common/KinematicController/RegulatedMotor.h>
+#include <common/KinematicController/MultiRateExecutive.h>
+#include <common/KinematicController/VelocityProfile.h>
 #include <tuple>
 
 struct drive_straight_state_t {
@@ -39,9 +42,35 @@ public:
 
   static GlobalPose forwardKinematics(double vl, double vr, double yaw, double dt);
 
-  void start(GlobalPose start_pose, double goalDisp, double v_final=smartmouse::kc::END_SPEED_MPS);
+  /**
+   * \brief start driving straight goalDisp cells, ending at v_final.
+   * This plans the whole speed profile from the current speed, and compute_wheel_velocities follows it.
+   */
+  void start(GlobalPose start_pose, double goalDisp, double v_final=smartmouse::kc::TURN_SPEED_CUPS);
 
-  void planTraj(Waypoints waypoints);
+  /**
+   * \brief start driving straight goalDisp cells, following a profile planned for a whole route from s cells along it
+   * instead of planning one for this straight. route_profile has to last until the drive is done.
+   */
+  void startAlong(GlobalPose start_pose, double goalDisp, const VelocityProfile *route_profile, double s);
+
+  /** \brief the profile the drive started by start or startAlong follows */
+  const VelocityProfile &currentProfile() const;
+
+  /** \brief the limits start plans with */
+  ProfileLimits profileLimits();
+
+  /**
+   * \brief fit a trajectory through the waypoints, with times in seconds from now.
+   * \return false if there are too few or too many waypoints, or their times don't increase
+   */
+  bool planTraj(std::initializer_list<Waypoint> waypoints);
+
+  /** \brief the wheel speeds that follow the planned trajectory, advancing along it by the last cycle time */
+  std::pair<double, double> trajectoryWheelVelocities();
+
+  /** \brief true once trajectoryWheelVelocities has reached the end of the trajectory */
+  bool trajectoryFinished();
 
   double sidewaysDispToCenter(Mouse *mouse);
 
@@ -69,9 +98,18 @@ public:
 
   void setSpeedCps(double left_setpoint_mps, double right_setpoint_mps);
 
+  /**
+   * \brief hand the wheel PIDs and odometry to the fast loop of a MultiRateExecutive.
+   * After this, run only does pose estimation. It reads the wheel velocities and odometry from the executive
+   * instead of running the PIDs itself, and the forces it returns are the ones the executive last applied.
+   * Setpoints, acceleration, and gains are passed on to the executive whenever they change.
+   */
+  void useExecutive(MultiRateExecutive *executive);
+
   static const double kPWall;
   static const double kDWall;
   static const double kPYaw;
+  static const double kPProfile;
 
   drive_straight_state_t drive_straight_state;
   void setParams(double kP, double kI, double kD, double ff_scale, double ff_offset);
@@ -97,4 +135,30 @@ private:
   static const double DROP_SAFETY;
   double acceleration_cellpss;
   double dt_s;
+
+  // the straight planned by start, the profile we're following, which is either that or a route's, where along it
+  // this drive started, and how far into it we are
+  VelocityProfile profile;
+  const VelocityProfile *following;
+  double profile_s;
+  double profile_t;
+
+  // the trajectory planned by planTraj, and how far into it we are
+  Trajectory trajectory;
+  double trajectory_t;
+
+  // the previous range readings, so estimate_pose can tell when a wall is appearing or disappearing
+  double last_front_left_analog_dist;
+  double last_front_right_analog_dist;
+  double last_back_left_analog_dist;
+  double last_back_right_analog_dist;
+
+  // the forces from the last call to run
+  std::pair<double, double> abstract_forces;
+
+  void sendCommand();
+
+  MultiRateExecutive *executive;
+  // the executive's odometry the last time run read it
+  GlobalPose last_odometry;
 };
@@ -0,0 +1,72 @@
+#include <common/math/math.h>
+#include <common/KinematicController/KinematicController.h>
+#include <common/KinematicController/MultiRateExecutive.h>
+
+constexpr double MultiRateExecutive::FAST_PERIOD_S;
+constexpr unsigned long MultiRateExecutive::FAST_PERIOD_US;
+
+MultiRateExecutive::MultiRateExecutive() : odometry(0, 0, 0), ticks(0) {
+  // start out stopped, with whatever gains RegulatedMotor defaults to
+  MotorCommand cmd = {};
+  cmd.kP = left_motor.kP;
+  cmd.kI = left_motor.kI;
+  cmd.kD = left_motor.kD;
+  cmd.ff_scale = left_motor.ff_scale;
+  cmd.ff_offset = left_motor.ff_offset;
+  cmd.enabled = true;
+  commands.write(cmd);
+
+  WheelState state = {};
+  state.odometry = odometry;
+  wheel_state.write(state);
+}
+
+std::pair<double, double> MultiRateExecutive::fastTick(double left_angle_rad, double right_angle_rad) {
+  MotorCommand cmd = commands.read();
+  for (RegulatedMotor *motor : {&left_motor, &right_motor}) {
+    motor->setParams(cmd.kP, cmd.kI, cmd.kD, cmd.ff_scale, cmd.ff_offset);
+    motor->acceleration_rpss = cmd.acceleration_rpss;
+  }
+  left_motor.setpoint_rps = cmd.left_setpoint_rps;
+  right_motor.setpoint_rps = cmd.right_setpoint_rps;
+
+  // run the PIDs even when disabled, so the velocities and odometry stay up to date
+  double left_force = left_motor.runPid(FAST_PERIOD_S, left_angle_rad);
+  double right_force = right_motor.runPid(FAST_PERIOD_S, right_angle_rad);
+  if (!cmd.enabled) {
+    left_force = 0;
+    right_force = 0;
+  }
+
+  // same equations, and same argument order, as KinematicController::run
+  double vl_cu = smartmouse::kc::radToCU(left_motor.velocity_rps);
+  double vr_cu = smartmouse::kc::radToCU(right_motor.velocity_rps);
+  GlobalPose d_pose = KinematicController::forwardKinematics(vr_cu, vl_cu, odometry.yaw, FAST_PERIOD_S);
+  odometry.col += d_pose.col;
+  odometry.row += d_pose.row;
+  odometry.yaw += d_pose.yaw;
+  ticks++;
+
+  WheelState state;
+  state.left_angle_rad = left_angle_rad;
+  state.right_angle_rad = right_angle_rad;
+  state.left_velocity_rps = left_motor.velocity_rps;
+  state.right_velocity_rps = right_motor.velocity_rps;
+  state.left_force = left_force;
+  state.right_force = right_force;
+  state.left_pid = left_motor.terms();
+  state.right_pid = right_motor.terms();
+  state.odometry = odometry;
+  state.ticks = ticks;
+  wheel_state.write(state);
+
+  return {left_force, right_force};
+}
+
+void MultiRateExecutive::command(const MotorCommand &cmd) {
+  commands.write(cmd);
+}
+
+WheelState MultiRateExecutive::state() const {
+  return wheel_state.read();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <utility>
+#include <common/core/DoubleBuffer.h>
+#include <common/core/Pose.h>
+#include <common/KinematicController/RegulatedMotor.h>
+
+/**
+ * \brief what the slow loop wants the wheels to do
+ */
+struct MotorCommand {
+  double left_setpoint_rps;
+  double right_setpoint_rps;
+  double acceleration_rpss;
+  double kP;
+  double kI;
+  double kD;
+  double ff_scale;
+  double ff_offset;
+  bool enabled;
+};
+
+/**
+ * \brief what the fast loop measured on its last tick
+ */
+struct WheelState {
+  double left_angle_rad;
+  double right_angle_rad;
+  double left_velocity_rps;
+  double right_velocity_rps;
+  double left_force;
+  double right_force;
+  PidTerms left_pid;
+  PidTerms right_pid;
+  /// dead reckoning integrated every fast tick. It starts at zero and is never corrected by the sensors,
+  /// so only the change between two reads means anything.
+  GlobalPose odometry;
+  unsigned long ticks;
+};
+
+/**
+ * \brief the fast half of a two rate controller.
+ * fastTick runs the wheel PIDs and odometry, and is meant to be called from a hardware timer interrupt at
+ * FAST_PERIOD_S. Everything else (sensors, pose estimation, commands, and solving) stays in the slow loop, which
+ * hands over setpoints with command() and reads back the wheels with state(). Those go through DoubleBuffers, so
+ * neither side ever waits for the other.
+ *
+ * Nothing in here touches hardware, so the console tests can drive it from a thread or call it in lock-step.
+ * Use KinematicController::useExecutive to make the kinematic controller the slow half.
+ */
+class MultiRateExecutive {
+public:
+  static constexpr double FAST_PERIOD_S = 0.001;
+  static constexpr unsigned long FAST_PERIOD_US = 1000;
+
+  MultiRateExecutive();
+
+  /**
+   * \brief fast side. Only ever call this from one context.
+   * \return the abstract forces for the left and right motors
+   */
+  std::pair<double, double> fastTick(double left_angle_rad, double right_angle_rad);
+
+  /** \brief slow side. Takes effect on the next fast tick */
+  void command(const MotorCommand &cmd);
+
+  /** \brief slow side. The state after the latest fast tick */
+  WheelState state() const;
+
+private:
+  // these belong to the fast side
+  RegulatedMotor left_motor;
+  RegulatedMotor right_motor;
+  GlobalPose odometry;
+  unsigned long ticks;
+
+  DoubleBuffer<MotorCommand> commands;
+  DoubleBuffer<WheelState> wheel_state;
+};
@@ -0,0 +1,81 @@
+#include <common/KinematicController/RangeSampler.h>
+#include <common/KinematicController/RobotConfig.h>
+
+namespace {
+
+/// \brief where each sensor goes in a RangeData, in RangeSensor order
+double RangeData::*const range_fields[RANGE_SENSOR_COUNT] = {
+    &RangeData::gerald_left,
+    &RangeData::gerald_right,
+    &RangeData::front_left,
+    &RangeData::front_right,
+    &RangeData::back_left,
+    &RangeData::back_right,
+    &RangeData::front,
+};
+
+}
+
+RangeSampler::RangeSampler(AdcInterface *adc, std::array<unsigned int, RANGE_SENSOR_COUNT> pins,
+                           std::array<const IRConverter *, RANGE_SENSOR_COUNT> converters, unsigned int oversampling)
+    : adc(adc), pins(pins), converters(converters), oversampling(oversampling > 0 ? oversampling : 1),
+      next_sensor(0), converting(false), pass(0), sums{}, count(0), paused(false) {
+  // until the first pass is done, everything reads as far away as the sensors can see
+  RangeSnapshot empty = {};
+  for (unsigned int i = 0; i < RANGE_SENSOR_COUNT; i++) {
+    empty.range_data.*range_fields[i] = smartmouse::kc::ANALOG_MAX_DIST_M;
+  }
+  snapshots.write(empty);
+}
+
+void RangeSampler::sample() {
+  if (paused.load(std::memory_order_acquire)) {
+    // the conversion in flight could be from long before resume, so it's dropped and next_sensor is converted again
+    converting = false;
+    return;
+  }
+
+  if (converting) {
+    sums[next_sensor] += adc->read();
+    next_sensor++;
+    if (next_sensor == RANGE_SENSOR_COUNT) {
+      next_sensor = 0;
+      pass++;
+      if (pass == oversampling) {
+        publish();
+        pass = 0;
+      }
+    }
+  }
+
+  adc->start(pins[next_sensor]);
+  converting = true;
+}
+
+void RangeSampler::publish() {
+  RangeSnapshot snapshot;
+  for (unsigned int i = 0; i < RANGE_SENSOR_COUNT; i++) {
+    int avg_adc = (int) ((sums[i] + oversampling / 2) / oversampling);
+    snapshot.adc[i] = (uint16_t) avg_adc;
+    snapshot.range_data.*range_fields[i] = converters[i]->adcToMeters(avg_adc);
+    sums[i] = 0;
+  }
+  snapshot.count = ++count;
+  snapshots.write(snapshot);
+}
+
+RangeSnapshot RangeSampler::latest() const {
+  return snapshots.read();
+}
+
+unsigned int RangeSampler::conversionsPerSnapshot() const {
+  return RANGE_SENSOR_COUNT * oversampling;
+}
+
+void RangeSampler::pause() {
+  paused.store(true, std::memory_order_release);
+}
+
+void RangeSampler::resume() {
+  paused.store(false, std::memory_order_release);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <common/core/DoubleBuffer.h>
+#include <common/core/Mouse.h>
+#include <common/KinematicController/IRConverter.h>
+
+/// \brief the range sensors, in the order RangeSampler samples them
+enum class RangeSensor : unsigned int {
+  GERALD_LEFT,
+  GERALD_RIGHT,
+  FRONT_LEFT,
+  FRONT_RIGHT,
+  BACK_LEFT,
+  BACK_RIGHT,
+  FRONT,
+  COUNT
+};
+
+constexpr unsigned int RANGE_SENSOR_COUNT = static_cast<unsigned int>(RangeSensor::COUNT);
+
+/**
+ * \brief conversions on analog pins, split so nobody has to wait on one. The ADC library on the robot, and scripted
+ * values in the tests.
+ */
+class AdcInterface {
+public:
+  virtual ~AdcInterface() = default;
+
+  /** \brief start a conversion on pin, and return without waiting for it */
+  virtual void start(unsigned int pin) = 0;
+
+  /** \brief the result of the conversion started last. Only waits if it was started less than a conversion ago */
+  virtual int read() = 0;
+};
+
+/**
+ * \brief every range sensor, converted to meters, from one complete pass over all of them
+ */
+struct RangeSnapshot {
+  RangeData range_data;
+  /// the averaged raw readings the distances came from
+  uint16_t adc[RANGE_SENSOR_COUNT];
+  /// number of snapshots published before and including this one, 0 if there hasn't been one yet
+  unsigned long count;
+};
+
+/**
+ * \brief samples all the range sensors in the background, one conversion per tick.
+ * Call sample() from a timer interrupt. Each call reads the conversion the last call started, which finished long
+ * ago, and starts the next one, so the interrupt never waits on the ADC. It goes round the sensors in order, and after
+ * `oversampling` passes it averages the readings, converts them to meters, and publishes a snapshot. The control loop
+ * reads the latest snapshot with latest(), which is a copy out of a DoubleBuffer.
+ *
+ * Going round all the sensors before repeating one gives each sensor the most time between its conversions.
+ */
+class RangeSampler {
+public:
+  RangeSampler(AdcInterface *adc, std::array<unsigned int, RANGE_SENSOR_COUNT> pins,
+               std::array<const IRConverter *, RANGE_SENSOR_COUNT> converters, unsigned int oversampling = 1);
+
+  /** \brief sampling side. Read the conversion started last time, start the next, and publish if that was the last */
+  void sample();
+
+  /** \brief reading side */
+  RangeSnapshot latest() const;
+
+  /** \brief conversions in one snapshot, which is also the number of calls to sample() between snapshots */
+  unsigned int conversionsPerSnapshot() const;
+
+  /**
+   * \brief make sample() do nothing until resume(). Pause before calibrating any of the converters, because sample()
+   * reads their tables. On the robot sample() runs in an interrupt, so once this returns it isn't halfway through one.
+   */
+  void pause();
+
+  void resume();
+
+private:
+  void publish();
+
+  AdcInterface *adc;
+  std::array<unsigned int, RANGE_SENSOR_COUNT> pins;
+  std::array<const IRConverter *, RANGE_SENSOR_COUNT> converters;
+  unsigned int oversampling;
+
+  // these belong to the sampling side
+  unsigned int next_sensor;
+  // whether a conversion for next_sensor has been started and not read yet
+  bool converting;
+  unsigned int pass;
+  uint32_t sums[RANGE_SENSOR_COUNT];
+  unsigned long count;
+
+  DoubleBuffer<RangeSnapshot> snapshots;
+  std::atomic<bool> paused;
+};
@@ -13,6 +13,9 @@ RegulatedMotor::RegulatedMotor()
       initialized(false),
       abstract_force(0),
       acceleration_rpss(0),
+      derivative(0),
+      error(0),
+      feed_forward(0),
       integral(0),
       last_angle_rad(0),
       last_error(0),
@@ -93,3 +96,8 @@ void RegulatedMotor::setParams(double kP, double kI, double kD, double ff_scale,
   this->ff_scale = ff_scale;
   this->ff_offset = ff_offset;
 }
+
+PidTerms RegulatedMotor::terms() const {
+  return {regulated_setpoint_rps, velocity_rps, error * kP, integral * kI, smooth_derivative * kD, feed_forward,
+          abstract_force};
+}
@@ -2,6 +2,17 @@
 
 #include <common/KinematicController/RobotConfig.h>
 
+/// \brief what went into the last abstract force, for telemetry
+struct PidTerms {
+  double setpoint_rps;
+  double velocity_rps;
+  double p;
+  double i;
+  double d;
+  double feed_forward;
+  double abstract_force;
+};
+
 class RegulatedMotor {
 public:
   RegulatedMotor();
@@ -18,6 +29,8 @@ public:
 
   void setParams(double kP, double kI, double kD, double ff_scale, double ff_offset);
 
+  PidTerms terms() const;
+
   double kP;
   double kI;
   double kD;
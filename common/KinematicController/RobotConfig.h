@@ -29,6 +29,11 @@ constexpr double ANALOG_MIN_DIST_M = 0.01;
 constexpr double WHEEL_RAD = 0.0145;
 constexpr double MIN_ABSTRACT_FORCE = 3.5;
 constexpr double END_SPEED_MPS = 0.3; // this can be lowered to 0.15 to demonstrate ForwardN
+constexpr double MAX_ACCEL_CUPSS = 10;
+constexpr double MAX_JERK_CUPSSS = 200;
+// speed runs slow down for diagonals, where there's only a few cm of clearance either side
+constexpr double DIAGONAL_SPEED_SCALE = 0.7;
+constexpr double TURN_RADIUS_CU = 0.5;
 
 extern double MAX_SPEED_MPS;
 extern bool ARC_TURN;
@@ -36,6 +41,7 @@ extern double MAX_SPEED_CUPS;
 
 constexpr double TRACK_WIDTH_CU = smartmouse::maze::toCellUnits(TRACK_WIDTH_M);
 constexpr double MAX_HARDWARE_SPEED_CUPS = smartmouse::maze::toCellUnits(MAX_HARDWARE_SPEED_MPS);
+constexpr double TURN_SPEED_CUPS = smartmouse::maze::toCellUnits(END_SPEED_MPS);
 constexpr double MIN_SPEED_CUPS = smartmouse::maze::toCellUnits(MIN_SPEED_MPS);
 constexpr double ANALOG_MAX_DIST_CU = smartmouse::maze::toCellUnits(ANALOG_MAX_DIST_M);
 constexpr double ANALOG_MIN_DIST_CU = smartmouse::maze::toCellUnits(ANALOG_MIN_DIST_M);
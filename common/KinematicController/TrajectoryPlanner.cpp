@@ -1,69 +1,126 @@
+#include <algorithm>
+#include <common/KinematicController/RobotConfig.h>
 #include <common/KinematicController/TrajectoryPlanner.h>
 
-TrajectoryPlanner::TrajectoryPlanner(Waypoints waypoints) : waypoints(waypoints) {
-  for (Waypoint pt : waypoints) {
-    A << x_constraint(pt.time),
-        y_constraint(pt.time),
-        non_holonomic_constraint(pt.state.pose.yaw, pt.time),
-        trig_constraint(pt.state.pose.yaw, pt.time),
-        x_dot_constraint(pt.time),
-        y_dot_constraint(pt.time);
-    b << pt.state.pose.col,
-        pt.state.pose.row,
-        0,
-        pt.state.velocity * sin(2 * pt.state.pose.yaw);
+constexpr unsigned int TrajectoryPlanner::MAX_WAYPOINTS;
+constexpr unsigned int TrajectoryPlanner::COEFFICIENTS;
+constexpr unsigned int Trajectory::MAX_SEGMENTS;
+
+TrajectorySample Trajectory::sample(double t) const {
+  if (segment_count == 0) {
+    return {GlobalPose(0, 0, 0), 0, 0};
   }
 
-}
+  unsigned int i = 0;
+  while (i + 1 < segment_count && segments[i + 1].start_time <= t) {
+    i++;
+  }
+  const Segment &segment = segments[i];
+  double tau = std::max(0.0, std::min(1.0, (t - segment.start_time) / segment.duration));
 
-const Eigen::Matrix<double, 10, 1> TrajectoryPlanner::plan() {
-  return A.jacobiSvd(Eigen::ComputeFullU | Eigen::ComputeFullV).solve(b);
+  const Coefficients &c = segment.coefficients;
+  double d = segment.duration;
+  Eigen::Matrix<double, 1, 2> p = TrajectoryPlanner::derivativeRow(0, tau).transpose() * c;
+  // the chain rule, since these are derivatives with respect to tau
+  Eigen::Matrix<double, 1, 2> v = TrajectoryPlanner::derivativeRow(1, tau).transpose() * c / d;
+  Eigen::Matrix<double, 1, 2> a = TrajectoryPlanner::derivativeRow(2, tau).transpose() * c / (d * d);
+
+  TrajectorySample sample;
+  sample.velocity = sqrt(v(0) * v(0) + v(1) * v(1));
+  sample.pose = GlobalPose(p(0), p(1), atan2(v(1), v(0)));
+  if (sample.velocity > 1e-9) {
+    sample.yaw_rate = (v(0) * a(1) - v(1) * a(0)) / (sample.velocity * sample.velocity);
+  } else {
+    sample.yaw_rate = 0;
+  }
+  return sample;
 }
 
-Eigen::Matrix<double, 1, 10> TrajectoryPlanner::x_constraint(double t) {
-  Eigen::Matrix<double, 1, 10> vec;
-  vec << 1, t, std::pow(t, 2), std::pow(t, 3), std::pow(t, 4), std::pow(t, 5), 0, 0, 0, 0, 0, 0;
-  return vec;
+std::pair<double, double> Trajectory::wheelVelocities(double t) const {
+  // the inverse of KinematicController::forwardKinematics
+  TrajectorySample target = sample(t);
+  double turn = target.yaw_rate * smartmouse::kc::TRACK_WIDTH_CU / 2;
+  return {target.velocity - turn, target.velocity + turn};
 }
 
-Eigen::Matrix<double, 1, 10> TrajectoryPlanner::y_constraint(double t) {
-  Eigen::Matrix<double, 1, 10> vec;
-  vec << 0, 0, 0, 0, 0, 0, 1, t, std::pow(t, 2), std::pow(t, 3), std::pow(t, 4), std::pow(t, 5);
-  return vec;
+TrajectoryPlanner::TrajectoryPlanner() : waypoint_count(0) {}
+
+void TrajectoryPlanner::clear() {
+  waypoint_count = 0;
 }
 
-Eigen::Matrix<double, 1, 10> TrajectoryPlanner::non_holonomic_constraint(double theta_t, double t) {
-  double s_t = sin(theta_t);
-  double c_t = cos(theta_t);
-  double t_2 = std::pow(t, 2);
-  double t_3 = std::pow(t, 3);
-  double t_4 = std::pow(t, 4);
-  Eigen::Matrix<double, 1, 10> vec;
-  vec << 0, s_t, 2 * s_t * t, 3 * s_t * t_2, 4 * s_t * t_3, 5 * s_t * t_4, 0, c_t, 2 * c_t * t, 3 * c_t * t_2, 4 * c_t
-      * t_3, 5 * c_t * t_4;
-  return vec;
+bool TrajectoryPlanner::addWaypoint(const Waypoint &waypoint) {
+  if (waypoint_count == MAX_WAYPOINTS) {
+    return false;
+  }
+  if (waypoint_count > 0 && waypoint.time <= waypoints[waypoint_count - 1].time) {
+    return false;
+  }
+  waypoints[waypoint_count++] = waypoint;
+  return true;
 }
 
-Eigen::Matrix<double, 1, 10> TrajectoryPlanner::trig_constraint(double theta_t, double t) {
-  double s_t = sin(theta_t);
-  double c_t = cos(theta_t);
-  double t_2 = std::pow(t, 2);
-  double t_3 = std::pow(t, 3);
-  double t_4 = std::pow(t, 4);
-  Eigen::Matrix<double, 1, 10> vec;
-  vec << 0, s_t, 2 * s_t * t, 3 * s_t * t_2, 4 * s_t * t_3, 5 * s_t * t_4, 0, -c_t, -2 * c_t * t, -3 * c_t * t_2, -4
-      * c_t * t_3, -5 * c_t * t_4;
-  return vec;
+TrajectoryPlanner::ConstraintRow TrajectoryPlanner::derivativeRow(unsigned int n, double tau) {
+  ConstraintRow row = ConstraintRow::Zero();
+  for (unsigned int i = n; i < COEFFICIENTS; i++) {
+    // i! / (i - n)!
+    double scale = 1;
+    for (unsigned int k = 0; k < n; k++) {
+      scale *= i - k;
+    }
+    row(i) = scale * std::pow(tau, i - n);
+  }
+  return row;
 }
 
-Eigen::Matrix<double, 1, 10> TrajectoryPlanner::x_dot_constraint(double t) {
-  Eigen::Matrix<double, 1, 10> vec;
-  vec << 0, 1, 2 * t, 3 * std::pow(t, 2), 4 * std::pow(t, 3), 5 * std::pow(t, 4), 0, 0, 0, 0, 0, 0;
-  return vec;
+TrajectoryPlanner::ConstraintMatrix TrajectoryPlanner::segmentConstraints() {
+  ConstraintMatrix A;
+  for (unsigned int n = 0; n < 3; n++) {
+    A.row(n) = derivativeRow(n, 0).transpose();
+    A.row(n + 3) = derivativeRow(n, 1).transpose();
+  }
+  return A;
 }
 
-Eigen::Matrix<double, 1, 10> TrajectoryPlanner::y_dot_constraint(double t) {
-  Eigen::Matrix<double, 1, 10> vec;
-  vec << 0, 0, 0, 0, 0, 0, 0, 1, 2 * t, 3 * std::pow(t, 2), 4 * std::pow(t, 3), 5 * std::pow(t, 4);
-  return vec;
+bool TrajectoryPlanner::plan(Trajectory *trajectory) const {
+  if (waypoint_count < 2) {
+    return false;
+  }
+
+  // velocities and accelerations at each waypoint, per second, with col in column 0 and row in column 1
+  Eigen::Matrix<double, MAX_WAYPOINTS, 2> v, a;
+  for (unsigned int i = 0; i < waypoint_count; i++) {
+    const GlobalState &state = waypoints[i].state;
+    v.row(i) << state.velocity * cos(state.pose.yaw), state.velocity * sin(state.pose.yaw);
+  }
+  a.row(0).setZero();
+  a.row(waypoint_count - 1).setZero();
+  for (unsigned int i = 1; i + 1 < waypoint_count; i++) {
+    a.row(i) = (v.row(i + 1) - v.row(i - 1)) / (waypoints[i + 1].time - waypoints[i - 1].time);
+  }
+
+  Eigen::HouseholderQR<ConstraintMatrix> qr(segmentConstraints());
+  for (unsigned int i = 0; i + 1 < waypoint_count; i++) {
+    const Waypoint &from = waypoints[i];
+    const Waypoint &to = waypoints[i + 1];
+    double duration = to.time - from.time;
+
+    // derivatives are per second, so scale them to per unit of tau
+    Eigen::Matrix<double, COEFFICIENTS, 2> targets;
+    targets.row(0) << from.state.pose.col, from.state.pose.row;
+    targets.row(1) = v.row(i) * duration;
+    targets.row(2) = a.row(i) * duration * duration;
+    targets.row(3) << to.state.pose.col, to.state.pose.row;
+    targets.row(4) = v.row(i + 1) * duration;
+    targets.row(5) = a.row(i + 1) * duration * duration;
+
+    Trajectory::Segment &segment = trajectory->segments[i];
+    segment.start_time = from.time;
+    segment.duration = duration;
+    segment.coefficients = qr.solve(targets);
+  }
+  trajectory->segment_count = waypoint_count - 1;
+  trajectory->start_time = waypoints[0].time;
+  trajectory->duration = waypoints[waypoint_count - 1].time - waypoints[0].time;
+  return true;
 }
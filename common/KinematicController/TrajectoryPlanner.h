@@ -1,6 +1,7 @@
 #pragma  once
 
 #include <cmath>
+#include <utility>
 
 #include <common/Eigen/Eigen.h>
 #include <common/Eigen/Eigen/Dense>
@@ -11,33 +12,79 @@ struct Waypoint {
   GlobalState state;
 };
 
-typedef std::vector<Waypoint> Waypoints;
-
-class TrajectoryPlanner {
+struct TrajectorySample {
+  GlobalPose pose;
+  double velocity;
+  double yaw_rate;
+};
 
- public:
-  static Eigen::Matrix<double, 1, 10> x_constraint(double t);
+/**
+ * \brief a piecewise quintic trajectory, with one quintic in col and another in row for each segment between two
+ * waypoints. Each is a function of the segment's normalized time tau = (t - start_time) / duration. That keeps every
+ * power of tau between 0 and 1, which the solve needs to stay well conditioned over short moves.
+ */
+struct Trajectory {
+  // stored unaligned, so a Trajectory can be a member of anything without Eigen's aligned new
+  typedef Eigen::Matrix<double, 6, 2, Eigen::DontAlign> Coefficients;
+
+  static constexpr unsigned int MAX_SEGMENTS = 3;
+
+  struct Segment {
+    double start_time;
+    double duration;
+    /// column 0 is col, column 1 is row, and row i is the coefficient of tau^i
+    Coefficients coefficients;
+  };
+
+  /** \brief where the robot should be t seconds since the start of the plan's time. Clamped to the ends */
+  TrajectorySample sample(double t) const;
+
+  /** \brief the wheel speeds in cells per second that follow the trajectory at time t
+   * \return left, right
+   */
+  std::pair<double, double> wheelVelocities(double t) const;
+
+  double start_time;
+  double duration;
+  unsigned int segment_count;
+  Segment segments[MAX_SEGMENTS];
+};
 
-  static Eigen::Matrix<double, 1, 10> y_constraint(double t);
+/**
+ * \brief plans a trajectory through up to MAX_WAYPOINTS waypoints, with one quintic per segment between them.
+ * Each segment starts and ends at the position and velocity (speed along its yaw) of its waypoints, so the trajectory
+ * passes through every waypoint and its velocity is continuous. The first and last waypoints have no acceleration, and
+ * at the ones in between both segments share the acceleration that takes the velocity from the waypoint before to
+ * the one after, so the acceleration is continuous too. That's exactly six constraints per segment and axis.
+ *
+ * In normalized time every segment has the same constraint matrix, so it's factored with one 6x6 QR that every
+ * segment and both axes share. Everything is fixed size, so planning never allocates and can run on the robot.
+ */
+class TrajectoryPlanner {
+public:
+  static constexpr unsigned int MAX_WAYPOINTS = Trajectory::MAX_SEGMENTS + 1;
+  static constexpr unsigned int COEFFICIENTS = 6;
 
-  static Eigen::Matrix<double, 1, 10> non_holonomic_constraint(double theta_t, double t);
+  typedef Eigen::Matrix<double, COEFFICIENTS, 1> ConstraintRow;
+  typedef Eigen::Matrix<double, COEFFICIENTS, COEFFICIENTS> ConstraintMatrix;
 
-  static Eigen::Matrix<double, 1, 10> trig_constraint(double theta_t, double t);
+  TrajectoryPlanner();
 
-  static Eigen::Matrix<double, 1, 10> x_dot_constraint(double t);
+  void clear();
 
-  static Eigen::Matrix<double, 1, 10> y_dot_constraint(double t);
+  /** \return false if there's no room, or it isn't after the last waypoint */
+  bool addWaypoint(const Waypoint &waypoint);
 
-  TrajectoryPlanner(Waypoints waypoints);
+  /** \return false if there are fewer than two waypoints */
+  bool plan(Trajectory *trajectory) const;
 
-  const Eigen::Matrix<double, 10, 1> plan();
+  /** \brief d^n/dtau^n of [1 tau tau^2 tau^3 tau^4 tau^5] */
+  static ConstraintRow derivativeRow(unsigned int n, double tau);
 
- private:
-  Waypoints waypoints;
+  /** \brief position, velocity, and acceleration at tau = 0, and then the same at tau = 1 */
+  static ConstraintMatrix segmentConstraints();
 
-  // 6 constraints per row, x, y, xdot, ydot, trig, nonholonomic
-  // 10 variables (two qunitic polynomials)
-  Eigen::Matrix<double, Eigen::Dynamic, 10> A;
-  Eigen::Matrix<double, 10, 1> b;
+private:
+  Waypoint waypoints[MAX_WAYPOINTS];
+  unsigned int waypoint_count;
 };
-
@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <cmath>
+#include <common/KinematicController/VelocityProfile.h>
+
+constexpr unsigned int VelocityProfile::MAX_SEGMENTS;
+
+namespace {
+
+/// \brief plenty for doubles, and it's only ever done while planning
+constexpr unsigned int BISECTION_STEPS = 48;
+
+}
+
+VelocityProfile::VelocityProfile() : limits({0, 0, 0}), segment_count(0), cursor(0) {}
+
+double VelocityProfile::rampTime(double dv, ProfileLimits limits) {
+  dv = fabs(dv);
+  if (dv == 0) {
+    return 0;
+  }
+  if (limits.j_max <= 0) {
+    return dv / limits.a_max;
+  }
+  if (dv >= limits.a_max * limits.a_max / limits.j_max) {
+    // long enough to reach full acceleration
+    return dv / limits.a_max + limits.a_max / limits.j_max;
+  }
+  return 2 * sqrt(dv / limits.j_max);
+}
+
+double VelocityProfile::rampDistance(double v0, double v1, ProfileLimits limits) {
+  // the acceleration is symmetric about the middle of the ramp, so the average speed is too
+  return (v0 + v1) / 2 * rampTime(v1 - v0, limits);
+}
+
+double VelocityProfile::reachableSpeed(double v0, double distance, ProfileLimits limits) {
+  // this is exact for a trapezoid, and an upper bound for an S-curve
+  double hi = sqrt(v0 * v0 + 2 * limits.a_max * distance);
+  if (limits.j_max <= 0) {
+    return hi;
+  }
+  double lo = v0;
+  for (unsigned int i = 0; i < BISECTION_STEPS; i++) {
+    double mid = (lo + hi) / 2;
+    if (rampDistance(v0, mid, limits) > distance) {
+      hi = mid;
+    } else {
+      lo = mid;
+    }
+  }
+  return lo;
+}
+
+double VelocityProfile::brakedSpeed(double v0, double distance, ProfileLimits limits) {
+  if (reachableSpeed(0, distance, limits) >= v0) {
+    return 0;
+  }
+  if (limits.j_max <= 0) {
+    return sqrt(v0 * v0 - 2 * limits.a_max * distance);
+  }
+  double lo = 0, hi = v0;
+  for (unsigned int i = 0; i < BISECTION_STEPS; i++) {
+    double mid = (lo + hi) / 2;
+    if (rampDistance(mid, v0, limits) > distance) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return hi;
+}
+
+ProfileSample VelocityProfile::sampleRamp(double v0, double v1, double t, ProfileLimits limits) {
+  double dv = fabs(v1 - v0);
+  double sign = v1 > v0 ? 1 : -1;
+
+  // each phase is a duration, the acceleration it starts at, and its jerk
+  double phases[3][3];
+  unsigned int phase_count;
+  if (limits.j_max <= 0) {
+    phases[0][0] = dv / limits.a_max;
+    phases[0][1] = sign * limits.a_max;
+    phases[0][2] = 0;
+    phase_count = 1;
+  } else if (dv >= limits.a_max * limits.a_max / limits.j_max) {
+    double t_jerk = limits.a_max / limits.j_max;
+    double t_const = dv / limits.a_max - t_jerk;
+    double a = sign * limits.a_max;
+    double j = sign * limits.j_max;
+    double full[3][3] = {{t_jerk, 0, j}, {t_const, a, 0}, {t_jerk, a, -j}};
+    std::copy(&full[0][0], &full[0][0] + 9, &phases[0][0]);
+    phase_count = 3;
+  } else {
+    double t_jerk = sqrt(dv / limits.j_max);
+    double j = sign * limits.j_max;
+    double reduced[2][3] = {{t_jerk, 0, j}, {t_jerk, j * t_jerk, -j}};
+    std::copy(&reduced[0][0], &reduced[0][0] + 6, &phases[0][0]);
+    phase_count = 2;
+  }
+
+  ProfileSample sample = {0, v0, 0};
+  for (unsigned int i = 0; i < phase_count && t > 0; i++) {
+    double d = std::min(t, phases[i][0]);
+    double a0 = phases[i][1];
+    double j = phases[i][2];
+    sample.s += sample.v * d + a0 * d * d / 2 + j * d * d * d / 6;
+    sample.v += a0 * d + j * d * d / 2;
+    sample.a = a0 + j * d;
+    t -= d;
+  }
+  if (t > 0) {
+    sample.a = 0;
+  }
+  return sample;
+}
+
+void VelocityProfile::finishSegment(Segment *segment, double start_s, double start_t) const {
+  segment->start_s = start_s;
+  segment->start_t = start_t;
+
+  double v0 = segment->v_entry;
+  double v1 = segment->v_exit;
+  double lo = std::max(v0, v1);
+  double hi = limits.v_max;
+  auto distance_at_peak = [&](double v_peak) {
+    return rampDistance(v0, v_peak, limits) + rampDistance(v_peak, v1, limits);
+  };
+
+  double v_peak;
+  if (lo >= hi) {
+    v_peak = lo;
+  } else if (distance_at_peak(hi) <= segment->length) {
+    v_peak = hi;
+  } else if (limits.j_max <= 0) {
+    v_peak = sqrt((2 * limits.a_max * segment->length + v0 * v0 + v1 * v1) / 2);
+    v_peak = std::max(lo, std::min(hi, v_peak));
+  } else {
+    for (unsigned int i = 0; i < BISECTION_STEPS; i++) {
+      double mid = (lo + hi) / 2;
+      if (distance_at_peak(mid) > segment->length) {
+        hi = mid;
+      } else {
+        lo = mid;
+      }
+    }
+    v_peak = lo;
+  }
+
+  segment->v_peak = v_peak;
+  segment->accel_t = rampTime(v_peak - v0, limits);
+  segment->decel_t = rampTime(v_peak - v1, limits);
+  double cruise_d = std::max(0.0, segment->length - distance_at_peak(v_peak));
+  segment->cruise_t = v_peak > 0 ? cruise_d / v_peak : 0;
+}
+
+void VelocityProfile::planStraight(double length, double v_entry, double v_exit, ProfileLimits limits) {
+  this->limits = limits;
+  length = std::max(length, 0.0);
+  v_exit = std::max(v_exit, brakedSpeed(v_entry, length, limits));
+  v_exit = std::min(v_exit, reachableSpeed(v_entry, length, limits));
+
+  segments[0].length = length;
+  segments[0].v_entry = v_entry;
+  segments[0].v_exit = v_exit;
+  finishSegment(&segments[0], 0, 0);
+  segment_count = 1;
+  cursor = 0;
+}
+
+bool VelocityProfile::plan(const route_t &route, double v_start, double v_end, double turn_speed,
+                           ProfileLimits limits) {
+  this->limits = limits;
+  segment_count = 0;
+  cursor = 0;
+  if (route.size() > MAX_SEGMENTS) {
+    return false;
+  }
+  if (route.empty()) {
+    return true;
+  }
+
+  // v[i] is the speed going into straight i, and v[n] is the speed at the end
+  unsigned int n = (unsigned int) route.size();
+  double v[MAX_SEGMENTS + 1];
+  v[0] = v_start;
+  v[n] = std::min(v_end, limits.v_max);
+  for (unsigned int i = 1; i < n; i++) {
+    v[i] = route[i].d == route[i - 1].d ? limits.v_max : std::min(turn_speed, limits.v_max);
+  }
+
+  // backward pass: every corner has to be slow enough to make the next one
+  for (unsigned int i = n - 1; i > 0; i--) {
+    v[i] = std::min(v[i], reachableSpeed(v[i + 1], route[i].n, limits));
+  }
+
+  // forward pass: and no faster than can be reached from the last one
+  for (unsigned int i = 0; i < n; i++) {
+    v[i + 1] = std::min(v[i + 1], reachableSpeed(v[i], route[i].n, limits));
+    v[i + 1] = std::max(v[i + 1], brakedSpeed(v[i], route[i].n, limits));
+  }
+
+  double s = 0, t = 0;
+  for (unsigned int i = 0; i < n; i++) {
+    Segment &segment = segments[i];
+    segment.length = route[i].n;
+    segment.v_entry = v[i];
+    segment.v_exit = v[i + 1];
+    finishSegment(&segment, s, t);
+    s += segment.length;
+    t += segment.accel_t + segment.cruise_t + segment.decel_t;
+  }
+  segment_count = n;
+  return true;
+}
+
+ProfileSample VelocityProfile::sampleSegment(const Segment &segment, double t) const {
+  if (t < segment.accel_t) {
+    ProfileSample ramp = sampleRamp(segment.v_entry, segment.v_peak, t, limits);
+    ramp.s += segment.start_s;
+    return ramp;
+  }
+  t -= segment.accel_t;
+  double accel_d = rampDistance(segment.v_entry, segment.v_peak, limits);
+
+  if (t < segment.cruise_t) {
+    return {segment.start_s + accel_d + segment.v_peak * t, segment.v_peak, 0};
+  }
+  t -= segment.cruise_t;
+
+  ProfileSample ramp = sampleRamp(segment.v_peak, segment.v_exit, std::min(t, segment.decel_t), limits);
+  ramp.s += segment.start_s + accel_d + segment.v_peak * segment.cruise_t;
+  if (t >= segment.decel_t) {
+    ramp.a = 0;
+  }
+  return ramp;
+}
+
+ProfileSample VelocityProfile::sample(double t) const {
+  if (segment_count == 0) {
+    return {0, 0, 0};
+  }
+  t = std::max(t, 0.0);
+
+  if (cursor >= segment_count || segments[cursor].start_t > t) {
+    cursor = 0;
+  }
+  while (cursor + 1 < segment_count && segments[cursor + 1].start_t <= t) {
+    cursor++;
+  }
+  const Segment &segment = segments[cursor];
+  return sampleSegment(segment, t - segment.start_t);
+}
+
+double VelocityProfile::speedAt(double s) const {
+  return sample(timeAt(s)).v;
+}
+
+double VelocityProfile::timeAt(double s) const {
+  if (segment_count == 0) {
+    return 0;
+  }
+
+  unsigned int i = 0;
+  while (i + 1 < segment_count && segments[i + 1].start_s <= s) {
+    i++;
+  }
+  const Segment &segment = segments[i];
+  double segment_t = segment.accel_t + segment.cruise_t + segment.decel_t;
+  if (s >= segment.start_s + segment.length) {
+    return segment.start_t + segment_t;
+  }
+
+  // distance only ever increases with time, so find the time it gets to s
+  double lo = 0, hi = segment_t;
+  for (unsigned int step = 0; step < BISECTION_STEPS; step++) {
+    double mid = (lo + hi) / 2;
+    if (sampleSegment(segment, mid).s < s) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return segment.start_t + hi;
+}
+
+double VelocityProfile::duration() const {
+  if (segment_count == 0) {
+    return 0;
+  }
+  const Segment &last = segments[segment_count - 1];
+  return last.start_t + last.accel_t + last.cruise_t + last.decel_t;
+}
+
+double VelocityProfile::length() const {
+  if (segment_count == 0) {
+    return 0;
+  }
+  const Segment &last = segments[segment_count - 1];
+  return last.start_s + last.length;
+}
+
+unsigned int VelocityProfile::segmentCount() const {
+  return segment_count;
+}
+
+double VelocityProfile::entrySpeed(unsigned int segment) const {
+  return segments[segment].v_entry;
+}
+
+double VelocityProfile::peakSpeed(unsigned int segment) const {
+  return segments[segment].v_peak;
+}
+
+double VelocityProfile::exitSpeed(unsigned int segment) const {
+  return segments[segment].v_exit;
+}
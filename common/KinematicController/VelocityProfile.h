@@ -0,0 +1,108 @@
+#pragma once
+
+#include <common/core/AbstractMaze.h>
+
+/// \brief everything here is in cells and seconds
+struct ProfileLimits {
+  double v_max;
+  double a_max;
+  /// 0 means no jerk limit, which makes the speed changes trapezoids instead of S-curves
+  double j_max;
+};
+
+struct ProfileSample {
+  /// distance along the profile
+  double s;
+  double v;
+  double a;
+};
+
+/**
+ * \brief the fastest forward speed profile along a straight, or along a whole route, under speed, acceleration, and
+ * jerk limits.
+ *
+ * Everything is worked out when the profile is planned. A route is a list of straights, and the speed at each corner
+ * between them is capped at the turn speed. A backward pass lowers every corner speed to what the robot can still brake
+ * from before the next corner, a forward pass lowers it to what it can reach from the last corner, and then each
+ * straight speeds up to the highest speed it has room for and back down. Sampling only finds which phase of which
+ * straight a time falls in and evaluates a polynomial, so controllers can call it every cycle.
+ *
+ * Each speed change is a symmetric S-curve (jerk up, constant acceleration, jerk down), which collapses to a trapezoid
+ * when there's no jerk limit.
+ */
+class VelocityProfile {
+public:
+  static constexpr unsigned int MAX_SEGMENTS = 64;
+
+  VelocityProfile();
+
+  /**
+   * \brief one straight. If v_exit can't be reached by braking as hard as the limits allow, the profile ends at the
+   * lowest speed it can reach instead.
+   */
+  void planStraight(double length, double v_entry, double v_exit, ProfileLimits limits);
+
+  /**
+   * \brief a whole route, with one straight per motion primitive
+   * \return false if the route has more than MAX_SEGMENTS primitives, which leaves the profile empty
+   */
+  bool plan(const route_t &route, double v_start, double v_end, double turn_speed, ProfileLimits limits);
+
+  /** \brief where the profile is t seconds after it starts. Past the end it stays at the end */
+  ProfileSample sample(double t) const;
+
+  /** \brief the planned speed after s cells */
+  double speedAt(double s) const;
+
+  /** \brief when the profile gets s cells along. Past the end it's the duration */
+  double timeAt(double s) const;
+
+  double duration() const;
+
+  double length() const;
+
+  unsigned int segmentCount() const;
+
+  double entrySpeed(unsigned int segment) const;
+
+  double peakSpeed(unsigned int segment) const;
+
+  double exitSpeed(unsigned int segment) const;
+
+  /** \brief time to change speed by dv */
+  static double rampTime(double dv, ProfileLimits limits);
+
+  /** \brief distance covered changing speed from v0 to v1 */
+  static double rampDistance(double v0, double v1, ProfileLimits limits);
+
+  /** \brief the fastest speed that can be reached from v0 (or braked from down to v0) within distance */
+  static double reachableSpeed(double v0, double distance, ProfileLimits limits);
+
+private:
+  struct Segment {
+    double start_s;
+    double start_t;
+    double length;
+    double v_entry;
+    double v_peak;
+    double v_exit;
+    double accel_t;
+    double cruise_t;
+    double decel_t;
+  };
+
+  /** \brief the slowest speed that can be braked down to from v0 within distance */
+  static double brakedSpeed(double v0, double distance, ProfileLimits limits);
+
+  static ProfileSample sampleRamp(double v0, double v1, double t, ProfileLimits limits);
+
+  void finishSegment(Segment *segment, double start_s, double start_t) const;
+
+  ProfileSample sampleSegment(const Segment &segment, double t) const;
+
+  ProfileLimits limits;
+  Segment segments[MAX_SEGMENTS];
+  unsigned int segment_count;
+  // sample is almost always called with increasing times, so start looking where the last one was
+  mutable unsigned int cursor;
+};
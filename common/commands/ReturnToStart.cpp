@@ -3,27 +3,26 @@
 #include <commands/Forward.h>
 #include <commands/Turn.h>
 
-ReturnToStart::ReturnToStart(Mouse *mouse) : CommandGroup("return"), mouse(mouse) {
+ReturnToStart::ReturnToStart(RobotContext *context) : CommandGroup("return"), context(context), mouse(context->mouse) {
 }
 
 void ReturnToStart::initialize() {
-  //plan path from center to origin
-  mouse->maze->flood_fill_from_point(&pathToStart, smartmouse::maze::SIZE / 2, smartmouse::maze::SIZE / 2, 0, 0);
-  index = 0;
+  // the distances to the start are cached on the mouse, so there's nothing to plan unless walls changed
+  mouse->distances.to_start();
 }
 
 bool ReturnToStart::isFinished() {
   bool groupFinished = CommandGroup::isFinished();
 
   if (groupFinished) {
-    bool returned = mouse->getRow() == 0 && mouse->getCol() == 0;
+    // there's no step to take once we're at the start, or if there's no way back to it
+    Direction d = mouse->distances.to_start().next_step(mouse->getRow(), mouse->getCol());
 
-    if (!returned) {
-      motion_primitive_t prim = pathToStart[index++];
-      addSequential(new Turn(prim.d));
-      addSequential(new Forward());
+    if (d != Direction::INVALID) {
+      addSequential(new Turn(context, d));
+      addSequential(new Forward(context));
 #ifdef CONSOLE
-      addSequential(new WaitForStart());
+      addSequential(new WaitForStart(context));
       mouse->print_maze_mouse();
 #endif
     } else {
@@ -1,20 +1,20 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Solver.h>
 #include <common/core/Mouse.h>
 
 class ReturnToStart : public CommandGroup {
 public:
-  ReturnToStart(Mouse *mouse);
+  ReturnToStart(RobotContext *context);
 
   void initialize();
 
   bool isFinished();
 
 private:
-  route_t pathToStart;
-  int index;
+  RobotContext *context;
   Mouse *mouse;
 
 };
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <common/commanduino/TimerInterface.h>
+
+#if defined(CONSOLE)
+#include <console/ConsoleMouse.h>
+typedef ConsoleMouse PlatformMouse;
+#elif defined(EMBED)
+#include <real/RealMouse.h>
+typedef RealMouse PlatformMouse;
+#else
+#include <sim/lib/SimMouse.h>
+typedef SimMouse PlatformMouse;
+#endif
+
+/**
+ * \brief everything the commands driving one robot share.
+ * Commands are handed this when they're constructed, and pass it on to the commands they create, instead of
+ * looking up a global mouse. Each robot gets its own context, so several can run in one process.
+ * Pass the timer to the Scheduler running the commands.
+ */
+struct RobotContext {
+  PlatformMouse *mouse;
+  TimerInterface *timer;
+};
@@ -9,18 +9,19 @@
 #include <commands/Finish.h>
 #include <commands/SolveMaze.h>
 
-SolveCommand::SolveCommand(Solver *solver) : CommandGroup("SolveGroup"), solver(solver) {}
+SolveCommand::SolveCommand(RobotContext *context, Solver *solver)
+    : CommandGroup("SolveGroup"), context(context), solver(solver) {}
 
 
 void SolveCommand::initialize() {
   runs = 0;
   if (!GlobalProgramSettings.quiet) {
-    addSequential(new WaitForStart());
+    addSequential(new WaitForStart(context));
   }
   solver->setup();
-  addSequential(new SolveMaze(solver, Solver::Goal::CENTER));
-  addSequential(new Finish(solver->mouse->maze));
-  addSequential(new SolveMaze(solver, Solver::Goal::START));
+  addSequential(new SolveMaze(context, solver, Solver::Goal::CENTER));
+  addSequential(new Finish(context, solver->mouse->maze));
+  addSequential(new SolveMaze(context, solver, Solver::Goal::START));
 }
 
 bool SolveCommand::isFinished() {
@@ -35,12 +36,12 @@ bool SolveCommand::isFinished() {
     }
 
     if (!GlobalProgramSettings.quiet) {
-      addSequential(new Stop(200));
-      addSequential(new WaitForStart());
+      addSequential(new Stop(context, 200));
+      addSequential(new WaitForStart(context));
     }
-    addSequential(new SolveMaze(solver, Solver::Goal::CENTER));
-    addSequential(new Finish(solver->mouse->maze));
-    addSequential(new SolveMaze(solver, Solver::Goal::START));
+    addSequential(new SolveMaze(context, solver, Solver::Goal::CENTER));
+    addSequential(new Finish(context, solver->mouse->maze));
+    addSequential(new SolveMaze(context, solver, Solver::Goal::START));
     return false;
   }
 
@@ -1,16 +1,18 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Solver.h>
 
 class SolveCommand : public CommandGroup {
 public:
-  SolveCommand(Solver *solver);
+  SolveCommand(RobotContext *context, Solver *solver);
 
   void initialize();
   bool isFinished();
 
 private:
+  RobotContext *context;
   Solver *solver;
   static constexpr int MAX_RUNS = 4;
   int runs;
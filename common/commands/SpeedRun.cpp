@@ -1,13 +1,30 @@
 #include <common/commands/SpeedRun.h>
+#include <common/KinematicController/RobotConfig.h>
 #include <commands/WaitForStart.h>
 #include <commands/Turn.h>
 #include <commands/Forward.h>
 
-SpeedRun::SpeedRun(Mouse *mouse) : CommandGroup("speed"), mouse(mouse) {}
+SpeedRun::SpeedRun(RobotContext *context) : CommandGroup("speed"), context(context), mouse(context->mouse),
+                                            planner(context->mouse->maze, {}) {}
 
 void SpeedRun::initialize() {
   index = 0;
-  path = &mouse->maze->fastest_route;
+  distance = 0;
+  // plan for time rather than cells through what was explored, and fall back on the route the solver found.
+  // MAX_SPEED_CUPS can be changed before the run, so the limits are only read now
+  planner.set_limits({smartmouse::kc::MAX_SPEED_CUPS,
+                      smartmouse::kc::MAX_SPEED_CUPS * smartmouse::kc::DIAGONAL_SPEED_SCALE,
+                      smartmouse::kc::MAX_ACCEL_CUPSS, smartmouse::kc::TURN_SPEED_CUPS, smartmouse::kc::TURN_RADIUS_CU});
+  if (!planner.plan(&path, mouse->getRow(), mouse->getCol(), mouse->getDir(), smartmouse::maze::CENTER,
+                    smartmouse::maze::CENTER)) {
+    path = mouse->maze->fastest_route;
+  }
+
+  // plan the speeds for the whole route up front, so the straights don't slow down at every cell edge. Each corner is
+  // taken at the turn speed the planner costed it at, and every Forward follows this one profile
+  ProfileLimits limits = {smartmouse::kc::MAX_SPEED_CUPS, smartmouse::kc::MAX_ACCEL_CUPSS,
+                          smartmouse::kc::MAX_JERK_CUPSSS};
+  planned = profile.plan(path, 0, smartmouse::kc::TURN_SPEED_CUPS, smartmouse::kc::TURN_SPEED_CUPS, limits);
 }
 
 bool SpeedRun::isFinished() {
@@ -18,11 +35,18 @@ bool SpeedRun::isFinished() {
                     && mouse->getCol() == smartmouse::maze::SIZE / 2;
 
     if (!returned) {
-      motion_primitive_t prim = path->at(index++);
-      addSequential(new Turn(prim.d));
-      addSequential(new Forward());
+      motion_primitive_t prim = path.at(index++);
+      addSequential(new Turn(context, prim.d));
+      for (unsigned int i = 0; i < prim.n; i++) {
+        if (planned) {
+          addSequential(new Forward(context, &profile, distance));
+        } else {
+          addSequential(new Forward(context));
+        }
+        distance += 1;
+      }
 #ifdef CONSOLE
-      addSequential(new WaitForStart());
+      addSequential(new WaitForStart(context));
       mouse->print_maze_mouse();
 #endif
     } else {
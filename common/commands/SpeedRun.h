@@ -1,19 +1,29 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Solver.h>
 #include <common/core/Mouse.h>
+#include <common/core/RunPlanner.h>
+#include <common/KinematicController/VelocityProfile.h>
 
 class SpeedRun : public CommandGroup {
 public:
-  SpeedRun(Mouse *mouse);
+  SpeedRun(RobotContext *context);
 
   void initialize();
 
   bool isFinished();
 
 private:
+  RobotContext *context;
   Mouse *mouse;
-  route_t *path;
+  RunPlanner planner;
+  /// \brief the quickest route we know of, which isn't always the one with the fewest cells
+  route_t path;
   int index;
+  VelocityProfile profile;
+  bool planned;
+  // cells of the route driven so far
+  double distance;
 };
@@ -1,4 +1,6 @@
 #include "Command.h"
 #include "CommandGroup.h"
+#include "CommandPool.h"
+#include "CommandQueue.h"
 #include "Scheduler.h"
 #include "TimerInterface.h"
@@ -1,19 +1,45 @@
 #include "Command.h"
 
-TimerInterface *Command::timer;
+#ifdef EMBED
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+namespace {
+TimerInterface *default_timer = nullptr;
+
+unsigned long default_cycle_clock_us() {
+#ifdef EMBED
+  return micros();
+#else
+  return (unsigned long) std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+unsigned long (*cycle_clock_us)() = default_cycle_clock_us;
+}
 
 void Command::setTimerImplementation(TimerInterface *timer) {
-  Command::timer = timer;
+  default_timer = timer;
+}
+
+void Command::setCycleClock(unsigned long (*clock_us)()) {
+  cycle_clock_us = clock_us ? clock_us : default_cycle_clock_us;
 }
 
-Command::Command() : name("unnamed"), initialized(false), running(false), timeout(0), startTime(0) {}
+Command::Command() : Command("unnamed") {}
 
-Command::Command(const char *name) : name(name),
-                                     initialized(false), running(false), timeout(0), startTime(0) {}
+Command::Command(const char *name) : name(name), timer(default_timer), report(nullptr),
+                                     initialized(false), running(false), timeout(0), startTime(0), budget_us(0),
+                                     cycles(0), overruns(0), last_cycle_us(0), max_cycle_us(0),
+                                     next_in_queue(nullptr) {}
 
 Command::~Command() {}
 
 bool Command::cycle() {
+  unsigned long t0 = cycle_clock_us();
   bool finished = false;
 
   if (!initialized) {
@@ -29,10 +55,30 @@ bool Command::cycle() {
     _execute();
   }
 
+  last_cycle_us = cycle_clock_us() - t0;
+  cycles++;
+  if (last_cycle_us > max_cycle_us) {
+    max_cycle_us = last_cycle_us;
+  }
+  if (budget_us > 0 && last_cycle_us > budget_us) {
+    overruns++;
+    if (report) {
+      report->command_overruns++;
+      unsigned long over_us = last_cycle_us - budget_us;
+      if (over_us > report->worst_overrun_us) {
+        report->worst_overrun_us = over_us;
+        report->worst_overrun_name = name;
+      }
+    }
+  }
 
   return finished;
 }
 
+void Command::setBudgetUs(unsigned long budget_us) {
+  this->budget_us = budget_us;
+}
+
 void Command::setTimeout(unsigned long timeout) {
   this->timeout = timeout;
 }
@@ -71,5 +117,5 @@ bool Command::operator!=(const Command &other) {
 }
 
 TimerInterface *Command::getTimerImplementation() {
-  return timer;
+  return default_timer;
 }
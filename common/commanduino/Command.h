@@ -1,6 +1,25 @@
 #pragma once
 
 #include "TimerInterface.h"
+#include "CommandQueue.h"
+
+/**
+ * \brief how long the commands run by one Scheduler have been taking.
+ * The scheduler hands this to every command it runs, the same way it hands out its timer, so commands nested
+ * in groups report here too.
+ */
+struct BudgetReport {
+  /// calls to Scheduler::run
+  unsigned long ticks;
+  /// calls to Scheduler::run that took longer than its budget
+  unsigned long tick_overruns;
+  unsigned long worst_tick_us;
+  /// cycles of any command that took longer than that command's budget
+  unsigned long command_overruns;
+  /// the command whose cycle went furthest over its budget
+  const char *worst_overrun_name;
+  unsigned long worst_overrun_us;
+};
 
 /**
  * \brief this class is the very core of the framework
@@ -11,9 +30,20 @@ class Command {
 
 public:
 
+  /** \brief set the timer new commands start with.
+   * This is only a default for programs that run one robot. A Scheduler constructed with its own timer hands that
+   * timer to every command it runs, and command groups hand theirs to their children, so several command trees can
+   * run side by side with different clocks.
+   */
   static void setTimerImplementation(TimerInterface *timer);
   static TimerInterface *getTimerImplementation();
 
+  /** \brief set the clock cycles are measured with, in microseconds.
+   * This is wall clock time, not the robot's timer: in the sim a cycle takes no sim time at all.
+   * Defaults to micros() on the robot and the steady clock everywhere else, and null goes back to the default.
+   */
+  static void setCycleClock(unsigned long (*clock_us)());
+
   Command();
 
   Command(const char *name);
@@ -54,10 +84,17 @@ public:
   virtual void _end();
 
   /** \brief actually does the  excuting.
+   * Each cycle is timed, and counted as an overrun if it takes longer than the budget.
    * @return if command is finished
    */
   bool cycle();
 
+  /** \brief declare how long one cycle of this command should take, including any commands it runs.
+   * Work that can take longer, like planning, should be split over several cycles instead.
+   * \param budget_us 0 means no budget, which is the default
+   */
+  void setBudgetUs(unsigned long budget_us);
+
   /** \brief check if the command is running.
    *  @return if command is still running
    */
@@ -72,9 +109,25 @@ public:
   /** \brief for convenient printing */
   const char *name;
 
-  static TimerInterface *timer;
+  /** \brief the clock this command measures its time and timeouts with */
+  TimerInterface *timer;
+
+  /** \brief where overruns are reported. Set by the Scheduler or command group running this command */
+  BudgetReport *report;
 
   bool initialized, running;
   unsigned long timeout;
   unsigned long startTime;
+
+  unsigned long budget_us;
+  unsigned long cycles;
+  unsigned long overruns;
+  unsigned long last_cycle_us;
+  unsigned long max_cycle_us;
+
+private:
+  friend class CommandQueue;
+
+  /** \brief the next command in whichever CommandQueue this one is in */
+  Command *next_in_queue;
 };
@@ -15,43 +15,41 @@ void CommandGroup::addParallel(Command *command) {
 void CommandGroup::initialize() {}
 
 void CommandGroup::_initialize() {
-  currentCommandIndex = -1;
   Command::_initialize();
 }
 
 void CommandGroup::execute() {}
 
 void CommandGroup::_execute() {
-  Command *executingCommand = 0;
-  bool done = false;
-
-  currentCommandIndex = 0;
-
-  while (!done && (currentCommandIndex < commands.size())) {
-    executingCommand = commands.get(currentCommandIndex);
-
-    bool isFinished = executingCommand->cycle();
+  // run every parallel command at the front of the queue, and then the first sequential one
+  Command *previous = nullptr;
+  Command *command = commands.front();
+  while (command) {
+    Command *next = CommandQueue::next(command);
+    command->timer = timer;
+    command->report = report;
+
+    bool inParallel = command->inParallel;
+    bool isFinished = command->cycle();
     if (isFinished) {
-      Command *removed = commands.remove(currentCommandIndex);
-      delete removed;
-      currentCommandIndex--;
+      commands.remove(previous, command);
+      delete command;
+    } else {
+      previous = command;
     }
 
-    if (!executingCommand->inParallel) {
-      done = true;
-    } else {
-      currentCommandIndex++;
+    if (!inParallel) {
+      break;
     }
+    command = next;
   }
 }
 
 void CommandGroup::end() {}
 
-void CommandGroup::_end() {
-  currentCommandIndex = 0;
-}
+void CommandGroup::_end() {}
 
 
 bool CommandGroup::isFinished() {
-  return commands.size() <= 0;
+  return commands.empty();
 }
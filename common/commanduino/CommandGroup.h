@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Command.h"
-#include "LinkedList.h"
+#include "CommandQueue.h"
 
 /** \brief grouping commands is a useful abstraction.
  * Commands groups execute commands in parallel or series
@@ -30,9 +30,5 @@ public:
 
   virtual bool isFinished();
 
-  LinkedList<Command *> commands;
-
-private:
-
-  int currentCommandIndex;
+  CommandQueue commands;
 };
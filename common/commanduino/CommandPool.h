@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+/**
+ * \brief gives a command class its own fixed pool of N blocks, so `new` and `delete` of the commands made for every
+ * step of a run don't touch the heap. Inherit from it next to Command:
+ *
+ *     class Turn : public Command, public PooledCommand<Turn, 4> { ... };
+ *
+ * and keep using new and delete as usual. N should cover as many as can be alive at once, so commands that are queued
+ * once per cell, like Forward, need a block for every cell of the longest straight. If all N blocks are in use, or a
+ * subclass is too big for a block, the command comes from the heap like before. Several robots can run in one
+ * process, so the pool takes a spin lock, which is never contended on the teensy.
+ */
+template<typename T, unsigned int N>
+class PooledCommand {
+public:
+  static void *operator new(std::size_t size) {
+    Pool &p = pool();
+    if (size <= sizeof(Block)) {
+      while (p.lock.test_and_set(std::memory_order_acquire));
+      Block *block = p.free_list;
+      if (block) {
+        p.free_list = block->next;
+      } else if (p.unused < N) {
+        block = &p.blocks[p.unused++];
+      }
+      if (block) {
+        p.in_use++;
+      }
+      p.lock.clear(std::memory_order_release);
+      if (block) {
+        return block;
+      }
+    }
+    return ::operator new(size);
+  }
+
+  static void operator delete(void *ptr) {
+    Pool &p = pool();
+    Block *block = static_cast<Block *>(ptr);
+    if (block < p.blocks || block >= p.blocks + N) {
+      ::operator delete(ptr);
+      return;
+    }
+    while (p.lock.test_and_set(std::memory_order_acquire));
+    block->next = p.free_list;
+    p.free_list = block;
+    p.in_use--;
+    p.lock.clear(std::memory_order_release);
+  }
+
+  /** \brief number of pool blocks currently handed out */
+  static unsigned int pooled() {
+    return pool().in_use;
+  }
+
+private:
+  union Block {
+    Block *next;
+    alignas(T) unsigned char bytes[sizeof(T)];
+  };
+
+  // an aggregate, so the pool is constant initialized and there's no constructor to run before the first command
+  struct Pool {
+    Block blocks[N];
+    Block *free_list;
+    unsigned int unused;
+    unsigned int in_use;
+    std::atomic_flag lock;
+  };
+
+  // only instantiated once T is complete, when the first command is made
+  static Pool &pool() {
+    static Pool p = {{}, nullptr, 0, 0, ATOMIC_FLAG_INIT};
+    return p;
+  }
+};
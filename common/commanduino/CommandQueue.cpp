@@ -0,0 +1,44 @@
+#include "CommandQueue.h"
+#include "Command.h"
+
+CommandQueue::CommandQueue() : head(nullptr), tail(nullptr), count(0) {}
+
+void CommandQueue::add(Command *command) {
+  command->next_in_queue = nullptr;
+  if (tail) {
+    tail->next_in_queue = command;
+  } else {
+    head = command;
+  }
+  tail = command;
+  count++;
+}
+
+void CommandQueue::remove(Command *previous, Command *command) {
+  if (previous) {
+    previous->next_in_queue = command->next_in_queue;
+  } else {
+    head = command->next_in_queue;
+  }
+  if (tail == command) {
+    tail = previous;
+  }
+  command->next_in_queue = nullptr;
+  count--;
+}
+
+Command *CommandQueue::front() const {
+  return head;
+}
+
+Command *CommandQueue::next(const Command *command) {
+  return command->next_in_queue;
+}
+
+int CommandQueue::size() const {
+  return count;
+}
+
+bool CommandQueue::empty() const {
+  return count == 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+class Command;
+
+/**
+ * \brief FIFO of commands, linked through the commands themselves.
+ * Adding and removing never allocate, and running the whole queue is one walk down it instead of a walk from the
+ * head for every command. A command can only be in one queue at a time. The queue doesn't own its commands.
+ */
+class CommandQueue {
+public:
+  CommandQueue();
+
+  void add(Command *command);
+
+  /** \brief unlink a command, given the command before it, or null if it's the first one */
+  void remove(Command *previous, Command *command);
+
+  Command *front() const;
+
+  /** \return the command after this one, or null if it's the last */
+  static Command *next(const Command *command);
+
+  int size() const;
+
+  bool empty() const;
+
+private:
+  Command *head;
+  Command *tail;
+  int count;
+};
@@ -1,25 +1,63 @@
+#include <common/core/util.h>
 #include "Scheduler.h"
 
-Scheduler::Scheduler(Command *masterCommand) {
+Scheduler::Scheduler(Command *masterCommand, TimerInterface *timer) : timer(timer), budget_us(0), report() {
+  report.worst_overrun_name = "none";
   addCommand(masterCommand);
 }
 
 
 void Scheduler::addCommand(Command *command) {
+  if (timer != nullptr) {
+    command->timer = timer;
+  }
+  command->report = &report;
   commands.add(command);
 }
 
 bool Scheduler::run() {
+  // every command times its own cycle, so the tick is just the sum of them
+  unsigned long tick_us = 0;
+
   //loop through commands and either init, execute, or end
-  for (int i = 0; i < commands.size(); i++) {
-    Command *command = commands.get(i);
+  Command *previous = nullptr;
+  Command *command = commands.front();
+  while (command) {
+    Command *next = CommandQueue::next(command);
     bool finished = command->cycle();
+    tick_us += command->last_cycle_us;
     if (finished) {
-      Command *removed = commands.remove(i);
-      delete removed;
+      commands.remove(previous, command);
+      delete command;
+    } else {
+      previous = command;
     }
+    command = next;
+  }
+
+  report.ticks++;
+  if (tick_us > report.worst_tick_us) {
+    report.worst_tick_us = tick_us;
+  }
+  if (budget_us > 0 && tick_us > budget_us) {
+    report.tick_overruns++;
   }
 
-  return commands.size() == 0;
+  return commands.empty();
+
+}
+
+void Scheduler::setBudgetUs(unsigned long budget_us) {
+  this->budget_us = budget_us;
+}
+
+const BudgetReport &Scheduler::getReport() const {
+  return report;
+}
 
+void Scheduler::printReport() const {
+  print("ticks: %lu, over budget: %lu, worst tick (us): %lu\r\n", report.ticks, report.tick_overruns,
+        report.worst_tick_us);
+  print("command overruns: %lu, worst: %s by %lu us\r\n", report.command_overruns, report.worst_overrun_name,
+        report.worst_overrun_us);
 }
@@ -5,15 +5,16 @@
  * Sequential commands could be added by copying the logic from CommandGroups
  */
 
-#include "LinkedList.h"
+#include "CommandQueue.h"
 #include "Command.h"
 
 class Scheduler {
 public:
   /** \brief pass the master command to the constructor
    * \param[_in] the master command to control everything
+   * \param[_in] timer the clock for every command this scheduler runs. If null, commands keep the default timer
    * */
-  Scheduler(Command *command);
+  Scheduler(Command *command, TimerInterface *timer = nullptr);
 
   /** \brief adds a command to the command group
    * \param[_in] command the pointer
@@ -27,11 +28,25 @@ public:
    */
   bool run();
 
+  /** \brief how long one call to run should take, usually whatever is left of the control period.
+   * \param budget_us 0 means no budget, which is the default
+   */
+  void setBudgetUs(unsigned long budget_us);
+
+  /** \brief tick and overrun counts for this scheduler and every command it has run */
+  const BudgetReport &getReport() const;
+
+  /** \brief print the report */
+  void printReport() const;
+
 private:
 
-  /** \brief singleton instance */
-  static Scheduler *instance;
+  TimerInterface *timer;
+
+  unsigned long budget_us;
+
+  BudgetReport report;
 
   /** \brief list of commands */
-  LinkedList<Command *> commands;
+  CommandQueue commands;
 };
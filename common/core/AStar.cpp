@@ -0,0 +1,236 @@
+#include <algorithm>
+
+#include "AStar.h"
+
+namespace {
+
+constexpr unsigned int S = smartmouse::maze::SIZE;
+
+/// \brief how far a coordinate is outside of the range lo to hi
+inline unsigned int outside(unsigned int x, unsigned int lo, unsigned int hi) {
+  return x < lo ? lo - x : (x > hi ? x - hi : 0);
+}
+
+}
+
+AStar::AStar(Mouse *mouse) : Solver(mouse), all_wall_maze(mouse->maze), goal(Solver::Goal::CENTER),
+                             search_maze(nullptr), search_id(0), heap_size(0) {
+  for (unsigned int i = 0; i < N; i++) {
+    reached[i] = 0;
+    closed[i] = 0;
+  }
+}
+
+void AStar::setup() {
+  mouse->reset();
+  mouse->maze->reset();
+  all_wall_maze = mouse->maze;
+  all_wall_maze->connect_neighbor(smartmouse::maze::CENTER, smartmouse::maze::CENTER, Direction::W);
+  all_wall_maze->connect_neighbor(smartmouse::maze::CENTER, smartmouse::maze::CENTER, Direction::N);
+  all_wall_maze->connect_neighbor(smartmouse::maze::CENTER - 1, smartmouse::maze::CENTER - 1, Direction::E);
+  all_wall_maze->connect_neighbor(smartmouse::maze::CENTER - 1, smartmouse::maze::CENTER - 1, Direction::S);
+  no_wall_maze.connect_all_neighbors_in_maze();
+  mouse->distances.clear();
+  setGoal(Solver::Goal::CENTER);
+}
+
+void AStar::setGoal(Solver::Goal goal) {
+  this->goal = goal;
+}
+
+motion_primitive_t AStar::planNextStep() {
+  //mark the nodes visted in both the mazes
+  no_wall_maze.mark_position_visited(mouse->getRow(), mouse->getCol());
+  all_wall_maze->mark_position_visited(mouse->getRow(), mouse->getCol());
+
+  //update the mazes base on what the sensors see
+  SensorReading sr = mouse->checkWalls();
+  no_wall_maze.update(sr);
+  all_wall_maze->update(sr);
+  mouse->distances.walls_changed(sr.row, sr.col);
+
+  //path from the mouse to the goal, assuming no walls where we haven't looked
+  const unsigned int C = smartmouse::maze::CENTER;
+  if (goal == Solver::Goal::CENTER) {
+    solvable = search(&no_wall_maze, &no_wall_path, mouse->getRow(), mouse->getCol(), C - 1, C - 1, C, C);
+  } else {
+    solvable = search(&no_wall_maze, &no_wall_path, mouse->getRow(), mouse->getCol(), 0, 0, 0, 0);
+  }
+  //this way commands can see this used to visualize in gazebo
+  mouse->maze->path_to_next_goal = no_wall_path;
+
+  // Walk along the no_wall_path as far as possible in the all_wall_maze
+  // This will results in the longest path where we know there are no walls
+  route_t nextPath = all_wall_maze->truncate(mouse->getRow(), mouse->getCol(), mouse->getDir(), no_wall_path);
+  if (nextPath.empty()) {
+    return {0, Direction::INVALID};
+  }
+  return nextPath.at(0);
+}
+
+route_t AStar::solve() {
+  //mouse starts at 0, 0
+  while (!isFinished()) {
+    mouse->internalTurnToFace(planNextStep().d);
+    mouse->internalForward();
+  }
+
+  teardown();
+  return all_wall_maze->fastest_route;
+}
+
+bool AStar::isFinished() {
+  unsigned int r = mouse->getRow();
+  unsigned int c = mouse->getCol();
+  const unsigned int C = smartmouse::maze::SIZE / 2;
+  if (goal == Solver::Goal::CENTER) {
+    return !solvable || ((r >= C - 1 && r <= C) && (c >= C - 1 && c <= C));
+  } else if (goal == Solver::Goal::START) {
+    return !solvable || (r == 0 && c == 0);
+  } else {
+    return false;
+  }
+}
+
+void AStar::teardown() {
+  //this is the final solution which represents how the mouse should travel from start to finish
+  //unlike Flood, it isn't kept up to date while searching, so plan it once now through what we know
+  if (goal == Solver::Goal::CENTER) {
+    const unsigned int C = smartmouse::maze::CENTER;
+    search(all_wall_maze, &all_wall_maze->fastest_route, 0, 0, C, C, C, C);
+  }
+}
+
+bool AStar::search(AbstractMaze *maze, route_t *path, unsigned int row, unsigned int col, unsigned int r0,
+                   unsigned int c0, unsigned int r1, unsigned int c1) {
+  path->clear();
+  expansions = 0;
+  search_maze = maze;
+  heap_size = 0;
+  search_id++;
+  if (search_id == 0) {
+    // the ids wrapped around, so old stamps could look like this search's
+    for (unsigned int i = 0; i < N; i++) {
+      reached[i] = 0;
+      closed[i] = 0;
+    }
+    search_id = 1;
+  }
+
+  uint16_t start = (uint16_t) (row * S + col);
+  maze->nodes[row][col]->distance = 0;
+  estimate[start] = (uint16_t) (outside(row, r0, r1) + outside(col, c0, c1));
+  reached[start] = search_id;
+  heap_push(start);
+
+  while (heap_size > 0) {
+    uint16_t cell = heap_pop();
+    closed[cell] = search_id;
+    expansions++;
+
+    Node *n = maze->nodes[cell / S][cell % S];
+    if (outside(n->row(), r0, r1) == 0 && outside(n->col(), c0, c1) == 0) {
+      // walk back to the start. The steps come out last to first, so reverse at the end
+      while (cell != start) {
+        Direction d = (Direction) came_from[cell];
+        insert_motion_primitive_back(path, {1, d});
+        Node *prev = n->neighbor(opposite_direction(d));
+        cell = (uint16_t) (prev->row() * S + prev->col());
+        n = prev;
+      }
+      std::reverse(path->begin(), path->end());
+      return true;
+    }
+
+    for (Direction d = Direction::First; d < Direction::Last; d++) {
+      Node *neighbor = n->neighbor(d);
+      if (neighbor == nullptr) {
+        continue;
+      }
+      uint16_t next = (uint16_t) (neighbor->row() * S + neighbor->col());
+      if (closed[next] == search_id) {
+        continue;
+      }
+
+      int g = n->distance + 1;
+      if (reached[next] == search_id && g >= neighbor->distance) {
+        continue;
+      }
+      neighbor->distance = g;
+      estimate[next] = (uint16_t) (g + outside(neighbor->row(), r0, r1) + outside(neighbor->col(), c0, c1));
+      came_from[next] = (uint8_t) d;
+      if (reached[next] == search_id) {
+        sift_up((unsigned int) heap_index[next]);
+      } else {
+        reached[next] = search_id;
+        heap_push(next);
+      }
+    }
+  }
+
+  return false;
+}
+
+bool AStar::before(uint16_t a, uint16_t b) const {
+  if (estimate[a] != estimate[b]) {
+    return estimate[a] < estimate[b];
+  }
+  // on ties, the cell that's further from the start is closer to the goal, so it leads there with fewer expansions
+  return search_maze->nodes[a / S][a % S]->distance > search_maze->nodes[b / S][b % S]->distance;
+}
+
+void AStar::heap_push(uint16_t cell) {
+  heap[heap_size] = cell;
+  heap_index[cell] = (int16_t) heap_size;
+  heap_size++;
+  sift_up(heap_size - 1);
+}
+
+uint16_t AStar::heap_pop() {
+  uint16_t top = heap[0];
+  heap_size--;
+  if (heap_size > 0) {
+    heap_swap(0, heap_size);
+    sift_down(0);
+  }
+  heap_index[top] = -1;
+  return top;
+}
+
+void AStar::sift_up(unsigned int i) {
+  while (i > 0) {
+    unsigned int parent = (i - 1) / 2;
+    if (!before(heap[i], heap[parent])) {
+      break;
+    }
+    heap_swap(i, parent);
+    i = parent;
+  }
+}
+
+void AStar::sift_down(unsigned int i) {
+  while (true) {
+    unsigned int best = i;
+    unsigned int left = 2 * i + 1;
+    unsigned int right = 2 * i + 2;
+    if (left < heap_size && before(heap[left], heap[best])) {
+      best = left;
+    }
+    if (right < heap_size && before(heap[right], heap[best])) {
+      best = right;
+    }
+    if (best == i) {
+      break;
+    }
+    heap_swap(i, best);
+    i = best;
+  }
+}
+
+void AStar::heap_swap(unsigned int i, unsigned int j) {
+  uint16_t tmp = heap[i];
+  heap[i] = heap[j];
+  heap[j] = tmp;
+  heap_index[heap[i]] = (int16_t) i;
+  heap_index[heap[j]] = (int16_t) j;
+}
@@ -0,0 +1,77 @@
+/** \brief starts at 0,0 and explores until it reaches the goal, just like Flood.
+ * It assumes there are no walls where it hasn't looked, and after sensing each new square it plans the shortest route
+ * from the mouse to the goal. Flood keeps a distance to every cell up to date for that, where this runs an A* search
+ * from the mouse each step. The heuristic is the Manhattan distance to the closest goal cell, which never
+ * overestimates, so the routes are just as short, but a search only expands the cells between the mouse and the goal
+ * instead of the whole maze.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "Solver.h"
+#include "Mouse.h"
+
+class AStar : public Solver {
+
+public:
+
+  AStar(Mouse *mouse);
+
+  virtual void setup() override;
+
+  virtual motion_primitive_t planNextStep() override;
+
+  virtual route_t solve() override;
+
+  virtual void teardown() override;
+
+  virtual bool isFinished() override;
+
+  virtual void setGoal(Solver::Goal goal) override;
+
+private:
+  static constexpr unsigned int N = smartmouse::maze::SIZE * smartmouse::maze::SIZE;
+
+  /** \brief shortest route from row,col to any cell in rows r0 to r1 and cols c0 to c1, through the given maze.
+   * The cost so far is kept in Node::distance of that maze's nodes.
+   * \return false if there is no route
+   */
+  bool search(AbstractMaze *maze, route_t *path, unsigned int row, unsigned int col, unsigned int r0, unsigned int c0,
+              unsigned int r1, unsigned int c1);
+
+  /// \brief whether a is a better cell to expand than b: lower estimated total, and then the one further along
+  bool before(uint16_t a, uint16_t b) const;
+
+  void heap_push(uint16_t cell);
+  uint16_t heap_pop();
+  void sift_up(unsigned int i);
+  void sift_down(unsigned int i);
+  void heap_swap(unsigned int i, unsigned int j);
+
+  /// \brief this maze is initially no walls, and walls are filled out every time the mouse moves
+  AbstractMaze no_wall_maze;
+
+  /// \brief this maze is initially all walls, and walls are removed every time the mouse moves
+  AbstractMaze *all_wall_maze;
+
+  route_t no_wall_path;
+  Solver::Goal goal;
+
+  /// \brief the maze being searched
+  AbstractMaze *search_maze;
+
+  /// \brief which search last reached or closed each cell, so nothing has to be cleared between searches
+  uint32_t search_id;
+  uint32_t reached[N];
+  uint32_t closed[N];
+
+  /// \brief cost so far plus the heuristic
+  uint16_t estimate[N];
+  /// \brief the direction we moved to get into each cell
+  uint8_t came_from[N];
+
+  uint16_t heap[N];
+  int16_t heap_index[N];
+  unsigned int heap_size;
+};
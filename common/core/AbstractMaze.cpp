@@ -2,6 +2,7 @@
   @author Peter Mitrano
   */
 #include "AbstractMaze.h"
+#include "RingBuffer.h"
 
 #include <string.h>
 #include <string>
@@ -9,35 +10,101 @@
 #include <random>
 #include <string>
 #include <sstream>
+#include <stdexcept>
+#include <utility>
 
 #ifdef EMBED
 #include <Arduino.h>
 #endif
 
-AbstractMaze::AbstractMaze() : solved(false) {
+template<unsigned int S>
+BasicMaze<S>::BasicMaze() : solved(false), flood_fill_method(FloodFillMethod::BFS), flood_fill_visits(0),
+                             walls_version(0) {
   unsigned int i, j;
-  for (i = 0; i < smartmouse::maze::SIZE; i++) {
-    for (j = 0; j < smartmouse::maze::SIZE; j++) {
+  for (i = 0; i < S; i++) {
+    for (j = 0; j < S; j++) {
       nodes[i][j] = new Node(i, j);
     }
   }
 }
 
+template<unsigned int S>
+BasicMaze<S>::BasicMaze(const BasicMaze &other)
+    : solved(other.solved), flood_fill_method(other.flood_fill_method), flood_fill_visits(other.flood_fill_visits),
+      walls_version(other.walls_version), fastest_route(other.fastest_route),
+      fastest_theoretical_route(other.fastest_theoretical_route), path_to_next_goal(other.path_to_next_goal) {
+  for (unsigned int i = 0; i < S; i++) {
+    for (unsigned int j = 0; j < S; j++) {
+      nodes[i][j] = new Node(*other.nodes[i][j]);
+    }
+  }
+
+  // the copied neighbors still point into other, so point them at our own nodes in the same places
+  for (unsigned int i = 0; i < S; i++) {
+    for (unsigned int j = 0; j < S; j++) {
+      for (Node *&neighbor : nodes[i][j]->neighbors) {
+        if (neighbor) {
+          neighbor = nodes[neighbor->row()][neighbor->col()];
+        }
+      }
+    }
+  }
+}
+
+template<unsigned int S>
+BasicMaze<S>::BasicMaze(BasicMaze &&other)
+    : solved(other.solved), flood_fill_method(other.flood_fill_method), flood_fill_visits(other.flood_fill_visits),
+      walls_version(other.walls_version), fastest_route(std::move(other.fastest_route)),
+      fastest_theoretical_route(std::move(other.fastest_theoretical_route)),
+      path_to_next_goal(std::move(other.path_to_next_goal)) {
+  for (unsigned int i = 0; i < S; i++) {
+    for (unsigned int j = 0; j < S; j++) {
+      nodes[i][j] = other.nodes[i][j];
+      other.nodes[i][j] = nullptr;
+    }
+  }
+}
+
+template<unsigned int S>
+BasicMaze<S> &BasicMaze<S>::operator=(BasicMaze other) {
+  // other is already a copy, or was moved from, so trade everything with it and let it free what we had
+  std::swap(solved, other.solved);
+  std::swap(flood_fill_method, other.flood_fill_method);
+  std::swap(flood_fill_visits, other.flood_fill_visits);
+  std::swap(walls_version, other.walls_version);
+  std::swap(fastest_route, other.fastest_route);
+  std::swap(fastest_theoretical_route, other.fastest_theoretical_route);
+  std::swap(path_to_next_goal, other.path_to_next_goal);
+  std::swap(nodes, other.nodes);
+  return *this;
+}
+
+template<unsigned int S>
+BasicMaze<S>::~BasicMaze() {
+  for (unsigned int i = 0; i < S; i++) {
+    for (unsigned int j = 0; j < S; j++) {
+      delete nodes[i][j];
+    }
+  }
+}
+
 #ifndef ARDUINO
-AbstractMaze::AbstractMaze(std::ifstream &fs) : AbstractMaze() {
+template<unsigned int S>
+BasicMaze<S>::BasicMaze(std::istream &fs) : BasicMaze() {
   std::string line;
 
   //look West and North to connect any nodes
-  for (unsigned int i = 0; i < smartmouse::maze::SIZE; i++) { //read in each line
-    std::getline(fs, line);
-
-    if (!fs.good()) {
-      print("getline failed");
-      return;
+  for (unsigned int i = 0; i < S; i++) { //read in each line
+    if (!std::getline(fs, line)) {
+      throw std::invalid_argument("maze file has " + std::to_string(i) + " rows, expected " + std::to_string(S));
+    }
+    if (line.size() < 2 * S) {
+      throw std::invalid_argument("maze file row " + std::to_string(i) + " is too short for " + std::to_string(S)
+                                  + " columns");
     }
 
     unsigned int charPos = 0;
-    for (unsigned int j = 0; j < smartmouse::maze::SIZE; j++) {
+    for (unsigned int j = 0; j < S; j++) {
       if (line.at(charPos) != '|') {
         connect_neighbor(i, j, Direction::W);
       }
@@ -52,8 +119,9 @@ AbstractMaze::AbstractMaze(std::ifstream &fs) : AbstractMaze() {
 }
 #endif
 
-int AbstractMaze::get_node(Node **out, unsigned int row, unsigned int col) {
-  if (col < 0 || col >= smartmouse::maze::SIZE || row < 0 || row >= smartmouse::maze::SIZE) {
+template<unsigned int S>
+int BasicMaze<S>::get_node(Node **out, unsigned int row, unsigned int col) {
+  if (col < 0 || col >= S || row < 0 || row >= S) {
     return Node::OUT_OF_BOUNDS;
   }
 
@@ -64,7 +132,8 @@ int AbstractMaze::get_node(Node **out, unsigned int row, unsigned int col) {
   return 0;
 }
 
-int AbstractMaze::get_node_in_direction(Node **out, unsigned int row, unsigned int col, const Direction dir) {
+template<unsigned int S>
+int BasicMaze<S>::get_node_in_direction(Node **out, unsigned int row, unsigned int col, const Direction dir) {
   switch (dir) {
     case Direction::N:
       return get_node(out, row - 1, col);
@@ -83,17 +152,19 @@ int AbstractMaze::get_node_in_direction(Node **out, unsigned int row, unsigned i
   }
 }
 
-void AbstractMaze::reset() {
+template<unsigned int S>
+void BasicMaze<S>::reset() {
   unsigned int i, j;
-  for (i = 0; i < smartmouse::maze::SIZE; i++) {
-    for (j = 0; j < smartmouse::maze::SIZE; j++) {
+  for (i = 0; i < S; i++) {
+    for (j = 0; j < S; j++) {
       nodes[i][j]->weight = -1;
       nodes[i][j]->known = false;
     }
   }
 }
 
-void AbstractMaze::update(SensorReading sr) {
+template<unsigned int S>
+void BasicMaze<S>::update(SensorReading sr) {
   for (Direction d = Direction::First; d < Direction::Last; d++) {
     //if a wall exists in that direction, add a wall
     if (sr.isWall(d)) {
@@ -108,19 +179,23 @@ void AbstractMaze::update(SensorReading sr) {
   }
 }
 
-bool AbstractMaze::flood_fill_from_point(route_t *path, unsigned int r0, unsigned int c0, unsigned int r1, unsigned int c1) {
+template<unsigned int S>
+bool BasicMaze<S>::flood_fill_from_point(route_t *path, unsigned int r0, unsigned int c0, unsigned int r1, unsigned int c1) {
   return flood_fill(path, r0, c0, r1, c1);
 }
 
-bool AbstractMaze::flood_fill_from_origin(route_t *path, unsigned int r1, unsigned int c1) {
+template<unsigned int S>
+bool BasicMaze<S>::flood_fill_from_origin(route_t *path, unsigned int r1, unsigned int c1) {
   return flood_fill(path, 0, 0, r1, c1);
 }
 
-bool AbstractMaze::flood_fill_from_origin_to_center(route_t *path) {
-  return flood_fill(path, 0, 0, smartmouse::maze::SIZE / 2, smartmouse::maze::SIZE / 2);
+template<unsigned int S>
+bool BasicMaze<S>::flood_fill_from_origin_to_center(route_t *path) {
+  return flood_fill(path, 0, 0, S / 2, S / 2);
 }
 
-bool AbstractMaze::flood_fill(route_t *path, unsigned int r0, unsigned int c0, unsigned int r1, unsigned int c1) {
+template<unsigned int S>
+bool BasicMaze<S>::flood_fill(route_t *path, unsigned int r0, unsigned int c0, unsigned int r1, unsigned int c1) {
   Node *n;
   Node *goal = nodes[r1][c1];
 
@@ -139,11 +214,17 @@ bool AbstractMaze::flood_fill(route_t *path, unsigned int r0, unsigned int c0, u
   //start at the goal
   n = goal;
 
-  //recursively visits all neighbors
-  nodes[r0][c0]->assign_weights_to_neighbors(n, 0, &success);
+  flood_fill_visits = 0;
+  if (flood_fill_method == FloodFillMethod::BFS) {
+    assign_weights_bfs(nodes[r0][c0]);
+  } else {
+    //recursively visits all neighbors
+    nodes[r0][c0]->assign_weights_to_neighbors(n, 0, &success, &flood_fill_visits);
+  }
   path->clear();
 
   //if we solved the maze,  traverse from goal back to root and record what direction is shortest
+  //the steps are found last to first, so append them and reverse once at the end instead of shifting the whole route
   while (n != nodes[r0][c0] && solvable) {
     Node *min_node = n;
     Direction min_dir = Direction::N;
@@ -167,19 +248,46 @@ bool AbstractMaze::flood_fill(route_t *path, unsigned int r0, unsigned int c0, u
 
     n = min_node;
 
-    insert_motion_primitive_front(path, {1, min_dir});
+    insert_motion_primitive_back(path, {1, min_dir});
   }
+  std::reverse(path->begin(), path->end());
 
   return solvable;
 }
 
-void AbstractMaze::disconnect_neighbor(unsigned int row, unsigned int col, const Direction dir) {
+template<unsigned int S>
+void BasicMaze<S>::assign_weights_bfs(Node *start) {
+  RingBuffer<Node *, S * S> frontier;
+
+  // nodes are marked known when they're queued, not when they're popped, so nothing gets queued twice
+  start->weight = 0;
+  start->known = true;
+  frontier.push(start);
+
+  Node *n;
+  while (frontier.pop(&n)) {
+    flood_fill_visits++;
+    for (Node *neighbor : n->neighbors) {
+      if (neighbor != nullptr && !neighbor->known) {
+        neighbor->known = true;
+        neighbor->weight = n->weight + 1;
+        frontier.push(neighbor);
+      }
+    }
+  }
+}
+
+template<unsigned int S>
+void BasicMaze<S>::disconnect_neighbor(unsigned int row, unsigned int col, const Direction dir) {
   Node *n1 = nullptr;
   int n1_status = get_node(&n1, row, col);
   Node *n2 = nullptr;
   int n2_status = get_node_in_direction(&n2, row, col, dir);
 
   if (n1_status != Node::OUT_OF_BOUNDS) {
+    if (n1->neighbors[static_cast<int>(dir)] != nullptr) {
+      walls_version++;
+    }
     n1->neighbors[static_cast<int>(dir)] = nullptr;
   }
 
@@ -188,7 +296,8 @@ void AbstractMaze::disconnect_neighbor(unsigned int row, unsigned int col, const
   }
 }
 
-void AbstractMaze::connect_neighbor(unsigned int row, unsigned int col, const Direction dir) {
+template<unsigned int S>
+void BasicMaze<S>::connect_neighbor(unsigned int row, unsigned int col, const Direction dir) {
   Node *n1 = nullptr;
   int n1_status = get_node(&n1, row, col);
   Node *n2 = nullptr;
@@ -197,39 +306,60 @@ void AbstractMaze::connect_neighbor(unsigned int row, unsigned int col, const Di
   Direction opposite = opposite_direction(dir);
 
   if ((n1_status != Node::OUT_OF_BOUNDS) && (n2_status != Node::OUT_OF_BOUNDS)) {
+    if (n1->neighbors[static_cast<int>(dir)] != n2) {
+      walls_version++;
+    }
     n1->neighbors[static_cast<int>(dir)] = n2;
     n2->neighbors[static_cast<int>(opposite)] = n1;
   }
 }
 
-void AbstractMaze::connect_all_neighbors(unsigned int row, unsigned int col) {
+template<unsigned int S>
+void BasicMaze<S>::connect_all_neighbors(unsigned int row, unsigned int col) {
   for (Direction d = Direction::First; d < Direction::Last; d++) {
     connect_neighbor(row, col, d);
   }
 }
 
-void AbstractMaze::connect_all_neighbors_in_maze() {
+template<unsigned int S>
+void BasicMaze<S>::connect_all_neighbors_in_maze() {
   unsigned int i, j;
-  for (i = 0; i < smartmouse::maze::SIZE; i++) {
-    for (j = 0; j < smartmouse::maze::SIZE; j++) {
+  for (i = 0; i < S; i++) {
+    for (j = 0; j < S; j++) {
       connect_all_neighbors(i, j);
     }
   }
 }
 
-void AbstractMaze::mark_position_visited(unsigned int row, unsigned int col) {
+template<unsigned int S>
+void BasicMaze<S>::disconnect_all_neighbors_in_maze() {
+  unsigned int i, j;
+  for (i = 0; i < S; i++) {
+    for (j = 0; j < S; j++) {
+      for (Direction d = Direction::First; d < Direction::Last; d++) {
+        disconnect_neighbor(i, j, d);
+      }
+      nodes[i][j]->visited = false;
+    }
+  }
+}
+
+template<unsigned int S>
+void BasicMaze<S>::mark_position_visited(unsigned int row, unsigned int col) {
   nodes[row][col]->visited = true;
 }
 
-void AbstractMaze::mark_origin_known() {
+template<unsigned int S>
+void BasicMaze<S>::mark_origin_known() {
   nodes[0][0]->known = true;
 }
 
-void AbstractMaze::print_maze_str(char *buff) {
+template<unsigned int S>
+void BasicMaze<S>::print_maze_str(char *buff) {
   char *b = buff;
   unsigned int i, j;
-  for (i = 0; i < smartmouse::maze::SIZE; i++) {
-    for (j = 0; j < smartmouse::maze::SIZE; j++) {
+  for (i = 0; i < S; i++) {
+    for (j = 0; j < S; j++) {
       Node *n = nodes[i][j];
       if (n->neighbor(Direction::W) == nullptr) {
         strcpy(b++, "|");
@@ -254,16 +384,18 @@ void AbstractMaze::print_maze_str(char *buff) {
   *b = '\0';
 }
 
-void AbstractMaze::print_maze() {
-  char buff[smartmouse::maze::BUFF_SIZE];
+template<unsigned int S>
+void BasicMaze<S>::print_maze() {
+  char buff[smartmouse::maze::Dimensions<S>::BUFF_SIZE];
   print_maze_str(buff);
   print(buff);
 }
 
-void AbstractMaze::print_neighbor_maze() {
+template<unsigned int S>
+void BasicMaze<S>::print_neighbor_maze() {
   unsigned int i, j;
-  for (i = 0; i < smartmouse::maze::SIZE; i++) {
-    for (j = 0; j < smartmouse::maze::SIZE; j++) {
+  for (i = 0; i < S; i++) {
+    for (j = 0; j < S; j++) {
       for (Direction d = Direction::First; d < Direction::Last; d++) {
         bool wall = (nodes[i][j]->neighbor(d) == nullptr);
         print("%i", wall);
@@ -274,10 +406,11 @@ void AbstractMaze::print_neighbor_maze() {
   }
 }
 
-void AbstractMaze::print_weight_maze() {
+template<unsigned int S>
+void BasicMaze<S>::print_weight_maze() {
   unsigned int i, j;
-  for (i = 0; i < smartmouse::maze::SIZE; i++) {
-    for (j = 0; j < smartmouse::maze::SIZE; j++) {
+  for (i = 0; i < S; i++) {
+    for (j = 0; j < S; j++) {
       int w = nodes[i][j]->weight;
       print("%03u ", w);
     }
@@ -285,10 +418,11 @@ void AbstractMaze::print_weight_maze() {
   }
 }
 
-void AbstractMaze::print_dist_maze() {
+template<unsigned int S>
+void BasicMaze<S>::print_dist_maze() {
   unsigned int i, j;
-  for (i = 0; i < smartmouse::maze::SIZE; i++) {
-    for (j = 0; j < smartmouse::maze::SIZE; j++) {
+  for (i = 0; i < S; i++) {
+    for (j = 0; j < S; j++) {
       Node *n = nodes[i][j];
       int d = n->distance;
       if (d < 10) {
@@ -303,137 +437,149 @@ void AbstractMaze::print_dist_maze() {
   }
 }
 
-void AbstractMaze::print_pointer_maze() {
+template<unsigned int S>
+void BasicMaze<S>::print_pointer_maze() {
   unsigned int i, j;
-  for (i = 0; i < smartmouse::maze::SIZE; i++) {
-    for (j = 0; j < smartmouse::maze::SIZE; j++) {
+  for (i = 0; i < S; i++) {
+    for (j = 0; j < S; j++) {
       print("%p ", nodes[i][j]);
     }
     print("\r\n");
   }
 }
 
-AbstractMaze AbstractMaze::gen_random_legal_maze() {
-  AbstractMaze maze;
+namespace {
 
-  // start at center and move out, marking visited nodes as we go
-  maze.mark_position_visited(smartmouse::maze::SIZE / 2, smartmouse::maze::SIZE / 2);
-  maze.mark_position_visited(smartmouse::maze::SIZE / 2 - 1, smartmouse::maze::SIZE / 2);
-  maze.mark_position_visited(smartmouse::maze::SIZE / 2, smartmouse::maze::SIZE / 2 - 1);
-  maze.mark_position_visited(smartmouse::maze::SIZE / 2 - 1, smartmouse::maze::SIZE / 2 - 1);
-
-  // pick std::random start node of the four possible ones;
-  unsigned int starting_row = smartmouse::maze::SIZE / 2 - std::rand() % 2;
-  unsigned int starting_col = smartmouse::maze::SIZE / 2 - std::rand() % 2;
-  Node *start_node = nullptr;
-  maze.get_node(&start_node, starting_row, starting_col);
-  _make_connections(&maze, start_node);
-
-  // knock down some more randomly
-  unsigned int i = 0;
-  while (i < smartmouse::maze::SIZE * smartmouse::maze::SIZE / 5) {
-    unsigned int row = std::rand() % (smartmouse::maze::SIZE - 2) + 1;
-    unsigned int col = std::rand() % (smartmouse::maze::SIZE - 2) + 1;
-    int d = std::rand() % 4;
-    Direction dir = int_to_dir(d);
-
-    // check if that's a valid wall to knock down
-    bool can_delete = false;
-
-    switch (dir) {
-      case Direction::N: {
-        Node *left = nullptr;
-        Node *right = nullptr;
-        Node *above = nullptr;
-        maze.get_node(&left, row, col - 1);
-        maze.get_node(&right, row, col + 1);
-        maze.get_node(&above, row - 1, col);
-        if ((left->wall(Direction::N) || left->wall(Direction::E) || above->wall(Direction::W)) &&
-            (right->wall(Direction::N) || right->wall(Direction::W) || above->wall(Direction::E))) {
-          can_delete = true;
-        }
-      }
-        break;
-      case Direction::E: {
-        Node *below = nullptr;
-        Node *right = nullptr;
-        Node *above = nullptr;
-        maze.get_node(&below, row + 1, col);
-        maze.get_node(&right, row, col + 1);
-        maze.get_node(&above, row - 1, col);
-        if ((above->wall(Direction::S) || above->wall(Direction::E) || right->wall(Direction::N)) &&
-            (below->wall(Direction::N) || below->wall(Direction::E) || right->wall(Direction::S))) {
-          can_delete = true;
-        }
-      }
-        break;
-      case Direction::S: {
-        Node *left = nullptr;
-        Node *right = nullptr;
-        Node *below = nullptr;
-        maze.get_node(&left, row, col - 1);
-        maze.get_node(&right, row, col + 1);
-        maze.get_node(&below, row + 1, col);
-        if ((left->wall(Direction::S) || left->wall(Direction::E) || below->wall(Direction::W)) &&
-            (right->wall(Direction::S) || right->wall(Direction::W) || below->wall(Direction::E))) {
-          can_delete = true;
-        }
-      }
-        break;
-      case Direction::W: {
-        Node *below = nullptr;
-        Node*left = nullptr;
-        Node *above = nullptr;
-        maze.get_node(&below, row + 1, col);
-        maze.get_node(&left, row, col - 1);
-        maze.get_node(&above, row - 1, col);
-        if ((above->wall(Direction::S) || above->wall(Direction::W) || left->wall(Direction::N)) &&
-            (below->wall(Direction::N) || below->wall(Direction::W) || left->wall(Direction::S))) {
-          can_delete = true;
-        }
-      }
-        break;
-      default:
-          break;
-    }
+/// \brief a uniform pick in [0, n). Not std::uniform_int_distribution, which differs between standard libraries
+inline unsigned int pick(std::mt19937 &engine, unsigned int n) {
+  return (unsigned int) (engine() % n);
+}
 
-    if (can_delete) {
-      maze.connect_neighbor(row, col, dir);
-      i++;
+/// \brief knocking down this wall must not leave a post with no walls touching it at either end
+template<unsigned int S>
+bool can_knock_down(BasicMaze<S> &maze, unsigned int row, unsigned int col, Direction dir) {
+  switch (dir) {
+    case Direction::N: {
+      Node *left = maze.nodes[row][col - 1];
+      Node *right = maze.nodes[row][col + 1];
+      Node *above = maze.nodes[row - 1][col];
+      return (left->wall(Direction::N) || left->wall(Direction::E) || above->wall(Direction::W)) &&
+             (right->wall(Direction::N) || right->wall(Direction::W) || above->wall(Direction::E));
+    }
+    case Direction::E: {
+      Node *below = maze.nodes[row + 1][col];
+      Node *right = maze.nodes[row][col + 1];
+      Node *above = maze.nodes[row - 1][col];
+      return (above->wall(Direction::S) || above->wall(Direction::E) || right->wall(Direction::N)) &&
+             (below->wall(Direction::N) || below->wall(Direction::E) || right->wall(Direction::S));
     }
+    case Direction::S: {
+      Node *left = maze.nodes[row][col - 1];
+      Node *right = maze.nodes[row][col + 1];
+      Node *below = maze.nodes[row + 1][col];
+      return (left->wall(Direction::S) || left->wall(Direction::E) || below->wall(Direction::W)) &&
+             (right->wall(Direction::S) || right->wall(Direction::W) || below->wall(Direction::E));
+    }
+    case Direction::W: {
+      Node *below = maze.nodes[row + 1][col];
+      Node *left = maze.nodes[row][col - 1];
+      Node *above = maze.nodes[row - 1][col];
+      return (above->wall(Direction::S) || above->wall(Direction::W) || left->wall(Direction::N)) &&
+             (below->wall(Direction::N) || below->wall(Direction::W) || left->wall(Direction::S));
+    }
+    default:
+      return false;
   }
+}
 
-  // knock down center square
-  maze.connect_neighbor(smartmouse::maze::SIZE / 2, smartmouse::maze::SIZE / 2, Direction::N);
-  maze.connect_neighbor(smartmouse::maze::SIZE / 2, smartmouse::maze::SIZE / 2, Direction::W);
-  maze.connect_neighbor(smartmouse::maze::SIZE / 2 - 1, smartmouse::maze::SIZE / 2 - 1, Direction::S);
-  maze.connect_neighbor(smartmouse::maze::SIZE / 2 - 1, smartmouse::maze::SIZE / 2 - 1, Direction::E);
+}
 
-  return maze;
+template<unsigned int S>
+BasicMaze<S> BasicMaze<S>::gen_random_legal_maze() {
+  std::random_device rd;
+  return gen_random_legal_maze(rd());
+}
+
+template<unsigned int S>
+BasicMaze<S> BasicMaze<S>::gen_random_legal_maze(uint32_t seed, uint32_t stream) {
+  std::seed_seq seq{seed, stream};
+  std::mt19937 engine(seq);
+  return gen_random_legal_maze(engine);
 }
 
-void AbstractMaze::_make_connections(AbstractMaze *maze, Node *node) {
-  static std::random_device rd;
-  static std::mt19937 g(rd());
+template<unsigned int S>
+BasicMaze<S> BasicMaze<S>::gen_random_legal_maze(std::mt19937 &engine) {
+  BasicMaze maze;
+
+  // start at center and move out, marking visited nodes as we go
+  maze.mark_position_visited(S / 2, S / 2);
+  maze.mark_position_visited(S / 2 - 1, S / 2);
+  maze.mark_position_visited(S / 2, S / 2 - 1);
+  maze.mark_position_visited(S / 2 - 1, S / 2 - 1);
+
+  // random depth first search from one of the four center cells. The stack holds every cell on the current path,
+  // and each step moves to a random unvisited neighbor of the top, or backs up if there isn't one
+  Node *stack[S * S];
+  unsigned int stack_size = 0;
+  stack[stack_size++] = maze.nodes[S / 2 - pick(engine, 2)][S / 2 - pick(engine, 2)];
+  while (stack_size > 0) {
+    Node *node = stack[stack_size - 1];
+    Direction unvisited[4];
+    unsigned int unvisited_count = 0;
+    for (Direction d = Direction::First; d < Direction::Last; d++) {
+      Node *neighbor;
+      if (maze.get_node_in_direction(&neighbor, node->row(), node->col(), d) == 0 && !neighbor->visited) {
+        unvisited[unvisited_count++] = d;
+      }
+    }
 
-  unsigned int r = node->row();
-  unsigned int c = node->col();
-  maze->mark_position_visited(r, c);
+    if (unvisited_count == 0) {
+      stack_size--;
+      continue;
+    }
 
-  // shuffle directions
-  std::vector<Direction> dirs = {Direction::N, Direction::E, Direction::S, Direction::W};
-  std::shuffle(dirs.begin(), dirs.end(), g);
+    Direction d = unvisited[pick(engine, unvisited_count)];
+    Node *next;
+    maze.get_node_in_direction(&next, node->row(), node->col(), d);
+    maze.connect_neighbor(node->row(), node->col(), d);
+    next->visited = true;
+    stack[stack_size++] = next;
+  }
 
-  for (auto d : dirs) {
-    Node *neighbor;
-    int result = maze->get_node_in_direction(&neighbor, r, c, d);
-    if (result != Node::OUT_OF_BOUNDS && result != -1) {
-      if (!neighbor->visited) {
-        maze->connect_neighbor(r, c, d);
-        _make_connections(maze, neighbor);
+  // knock down some more, so there's more than one route. Every interior wall is tried at most once, in a random
+  // order, so this always finishes. This is about as many as used to come down when it picked walls at random
+  constexpr unsigned int EXTRA_OPENINGS = S * S / 13;
+  constexpr unsigned int INTERIOR = (S - 2) * (S - 2) * 4;
+  uint16_t candidates[INTERIOR];
+  unsigned int candidate_count = 0;
+  for (unsigned int row = 1; row < S - 1; row++) {
+    for (unsigned int col = 1; col < S - 1; col++) {
+      for (Direction d = Direction::First; d < Direction::Last; d++) {
+        candidates[candidate_count++] = (uint16_t) ((row * S + col) * 4 + (int) d);
       }
     }
   }
+  unsigned int opened = 0;
+  for (unsigned int i = 0; i < candidate_count && opened < EXTRA_OPENINGS; i++) {
+    // this is one step of a Fisher-Yates shuffle, done lazily
+    std::swap(candidates[i], candidates[i + pick(engine, candidate_count - i)]);
+    unsigned int cell = candidates[i] / 4;
+    unsigned int row = cell / S;
+    unsigned int col = cell % S;
+    Direction dir = int_to_dir(candidates[i] % 4);
+    if (maze.nodes[row][col]->wall(dir) && can_knock_down(maze, row, col, dir)) {
+      maze.connect_neighbor(row, col, dir);
+      opened++;
+    }
+  }
+
+  // knock down center square
+  maze.connect_neighbor(S / 2, S / 2, Direction::N);
+  maze.connect_neighbor(S / 2, S / 2, Direction::W);
+  maze.connect_neighbor(S / 2 - 1, S / 2 - 1, Direction::S);
+  maze.connect_neighbor(S / 2 - 1, S / 2 - 1, Direction::E);
+
+  return maze;
 }
 
 std::string route_to_string(route_t &route) {
@@ -466,7 +612,30 @@ void insert_motion_primitive_front(route_t *route, motion_primitive_t prim) {
   }
 }
 
-route_t AbstractMaze::truncate(unsigned int row, unsigned int col, Direction dir, route_t route) {
+std::string diagonal_route_to_string(const diagonal_route_t &route) {
+  std::stringstream ss;
+  if (route.empty()) {
+    ss << "empty";
+  }
+
+  for (diagonal_primitive_t prim : route) {
+    ss << (int)prim.n << heading_to_string(prim.h);
+  }
+
+  return ss.str();
+}
+
+void insert_diagonal_primitive_back(diagonal_route_t *route, diagonal_primitive_t prim) {
+  if (!route->empty() && prim.h == route->back().h) {
+    route->back().n += prim.n;
+  }
+  else {
+    route->insert(route->cend(), prim);
+  }
+}
+
+template<unsigned int S>
+route_t BasicMaze<S>::truncate(unsigned int row, unsigned int col, Direction dir, route_t route) {
   route_t trunc;
   Node *n = nodes[row][col];
   bool done = false;
@@ -489,10 +658,11 @@ route_t AbstractMaze::truncate(unsigned int row, unsigned int col, Direction dir
   return trunc;
 }
 
-bool AbstractMaze::operator==(const AbstractMaze &other) const {
+template<unsigned int S>
+bool BasicMaze<S>::operator==(const BasicMaze &other) const {
   unsigned int i, j;
-  for (i = 0; i < smartmouse::maze::SIZE; i++) {
-    for (j = 0; j < smartmouse::maze::SIZE; j++) {
+  for (i = 0; i < S; i++) {
+    for (j = 0; j < S; j++) {
       for (Direction d = Direction::First; d != Direction::Last; d++) {
         bool n1 = static_cast<bool>(nodes[i][j]->neighbor(d));
         bool n2 = static_cast<bool>(other.nodes[i][j]->neighbor(d));
@@ -504,3 +674,10 @@ bool AbstractMaze::operator==(const AbstractMaze &other) const {
   }
   return true;
 }
+
+template class BasicMaze<8>;
+template class BasicMaze<16>;
+template class BasicMaze<32>;
+#if SMARTMOUSE_MAZE_SIZE != 8 && SMARTMOUSE_MAZE_SIZE != 16 && SMARTMOUSE_MAZE_SIZE != 32
+template class BasicMaze<smartmouse::maze::SIZE>;
+#endif
@@ -12,6 +12,7 @@
 #include "SensorReading.h"
 #include "Node.h"
 #include "Direction.h"
+#include <random>
 #include <vector>
 
 /**
@@ -29,10 +30,28 @@ std::string route_to_string(route_t &route);
 void insert_motion_primitive_front(route_t *route, motion_primitive_t prim);
 void insert_motion_primitive_back(route_t *route, motion_primitive_t prim);
 
+/**
+ * \brief a straight run of a route that can also drive diagonally. n counts half cells along h, so going from one
+ * cell center to the next is 2, and cutting across the corner of a cell from one wall gap to the next is 1.
+ */
+struct diagonal_primitive_t {
+  uint8_t n;
+  Heading h;
+};
+typedef std::vector<diagonal_primitive_t> diagonal_route_t;
+
+std::string diagonal_route_to_string(const diagonal_route_t &route);
+void insert_diagonal_primitive_back(diagonal_route_t *route, diagonal_primitive_t prim);
+
+// the maze size the mouse, solvers, and commands are built for. Override with cmake -DMAZE_SIZE=8
+#ifndef SMARTMOUSE_MAZE_SIZE
+#define SMARTMOUSE_MAZE_SIZE 16
+#endif
+
 namespace smartmouse {
 namespace maze {
 
-constexpr static unsigned int SIZE = 16;
+constexpr static unsigned int SIZE = SMARTMOUSE_MAZE_SIZE;
 const unsigned long BUFF_SIZE = (SIZE * 2 + 3) * SIZE;
 constexpr static unsigned int CENTER = SIZE / 2;
 constexpr static double UNIT_DIST_M = 0.18;
@@ -53,15 +72,49 @@ constexpr double WALL_THICKNESS_CU = toCellUnits(WALL_THICKNESS_M);
 constexpr double HALF_WALL_THICKNESS_CU = toCellUnits(HALF_WALL_THICKNESS_M);
 constexpr double SIZE_CU = toCellUnits(SIZE_M);
 
+/** \brief the size dependent constants above, for a maze of any size S.
+ * The maze types are templated on their size so storage and loop bounds are fixed at compile time.
+ */
+template<unsigned int S>
+struct Dimensions {
+  constexpr static unsigned int SIZE = S;
+  constexpr static unsigned long BUFF_SIZE = (S * 2 + 3) * S;
+  constexpr static unsigned int CENTER = S / 2;
+  constexpr static double SIZE_M = S * UNIT_DIST_M;
+  constexpr static double SIZE_CU = S;
+};
+
 }
 }
 
-class AbstractMaze {
+/**
+ * \brief a maze of S by S nodes. Use AbstractMaze unless you specifically need another size.
+ * Member functions are defined in AbstractMaze.cpp and instantiated for 8x8, 16x16, 32x32, and SIZE.
+ */
+template<unsigned int S>
+class BasicMaze {
   friend class Mouse;
 
  public:
 
+  /** \brief which algorithm flood_fill uses to assign weights
+   * RECURSIVE is the original depth first Node::assign_weights_to_neighbors, which revisits a node every time
+   * it finds a shorter path to it. BFS uses a fixed size queue and assigns every reachable node exactly once.
+   * Both produce the same weights and therefore the same paths.
+   */
+  enum class FloodFillMethod {
+    RECURSIVE,
+    BFS
+  };
+
   bool solved;
+  FloodFillMethod flood_fill_method;
+
+  /// \brief number of times a node was assigned a weight during the last flood fill
+  unsigned int flood_fill_visits;
+
+  /// \brief counts every wall added or removed, so anything cached from the walls can tell when it's stale
+  uint32_t walls_version;
   route_t fastest_route;
   route_t fastest_theoretical_route;
   route_t path_to_next_goal;
@@ -69,10 +122,23 @@ class AbstractMaze {
   /** \brief allocates and initializes a node
    * allocates a maze of the given size and sets all links in graph to be null. Naturally, it's column major.
    */
-  AbstractMaze();
+  BasicMaze();
+
+  /** \brief a deep copy, with its own nodes linked up the same way as other's */
+  BasicMaze(const BasicMaze &other);
+
+  /** \brief takes other's nodes, which leaves other with none */
+  BasicMaze(BasicMaze &&other);
+
+  BasicMaze &operator=(BasicMaze other);
+
+  ~BasicMaze();
 
 #ifndef ARDUINO // this can't exist on arduino
-  AbstractMaze(std::ifstream &fs);
+  /** \brief parse a maze in the .mz text format. It must have exactly S rows of S cells
+   * \throws std::invalid_argument if there are too few rows or a row is too short, like a smaller maze would be
+   */
+  BasicMaze(std::istream &fs);
 #endif
 
   void mark_origin_known();
@@ -109,6 +175,9 @@ class AbstractMaze {
    */
   void connect_all_neighbors_in_maze();
 
+  /** \brief put back every wall and forget which cells were visited, so the maze can be solved again from scratch */
+  void disconnect_all_neighbors_in_maze();
+
   /** \brief get node by its position
    * \return 0 on success, OUT_OF_BOUNDS, or -1 on NULL
    */
@@ -162,12 +231,30 @@ class AbstractMaze {
   void print_dist_maze();
 #pragma clang diagnostic pop
 
-  static AbstractMaze gen_random_legal_maze();
-  static void _make_connections(AbstractMaze *maze, Node *node);
+  /** \brief a random maze that can be solved, seeded from std::random_device. Use a seeded version to reproduce it */
+  static BasicMaze gen_random_legal_maze();
+
+  /** \brief the same seed and stream always give the same maze, on any platform.
+   * Different streams of one seed are independent, so maze i of a batch can be made as stream i on any thread.
+   */
+  static BasicMaze gen_random_legal_maze(uint32_t seed, uint32_t stream = 0);
+
+  /** \brief a random depth first search from the center, then a few extra walls knocked down so there's more than
+   * one route. Only the engine passed in is used, so generating on several threads at once is safe.
+   */
+  static BasicMaze gen_random_legal_maze(std::mt19937 &engine);
 
   bool flood_fill(route_t *path, unsigned int r0, unsigned int c0, unsigned int r1, unsigned int c1);
 
-  bool operator==(const AbstractMaze &other) const;
+  /** \brief breadth first weight assignment starting from the given node.
+   * each reachable node is pushed onto the queue at most once, so the queue never holds more than SIZE*SIZE nodes.
+   * call reset() first.
+   */
+  void assign_weights_bfs(Node *start);
+
+  bool operator==(const BasicMaze &other) const;
 
-  Node *nodes[smartmouse::maze::SIZE][smartmouse::maze::SIZE]; // array of node pointers
+  Node *nodes[S][S]; // array of node pointers
 };
+
+typedef BasicMaze<smartmouse::maze::SIZE> AbstractMaze;
@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "DiagonalPlanner.h"
+
+namespace {
+
+constexpr float UNREACHED = 1e30f;
+
+/// \brief half cell steps for each Heading, in rows and cols
+constexpr int HEADING_DY[] = {-1, -1, 0, 1, 1, 1, 0, -1};
+constexpr int HEADING_DX[] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+inline bool is_odd(int i) {
+  return (i % 2 + 2) % 2 == 1;
+}
+
+}
+
+template<unsigned int S>
+BasicDiagonalPlanner<S>::BasicDiagonalPlanner(BasicMaze<S> *maze, RunLimits limits)
+    : expansions(0), maze(maze), limits(limits), cost(STATES, UNREACHED), parent(STATES, -1), closed(STATES, false),
+      heap(STATES), heap_index(STATES, -1), heap_size(0) {}
+
+template<unsigned int S>
+bool BasicDiagonalPlanner<S>::open(int y, int x) const {
+  if (y < 0 || x < 0 || y >= (int) P || x >= (int) P) {
+    return false;
+  }
+  bool y_odd = is_odd(y);
+  bool x_odd = is_odd(x);
+  if (y_odd && x_odd) {
+    return true;
+  }
+  if (!y_odd && !x_odd) {
+    return false;
+  }
+  if (y_odd) {
+    // the wall between two cells in the same row
+    if (x == 0 || x == 2 * (int) S) {
+      return false;
+    }
+    return maze->nodes[y / 2][x / 2 - 1]->neighbor(Direction::E) != nullptr;
+  }
+  // the wall between two cells in the same col
+  if (y == 0 || y == 2 * (int) S) {
+    return false;
+  }
+  return maze->nodes[y / 2 - 1][x / 2]->neighbor(Direction::S) != nullptr;
+}
+
+template<unsigned int S>
+double BasicDiagonalPlanner<S>::run_time(unsigned int half_cells, bool diagonal, bool from_rest) const {
+  return limits.straight_time(half_cells * (diagonal ? M_SQRT2 / 2 : 0.5), diagonal, from_rest);
+}
+
+template<unsigned int S>
+bool BasicDiagonalPlanner<S>::plan(diagonal_route_t *route, unsigned int r0, unsigned int c0, Direction start_dir,
+                                   unsigned int r1, unsigned int c1) {
+  route->clear();
+  std::fill(cost.begin(), cost.end(), UNREACHED);
+  std::fill(parent.begin(), parent.end(), -1);
+  std::fill(closed.begin(), closed.end(), false);
+  std::fill(heap_index.begin(), heap_index.end(), -1);
+  heap_size = 0;
+  expansions = 0;
+
+  uint32_t start_point = (2 * r0 + 1) * P + 2 * c0 + 1;
+  uint32_t goal_point = (2 * r1 + 1) * P + 2 * c1 + 1;
+  uint32_t start = start_point * HEADINGS + (uint32_t) dir_to_heading(start_dir);
+  cost[start] = 0;
+  heap_push(start);
+
+  while (heap_size > 0) {
+    uint32_t state = heap_pop();
+    closed[state] = true;
+    expansions++;
+
+    uint32_t point = state / HEADINGS;
+    Heading h = (Heading) (state % HEADINGS);
+    int y = point / P;
+    int x = point % P;
+
+    if (point == goal_point) {
+      // walk back to the start, then put the runs in driving order
+      diagonal_route_t backwards;
+      while (state != start) {
+        uint32_t prev = (uint32_t) parent[state];
+        int prev_y = (prev / HEADINGS) / P;
+        int prev_x = (prev / HEADINGS) % P;
+        int n = std::max(std::abs(y - prev_y), std::abs(x - prev_x));
+        backwards.push_back({(uint8_t) n, (Heading) (state % HEADINGS)});
+        state = prev;
+        y = prev_y;
+        x = prev_x;
+      }
+      for (auto it = backwards.rbegin(); it != backwards.rend(); it++) {
+        insert_diagonal_primitive_back(route, *it);
+      }
+      return true;
+    }
+
+    for (unsigned int i = 0; i < HEADINGS; i++) {
+      Heading next_h = (Heading) i;
+      unsigned int steps = heading_steps(h, next_h);
+      // turning around is never quicker, and going on in the same heading is the same run unless we just started
+      if (steps == 4 || (steps == 0 && state != start)) {
+        continue;
+      }
+
+      float base = cost[state] + (float) limits.turn_time(steps);
+      bool diagonal = is_diagonal(next_h);
+      for (unsigned int k = 1;; k++) {
+        int next_y = y + (int) k * HEADING_DY[i];
+        int next_x = x + (int) k * HEADING_DX[i];
+        if (!open(next_y, next_x)) {
+          break;
+        }
+        uint32_t next = ((uint32_t) next_y * P + (uint32_t) next_x) * HEADINGS + i;
+        relax(state, next, base + (float) run_time(k, diagonal, state == start));
+      }
+    }
+  }
+
+  return false;
+}
+
+template<unsigned int S>
+double BasicDiagonalPlanner<S>::route_time(const diagonal_route_t &route, Direction start_dir) const {
+  Heading h = dir_to_heading(start_dir);
+  double t = 0;
+  bool first = true;
+  for (diagonal_primitive_t prim : route) {
+    t += limits.turn_time(heading_steps(h, prim.h)) + run_time(prim.n, is_diagonal(prim.h), first);
+    h = prim.h;
+    first = false;
+  }
+  return t;
+}
+
+template<unsigned int S>
+diagonal_route_t BasicDiagonalPlanner<S>::from_route(const route_t &route) {
+  diagonal_route_t diagonal_route;
+  for (motion_primitive_t prim : route) {
+    insert_diagonal_primitive_back(&diagonal_route, {(uint8_t) (2 * prim.n), dir_to_heading(prim.d)});
+  }
+  return diagonal_route;
+}
+
+template<unsigned int S>
+route_t BasicDiagonalPlanner<S>::to_route(const diagonal_route_t &diagonal_route) {
+  // only which kind of point we're on matters, so start from any cell center
+  route_t route;
+  int y = 1, x = 1;
+  for (diagonal_primitive_t prim : diagonal_route) {
+    int dy = HEADING_DY[(int) prim.h];
+    int dx = HEADING_DX[(int) prim.h];
+    for (unsigned int i = 0; i < prim.n; i++) {
+      y += dy;
+      x += dx;
+      // every wall midpoint we land on is a move into the next cell
+      if (is_odd(y) && !is_odd(x)) {
+        insert_motion_primitive_back(&route, {1, dx > 0 ? Direction::E : Direction::W});
+      } else if (!is_odd(y) && is_odd(x)) {
+        insert_motion_primitive_back(&route, {1, dy > 0 ? Direction::S : Direction::N});
+      }
+    }
+  }
+  return route;
+}
+
+template<unsigned int S>
+void BasicDiagonalPlanner<S>::relax(uint32_t from, uint32_t to, float new_cost) {
+  if (closed[to] || new_cost >= cost[to]) {
+    return;
+  }
+  cost[to] = new_cost;
+  parent[to] = (int32_t) from;
+  if (heap_index[to] < 0) {
+    heap_push(to);
+  } else {
+    sift_up((unsigned int) heap_index[to]);
+  }
+}
+
+template<unsigned int S>
+void BasicDiagonalPlanner<S>::heap_push(uint32_t state) {
+  heap[heap_size] = state;
+  heap_index[state] = (int32_t) heap_size;
+  heap_size++;
+  sift_up(heap_size - 1);
+}
+
+template<unsigned int S>
+uint32_t BasicDiagonalPlanner<S>::heap_pop() {
+  uint32_t top = heap[0];
+  heap_size--;
+  if (heap_size > 0) {
+    heap_swap(0, heap_size);
+    sift_down(0);
+  }
+  heap_index[top] = -1;
+  return top;
+}
+
+template<unsigned int S>
+void BasicDiagonalPlanner<S>::sift_up(unsigned int i) {
+  while (i > 0) {
+    unsigned int parent_i = (i - 1) / 2;
+    if (cost[heap[i]] >= cost[heap[parent_i]]) {
+      break;
+    }
+    heap_swap(i, parent_i);
+    i = parent_i;
+  }
+}
+
+template<unsigned int S>
+void BasicDiagonalPlanner<S>::sift_down(unsigned int i) {
+  while (true) {
+    unsigned int smallest = i;
+    unsigned int left = 2 * i + 1;
+    unsigned int right = 2 * i + 2;
+    if (left < heap_size && cost[heap[left]] < cost[heap[smallest]]) {
+      smallest = left;
+    }
+    if (right < heap_size && cost[heap[right]] < cost[heap[smallest]]) {
+      smallest = right;
+    }
+    if (smallest == i) {
+      break;
+    }
+    heap_swap(i, smallest);
+    i = smallest;
+  }
+}
+
+template<unsigned int S>
+void BasicDiagonalPlanner<S>::heap_swap(unsigned int i, unsigned int j) {
+  uint32_t tmp = heap[i];
+  heap[i] = heap[j];
+  heap[j] = tmp;
+  heap_index[heap[i]] = (int32_t) i;
+  heap_index[heap[j]] = (int32_t) j;
+}
+
+template class BasicDiagonalPlanner<8>;
+template class BasicDiagonalPlanner<16>;
+template class BasicDiagonalPlanner<32>;
+#if SMARTMOUSE_MAZE_SIZE != 8 && SMARTMOUSE_MAZE_SIZE != 16 && SMARTMOUSE_MAZE_SIZE != 32
+template class BasicDiagonalPlanner<smartmouse::maze::SIZE>;
+#endif
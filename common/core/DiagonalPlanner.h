@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "AbstractMaze.h"
+#include "RunLimits.h"
+
+/**
+ * \brief the quickest route between two cells for a mouse that can cut diagonally through zig-zags.
+ *
+ * The graph is every cell center and every wall midpoint, so it's a grid of half cells without the posts. From a cell
+ * center the mouse can only go straight through one of the four walls. From a wall midpoint it can go straight into
+ * the next cell, or diagonally across the corner of a cell to the next wall midpoint. Walls that aren't open are
+ * walls, so plan on the maze the mouse explored and unknown walls count as there.
+ *
+ * A search state is a point and the heading the mouse arrived in, and each edge is a whole straight run followed by
+ * a turn. A run costs the time to speed up from v_turn towards v_max (or v_max_diagonal) and slow back down over its
+ * length, and a turn costs the time to drive its arc at v_turn. So a long straight is worth more than the same number
+ * of short ones, and turns aren't free. route_time measures any route with exactly the same costs, which is what the
+ * search minimizes.
+ *
+ * The search needs (2S+1)^2 * 8 states, which is too big for the stack, so its storage is allocated once when the
+ * planner is constructed. Instantiated in DiagonalPlanner.cpp for the same sizes as BasicMaze.
+ */
+template<unsigned int S>
+class BasicDiagonalPlanner {
+public:
+  BasicDiagonalPlanner(BasicMaze<S> *maze, RunLimits limits);
+
+  /**
+   * \brief the quickest route from the center of r0,c0 to the center of r1,c1, starting out facing start_dir
+   * \return false if there is no route
+   */
+  bool plan(diagonal_route_t *route, unsigned int r0, unsigned int c0, Direction start_dir, unsigned int r1,
+            unsigned int c1);
+
+  /** \brief how long the route takes with the planner's costs, starting from rest facing start_dir */
+  double route_time(const diagonal_route_t &route, Direction start_dir) const;
+
+  /** \brief seconds to drive a straight of the given number of half cells */
+  double run_time(unsigned int half_cells, bool diagonal, bool from_rest) const;
+
+  /** \brief the same route, for timing or comparing against diagonal routes */
+  static diagonal_route_t from_route(const route_t &route);
+
+  /** \brief the cells a diagonal route passes through, in order, as a route the four direction commands can drive */
+  static route_t to_route(const diagonal_route_t &route);
+
+  /// \brief number of states taken off the queue during the last plan
+  unsigned int expansions;
+
+private:
+  static constexpr unsigned int P = 2 * S + 1;
+  static constexpr unsigned int HEADINGS = 8;
+  static constexpr unsigned int STATES = P * P * HEADINGS;
+
+  /// \brief whether the mouse can pass through this point. Cell centers always can, posts never can
+  bool open(int y, int x) const;
+
+  void relax(uint32_t from, uint32_t to, float cost);
+
+  void heap_push(uint32_t state);
+  uint32_t heap_pop();
+  void sift_up(unsigned int i);
+  void sift_down(unsigned int i);
+  void heap_swap(unsigned int i, unsigned int j);
+
+  BasicMaze<S> *maze;
+  RunLimits limits;
+
+  std::vector<float> cost;
+  std::vector<int32_t> parent;
+  std::vector<bool> closed;
+  std::vector<uint32_t> heap;
+  std::vector<int32_t> heap_index;
+  unsigned int heap_size;
+};
+
+typedef BasicDiagonalPlanner<smartmouse::maze::SIZE> DiagonalPlanner;
@@ -200,3 +200,77 @@ Direction char_to_dir(char c) {
   }
 }
 
+
+Heading dir_to_heading(Direction d) {
+  switch (d) {
+    case Direction::N:
+      return Heading::N;
+    case Direction::E:
+      return Heading::E;
+    case Direction::S:
+      return Heading::S;
+    case Direction::W:
+      return Heading::W;
+    default:
+      return Heading::INVALID;
+  }
+}
+
+Direction heading_to_dir(Heading h) {
+  switch (h) {
+    case Heading::N:
+      return Direction::N;
+    case Heading::E:
+      return Direction::E;
+    case Heading::S:
+      return Direction::S;
+    case Heading::W:
+      return Direction::W;
+    default:
+      return Direction::INVALID;
+  }
+}
+
+bool is_diagonal(Heading h) {
+  return h == Heading::NE || h == Heading::SE || h == Heading::SW || h == Heading::NW;
+}
+
+double heading_to_yaw(Heading h) {
+  if (h == Heading::INVALID || h == Heading::Last) {
+    return -999;
+  }
+  // N is pi/2 and every step clockwise takes off pi/4, wrapped into (-pi, pi]
+  double yaw = M_PI / 2 - (int) h * M_PI / 4;
+  if (yaw <= -M_PI) {
+    yaw += 2 * M_PI;
+  }
+  return yaw;
+}
+
+unsigned int heading_steps(Heading from, Heading to) {
+  unsigned int diff = (unsigned int) (((int) to - (int) from + 8) % 8);
+  return diff > 4 ? 8 - diff : diff;
+}
+
+const char *heading_to_string(Heading h) {
+  switch (h) {
+    case Heading::N:
+      return "N";
+    case Heading::NE:
+      return "NE";
+    case Heading::E:
+      return "E";
+    case Heading::SE:
+      return "SE";
+    case Heading::S:
+      return "S";
+    case Heading::SW:
+      return "SW";
+    case Heading::W:
+      return "W";
+    case Heading::NW:
+      return "NW";
+    default:
+      return "?";
+  }
+}
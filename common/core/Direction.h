@@ -45,3 +45,33 @@ char dir_to_char(Direction dir);
 
 /** translate a char into the direction representation*/
 Direction char_to_dir(char c);
+
+/** \brief the eight headings a diagonal route can drive in, clockwise from N like Direction */
+enum class Heading {
+  N, //0
+  NE, //1
+  E, //2
+  SE, //3
+  S, //4
+  SW, //5
+  W, //6
+  NW, //7
+  Last, //8
+  First = N, //0
+  INVALID = -1
+};
+
+Heading dir_to_heading(Direction d);
+
+/** \return Direction::INVALID for the diagonal headings */
+Direction heading_to_dir(Heading h);
+
+bool is_diagonal(Heading h);
+
+double heading_to_yaw(Heading h);
+
+/** \brief how many 45 degree steps it takes to turn from one heading to the other, between 0 and 4 */
+unsigned int heading_steps(Heading from, Heading to);
+
+/** translate a Heading into "N", "NE", ... */
+const char *heading_to_string(Heading h);
@@ -0,0 +1,118 @@
+#include "DistanceCache.h"
+
+template<unsigned int S>
+BasicDistanceCache<S>::BasicDistanceCache(BasicMaze<S> *maze)
+    : expansions(0), rebuilds(0), maze(maze), fields{BasicDistanceField<S>(maze), BasicDistanceField<S>(maze),
+                                                     BasicDistanceField<S>(maze)}, in_use{false, false, false},
+      cell_row(0), cell_col(0), seen_version(maze->walls_version) {}
+
+template<unsigned int S>
+void BasicDistanceCache<S>::clear() {
+  for (unsigned int slot = 0; slot < SLOTS; slot++) {
+    in_use[slot] = false;
+  }
+  seen_version = maze->walls_version;
+}
+
+template<unsigned int S>
+void BasicDistanceCache<S>::walls_changed(unsigned int row, unsigned int col) {
+  // the change being reported has already moved walls_version on, so don't check it here
+  for (unsigned int slot = 0; slot < SLOTS; slot++) {
+    if (in_use[slot]) {
+      fields[slot].walls_changed(row, col);
+    }
+  }
+  seen_version = maze->walls_version;
+}
+
+template<unsigned int S>
+bool BasicDistanceCache<S>::repair(unsigned int max_expansions) {
+  check_version();
+  expansions = 0;
+  for (unsigned int slot = 0; slot < SLOTS; slot++) {
+    if (!in_use[slot]) {
+      continue;
+    }
+    bool consistent = fields[slot].repair(max_expansions - expansions);
+    expansions += fields[slot].expansions;
+    if (!consistent) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<unsigned int S>
+const BasicDistanceField<S> &BasicDistanceCache<S>::to_center() {
+  return get(CENTER_SLOT);
+}
+
+template<unsigned int S>
+const BasicDistanceField<S> &BasicDistanceCache<S>::to_start() {
+  return get(START_SLOT);
+}
+
+template<unsigned int S>
+const BasicDistanceField<S> &BasicDistanceCache<S>::to_cell(unsigned int row, unsigned int col) {
+  if (in_use[CELL_SLOT] && (row != cell_row || col != cell_col)) {
+    in_use[CELL_SLOT] = false;
+  }
+  cell_row = row;
+  cell_col = col;
+  return get(CELL_SLOT);
+}
+
+template<unsigned int S>
+const BasicDistanceField<S> &BasicDistanceCache<S>::get(unsigned int slot) {
+  check_version();
+  if (!in_use[slot]) {
+    build(slot);
+  }
+  BasicDistanceField<S> *field = &fields[slot];
+  if (!field->consistent()) {
+    expansions = field->repair();
+  }
+  return *field;
+}
+
+template<unsigned int S>
+void BasicDistanceCache<S>::build(unsigned int slot) {
+  constexpr unsigned int C = smartmouse::maze::Dimensions<S>::CENTER;
+  BasicDistanceField<S> *field = &fields[slot];
+  switch (slot) {
+    case CENTER_SLOT:
+      field->set_root(C, C);
+      field->add_root(C - 1, C - 1);
+      field->add_root(C - 1, C);
+      field->add_root(C, C - 1);
+      break;
+    case START_SLOT:
+      field->set_root(0, 0);
+      break;
+    default:
+      field->set_root(cell_row, cell_col);
+      break;
+  }
+  in_use[slot] = true;
+  rebuilds++;
+}
+
+template<unsigned int S>
+void BasicDistanceCache<S>::check_version() {
+  if (maze->walls_version == seen_version) {
+    return;
+  }
+  for (unsigned int slot = 0; slot < SLOTS; slot++) {
+    if (in_use[slot]) {
+      build(slot);
+    }
+  }
+  seen_version = maze->walls_version;
+}
+
+template class BasicDistanceCache<8>;
+template class BasicDistanceCache<16>;
+template class BasicDistanceCache<32>;
+#if SMARTMOUSE_MAZE_SIZE != 8 && SMARTMOUSE_MAZE_SIZE != 16 && SMARTMOUSE_MAZE_SIZE != 32
+template class BasicDistanceCache<smartmouse::maze::SIZE>;
+#endif
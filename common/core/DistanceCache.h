@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+#include "DistanceField.h"
+
+/**
+ * \brief distance fields to the goals the mouse keeps going back to, kept between plans instead of flood filling
+ * from scratch for each one. There's one field per goal set: the four center cells, the start cell, and one slot for
+ * any other cell. A field is built the first time it's asked for, and after that it's only touched when walls
+ * change, so going back to the start after reaching the center costs nothing unless new walls were seen.
+ *
+ * Report wall changes with walls_changed() and the fields in use are repaired incrementally. If the maze's walls
+ * change without being reported, which walls_version gives away, every field is rebuilt the next time it's used.
+ * So either report every change to a maze, or none of them.
+ *
+ * Once a field is repaired, its next_step is a look at four neighbors, so following it costs O(1) per cell.
+ * Instantiated in DistanceCache.cpp for the same sizes as BasicMaze.
+ */
+template<unsigned int S>
+class BasicDistanceCache {
+public:
+  BasicDistanceCache(BasicMaze<S> *maze);
+
+  /** \brief drop every field, for when the maze was changed wholesale. They're rebuilt when they're next used */
+  void clear();
+
+  /** \brief tell every field in use that walls around this cell may have been added or removed */
+  void walls_changed(unsigned int row, unsigned int col);
+
+  /** \brief repair the fields in use by at most max_expansions cells in total
+   * \return true if they're all consistent
+   */
+  bool repair(unsigned int max_expansions);
+
+  /** \brief distance to the closest of the four center cells, fully repaired */
+  const BasicDistanceField<S> &to_center();
+
+  /** \brief distance to the start cell, fully repaired. Distances are symmetric, so this is the distance from it too */
+  const BasicDistanceField<S> &to_start();
+
+  /** \brief distance to any cell, fully repaired. There's one slot for these, so asking for a different cell than
+   * last time rebuilds it
+   */
+  const BasicDistanceField<S> &to_cell(unsigned int row, unsigned int col);
+
+  /// \brief cells expanded by the last repair, or by the last lookup that had repairs to do
+  unsigned int expansions;
+
+  /// \brief how many times a field has been built from scratch instead of repaired
+  unsigned int rebuilds;
+
+private:
+  enum Slot {
+    CENTER_SLOT,
+    START_SLOT,
+    CELL_SLOT,
+    SLOTS
+  };
+
+  const BasicDistanceField<S> &get(unsigned int slot);
+
+  void build(unsigned int slot);
+
+  /// \brief rebuild every field in use if the walls changed behind our back
+  void check_version();
+
+  BasicMaze<S> *maze;
+
+  BasicDistanceField<S> fields[SLOTS];
+  bool in_use[SLOTS];
+
+  unsigned int cell_row;
+  unsigned int cell_col;
+
+  /// \brief the maze's walls_version as of the last change we know about
+  uint32_t seen_version;
+};
+
+typedef BasicDistanceCache<smartmouse::maze::SIZE> DistanceCache;
@@ -0,0 +1,295 @@
+#include <algorithm>
+
+#include "DistanceField.h"
+
+namespace {
+
+template<unsigned int S>
+inline uint16_t cell_of(unsigned int row, unsigned int col) {
+  return (uint16_t) (row * S + col);
+}
+
+template<unsigned int S>
+inline unsigned int row_of(uint16_t cell) {
+  return cell / S;
+}
+
+template<unsigned int S>
+inline unsigned int col_of(uint16_t cell) {
+  return cell % S;
+}
+
+inline uint16_t plus_one(uint16_t d) {
+  return d == 0xFFFF ? d : (uint16_t) (d + 1);
+}
+
+}
+
+template<unsigned int S>
+constexpr uint16_t BasicDistanceField<S>::INF;
+
+template<unsigned int S>
+BasicDistanceField<S>::BasicDistanceField(BasicMaze<S> *maze) : expansions(0), maze(maze), heap_size(0) {
+  for (unsigned int i = 0; i < N; i++) {
+    g[i] = INF;
+    rhs[i] = INF;
+    root[i] = false;
+    heap_index[i] = -1;
+  }
+}
+
+template<unsigned int S>
+void BasicDistanceField<S>::set_root(unsigned int row, unsigned int col) {
+  for (unsigned int i = 0; i < N; i++) {
+    g[i] = INF;
+    rhs[i] = INF;
+    root[i] = false;
+    heap_index[i] = -1;
+  }
+  heap_size = 0;
+  add_root(row, col);
+}
+
+template<unsigned int S>
+void BasicDistanceField<S>::add_root(unsigned int row, unsigned int col) {
+  uint16_t cell = cell_of<S>(row, col);
+  root[cell] = true;
+  update_cell(cell);
+}
+
+template<unsigned int S>
+void BasicDistanceField<S>::walls_changed(unsigned int row, unsigned int col) {
+  // the cell itself and everything that used to be or now is connected to it may have a new rhs
+  update_cell(cell_of<S>(row, col));
+  if (row > 0) {
+    update_cell(cell_of<S>(row - 1, col));
+  }
+  if (row + 1 < S) {
+    update_cell(cell_of<S>(row + 1, col));
+  }
+  if (col > 0) {
+    update_cell(cell_of<S>(row, col - 1));
+  }
+  if (col + 1 < S) {
+    update_cell(cell_of<S>(row, col + 1));
+  }
+}
+
+template<unsigned int S>
+unsigned int BasicDistanceField<S>::repair() {
+  expansions = 0;
+  while (heap_size > 0) {
+    expand(heap_pop());
+    expansions++;
+  }
+  return expansions;
+}
+
+template<unsigned int S>
+bool BasicDistanceField<S>::repair(unsigned int max_expansions) {
+  expansions = 0;
+  while (heap_size > 0 && expansions < max_expansions) {
+    expand(heap_pop());
+    expansions++;
+  }
+  return consistent();
+}
+
+template<unsigned int S>
+bool BasicDistanceField<S>::consistent() const {
+  return heap_size == 0;
+}
+
+template<unsigned int S>
+uint16_t BasicDistanceField<S>::distance(unsigned int row, unsigned int col) const {
+  return g[cell_of<S>(row, col)];
+}
+
+template<unsigned int S>
+Direction BasicDistanceField<S>::next_step(unsigned int row, unsigned int col) const {
+  Node *n = maze->nodes[row][col];
+  uint16_t min_d = g[cell_of<S>(row, col)];
+  Direction min_dir = Direction::INVALID;
+  for (Direction d = Direction::First; d < Direction::Last; d++) {
+    Node *neighbor = n->neighbor(d);
+    if (neighbor != nullptr) {
+      uint16_t neighbor_d = g[cell_of<S>(neighbor->row(), neighbor->col())];
+      if (neighbor_d < min_d) {
+        min_d = neighbor_d;
+        min_dir = d;
+      }
+    }
+  }
+  return min_dir;
+}
+
+template<unsigned int S>
+bool BasicDistanceField<S>::route_to_root(route_t *path, unsigned int row, unsigned int col) const {
+  path->clear();
+  if (g[cell_of<S>(row, col)] == INF) {
+    return false;
+  }
+
+  while (!root[cell_of<S>(row, col)]) {
+    Direction d = next_step(row, col);
+    if (d == Direction::INVALID) {
+      return false;
+    }
+    Node *next = maze->nodes[row][col]->neighbor(d);
+    row = next->row();
+    col = next->col();
+    insert_motion_primitive_back(path, {1, d});
+  }
+  return true;
+}
+
+template<unsigned int S>
+bool BasicDistanceField<S>::route_from_root(route_t *path, unsigned int row, unsigned int col) const {
+  path->clear();
+  if (g[cell_of<S>(row, col)] == INF) {
+    return false;
+  }
+
+  while (!root[cell_of<S>(row, col)]) {
+    Direction d = next_step(row, col);
+    if (d == Direction::INVALID) {
+      return false;
+    }
+    Node *next = maze->nodes[row][col]->neighbor(d);
+    row = next->row();
+    col = next->col();
+    insert_motion_primitive_back(path, {1, opposite_direction(d)});
+  }
+  // we walked from the cell to the root, so the route is backwards
+  std::reverse(path->begin(), path->end());
+  return true;
+}
+
+template<unsigned int S>
+uint16_t BasicDistanceField<S>::key(uint16_t cell) const {
+  return g[cell] < rhs[cell] ? g[cell] : rhs[cell];
+}
+
+template<unsigned int S>
+uint16_t BasicDistanceField<S>::compute_rhs(uint16_t cell) const {
+  if (root[cell]) {
+    return 0;
+  }
+
+  uint16_t min_d = INF;
+  Node *n = maze->nodes[row_of<S>(cell)][col_of<S>(cell)];
+  for (Node *neighbor : n->neighbors) {
+    if (neighbor != nullptr) {
+      uint16_t d = plus_one(g[cell_of<S>(neighbor->row(), neighbor->col())]);
+      if (d < min_d) {
+        min_d = d;
+      }
+    }
+  }
+  return min_d;
+}
+
+template<unsigned int S>
+void BasicDistanceField<S>::update_cell(uint16_t cell) {
+  rhs[cell] = compute_rhs(cell);
+  if (heap_index[cell] >= 0) {
+    heap_remove(cell);
+  }
+  if (g[cell] != rhs[cell]) {
+    heap_push(cell);
+  }
+}
+
+template<unsigned int S>
+void BasicDistanceField<S>::expand(uint16_t cell) {
+  Node *n = maze->nodes[row_of<S>(cell)][col_of<S>(cell)];
+  if (g[cell] > rhs[cell]) {
+    // the cell got closer, settle it and let its neighbors know
+    g[cell] = rhs[cell];
+  } else {
+    // the cell got further away, forget its distance and requeue it along with everything that depended on it
+    g[cell] = INF;
+    update_cell(cell);
+  }
+
+  for (Node *neighbor : n->neighbors) {
+    if (neighbor != nullptr) {
+      update_cell(cell_of<S>(neighbor->row(), neighbor->col()));
+    }
+  }
+}
+
+template<unsigned int S>
+void BasicDistanceField<S>::heap_push(uint16_t cell) {
+  heap[heap_size] = cell;
+  heap_index[cell] = (int16_t) heap_size;
+  heap_size++;
+  sift_up(heap_size - 1);
+}
+
+template<unsigned int S>
+uint16_t BasicDistanceField<S>::heap_pop() {
+  uint16_t top = heap[0];
+  heap_remove(top);
+  return top;
+}
+
+template<unsigned int S>
+void BasicDistanceField<S>::heap_remove(uint16_t cell) {
+  unsigned int i = (unsigned int) heap_index[cell];
+  heap_size--;
+  if (i != heap_size) {
+    heap_swap(i, heap_size);
+    sift_up(i);
+    sift_down(i);
+  }
+  heap_index[cell] = -1;
+}
+
+template<unsigned int S>
+void BasicDistanceField<S>::sift_up(unsigned int i) {
+  while (i > 0) {
+    unsigned int parent = (i - 1) / 2;
+    if (key(heap[i]) >= key(heap[parent])) {
+      break;
+    }
+    heap_swap(i, parent);
+    i = parent;
+  }
+}
+
+template<unsigned int S>
+void BasicDistanceField<S>::sift_down(unsigned int i) {
+  while (true) {
+    unsigned int smallest = i;
+    unsigned int left = 2 * i + 1;
+    unsigned int right = 2 * i + 2;
+    if (left < heap_size && key(heap[left]) < key(heap[smallest])) {
+      smallest = left;
+    }
+    if (right < heap_size && key(heap[right]) < key(heap[smallest])) {
+      smallest = right;
+    }
+    if (smallest == i) {
+      break;
+    }
+    heap_swap(i, smallest);
+    i = smallest;
+  }
+}
+
+template<unsigned int S>
+void BasicDistanceField<S>::heap_swap(unsigned int i, unsigned int j) {
+  uint16_t tmp = heap[i];
+  heap[i] = heap[j];
+  heap[j] = tmp;
+  heap_index[heap[i]] = (int16_t) i;
+  heap_index[heap[j]] = (int16_t) j;
+}
+
+template class BasicDistanceField<8>;
+template class BasicDistanceField<16>;
+template class BasicDistanceField<32>;
+#if SMARTMOUSE_MAZE_SIZE != 8 && SMARTMOUSE_MAZE_SIZE != 16 && SMARTMOUSE_MAZE_SIZE != 32
+template class BasicDistanceField<smartmouse::maze::SIZE>;
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+
+#include "AbstractMaze.h"
+
+/**
+ * \brief persistent shortest distance from every cell to a set of root cells, repaired incrementally.
+ * This is LPA* (without a heuristic, since we want distances for every cell) run backwards from the roots.
+ * When walls around a cell change, call walls_changed() on that cell and then repair(). Only the cells whose
+ * distance actually changes get put on the queue, so a sensor reading that changes a couple walls usually costs
+ * a handful of expansions instead of a full flood fill.
+ *
+ * All storage is fixed size, nothing is allocated after construction.
+ * The field doesn't own the maze, and it doesn't change the node weights the way flood_fill does.
+ * Instantiated in DistanceField.cpp for the same sizes as BasicMaze.
+ */
+template<unsigned int S>
+class BasicDistanceField {
+public:
+  static constexpr uint16_t INF = 0xFFFF;
+
+  BasicDistanceField(BasicMaze<S> *maze);
+
+  /** \brief forget everything and make the given cell the only root. Call repair() afterwards. */
+  void set_root(unsigned int row, unsigned int col);
+
+  /** \brief add another root, so the field measures distance to the closest root. Call repair() afterwards. */
+  void add_root(unsigned int row, unsigned int col);
+
+  /** \brief tell the field that walls around this cell may have been added or removed */
+  void walls_changed(unsigned int row, unsigned int col);
+
+  /** \brief process the queue until every cell has its correct distance
+   * \return the number of cells expanded
+   */
+  unsigned int repair();
+
+  /** \brief process at most max_expansions cells, so planning can be spread over several control cycles
+   * \return true if the field is now consistent
+   */
+  bool repair(unsigned int max_expansions);
+
+  bool consistent() const;
+
+  /** \return the number of cells to the nearest root, or INF if no root is reachable */
+  uint16_t distance(unsigned int row, unsigned int col) const;
+
+  /** \brief the direction of the first step on a shortest path from this cell to a root.
+   * neighbors are checked in the order N, E, S, W, and ties go to the first one, just like flood_fill does.
+   * \return Direction::INVALID if the cell is a root or can't reach one
+   */
+  Direction next_step(unsigned int row, unsigned int col) const;
+
+  /** \brief shortest route from the given cell to the nearest root
+   * \return false if there is no route
+   */
+  bool route_to_root(route_t *path, unsigned int row, unsigned int col) const;
+
+  /** \brief shortest route from the nearest root to the given cell.
+   * This walks back from the cell exactly like flood_fill does, so a field rooted at r0,c0 gives the same route
+   * as flood_fill(path, r0, c0, row, col).
+   * \return false if there is no route
+   */
+  bool route_from_root(route_t *path, unsigned int row, unsigned int col) const;
+
+  /// \brief number of cells expanded during the last call to repair
+  unsigned int expansions;
+
+private:
+  static constexpr unsigned int N = S * S;
+
+  uint16_t key(uint16_t cell) const;
+  uint16_t compute_rhs(uint16_t cell) const;
+  void update_cell(uint16_t cell);
+  void expand(uint16_t cell);
+
+  void heap_push(uint16_t cell);
+  uint16_t heap_pop();
+  void heap_remove(uint16_t cell);
+  void sift_up(unsigned int i);
+  void sift_down(unsigned int i);
+  void heap_swap(unsigned int i, unsigned int j);
+
+  BasicMaze<S> *maze;
+
+  uint16_t g[N];
+  uint16_t rhs[N];
+  bool root[N];
+
+  uint16_t heap[N];
+  int16_t heap_index[N];
+  unsigned int heap_size;
+};
+
+typedef BasicDistanceField<smartmouse::maze::SIZE> DistanceField;
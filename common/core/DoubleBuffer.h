@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+
+/**
+ * \brief hands the latest value of a struct from one writer to one reader without locks.
+ * The writer and reader can be the main loop and a timer interrupt (either way around), or two threads.
+ *
+ * There are two copies of the value. The writer always fills the copy the reader isn't pointed at and then flips
+ * front, so a reader that interrupts a write still gets the last complete value. Each copy also has a sequence number
+ * which is odd while it's being written. On the teensy a reader can only be interrupted by a writer, never the other
+ * way around, and a write never touches the front copy, so a read in an interrupt never has to retry. A reader on
+ * another thread that gets lapped by two writes notices the sequence number changed and reads again.
+ *
+ * Never allocates. Only one context may ever call write.
+ */
+template<typename T>
+class DoubleBuffer {
+  static_assert(std::is_trivially_copyable<T>::value, "DoubleBuffer copies its values as plain memory");
+
+public:
+  DoubleBuffer() : DoubleBuffer(T()) {}
+
+  explicit DoubleBuffer(const T &initial) : data{initial, initial}, seq{{0}, {0}}, front(0) {}
+
+  void write(const T &value) {
+    unsigned int back = 1 - front.load(std::memory_order_relaxed);
+    seq[back].fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    data[back] = value;
+    seq[back].fetch_add(1, std::memory_order_release);
+    front.store(back, std::memory_order_release);
+  }
+
+  /** \brief the last value written, or the initial value if nothing has been written */
+  T read() const {
+    T value;
+    unsigned int before, after;
+    do {
+      unsigned int i = front.load(std::memory_order_acquire);
+      before = seq[i].load(std::memory_order_acquire);
+      value = data[i];
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = seq[i].load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return value;
+  }
+
+private:
+  T data[2];
+  std::atomic<unsigned int> seq[2];
+  std::atomic<unsigned int> front;
+};
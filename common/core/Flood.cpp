@@ -1,6 +1,9 @@
+#include <limits>
+
 #include "Flood.h"
 
-Flood::Flood(Mouse *mouse) : Solver(mouse), done(false), solved(false) {}
+Flood::Flood(Mouse *mouse) : Solver(mouse), done(false), all_wall_maze(mouse->maze),
+                             no_wall_distances(&no_wall_maze), solved(false), sensed(false) {}
 
 //starts at 0, 0 and explores the whole maze
 void Flood::setup() {
@@ -16,14 +19,29 @@ void Flood::setup() {
   all_wall_maze->connect_neighbor(smartmouse::maze::CENTER, smartmouse::maze::CENTER, Direction::N);
   all_wall_maze->connect_neighbor(smartmouse::maze::CENTER - 1, smartmouse::maze::CENTER - 1, Direction::E);
   all_wall_maze->connect_neighbor(smartmouse::maze::CENTER - 1, smartmouse::maze::CENTER - 1, Direction::S);
-  goal = Solver::Goal::CENTER;
+
+  // these are kept up to date as walls are discovered, instead of flood filling from scratch every step
+  no_wall_distances.clear();
+  no_wall_distances.to_center();
+  no_wall_distances.to_start();
+  mouse->distances.clear();
+  mouse->distances.to_start();
+  sensed = false;
+  setGoal(Solver::Goal::CENTER);
 }
 
 void Flood::setGoal(Solver::Goal goal) {
   this->goal = goal;
 }
 
-motion_primitive_t Flood::planNextStep() {
+const DistanceField &Flood::to_goal() {
+  if (goal == Solver::Goal::START) {
+    return no_wall_distances.to_start();
+  }
+  return no_wall_distances.to_center();
+}
+
+void Flood::sense() {
   //mark the nodes visted in both the mazes
   no_wall_maze.mark_position_visited(mouse->getRow(), mouse->getCol());
   all_wall_maze->mark_position_visited(mouse->getRow(), mouse->getCol());
@@ -36,30 +54,45 @@ motion_primitive_t Flood::planNextStep() {
   no_wall_maze.update(sr);
   all_wall_maze->update(sr);
 
-  //solve flood fill on the two mazes from mouse to goal
-  switch (goal) {
-    case Solver::Goal::CENTER: {
-      solvable = no_wall_maze.flood_fill_from_point(&no_wall_path, mouse->getRow(), mouse->getCol(),
-                                                    smartmouse::maze::CENTER, smartmouse::maze::CENTER);
-      //this way commands can see this used to visualize in gazebo
-      mouse->maze->path_to_next_goal = no_wall_path;
-      all_wall_maze->flood_fill_from_point(&all_wall_path, mouse->getRow(), mouse->getCol(), smartmouse::maze::CENTER,
-                                                    smartmouse::maze::CENTER);
-      break;
-    }
-    case Solver::Goal::START: {
-      solvable = no_wall_maze.flood_fill_from_point(&no_wall_path, mouse->getRow(), mouse->getCol(), 0, 0);
-      //this way commands can see this used to visualize in gazebo
-      mouse->maze->path_to_next_goal = no_wall_path;
-      all_wall_maze->flood_fill_from_point(&all_wall_path, mouse->getRow(), mouse->getCol(), 0, 0);
-      break;
-    }
+  //only the cells around this reading can have changed, so queue up repairs of the distances from there
+  no_wall_distances.walls_changed(sr.row, sr.col);
+  mouse->distances.walls_changed(sr.row, sr.col);
+  sensed = true;
+}
+
+bool Flood::planSlice(unsigned int max_expansions) {
+  if (!sensed) {
+    sense();
+  }
+
+  if (!no_wall_distances.repair(max_expansions)) {
+    return false;
   }
+  return mouse->distances.repair(max_expansions - no_wall_distances.expansions);
+}
+
+motion_primitive_t Flood::planNextStep() {
+  if (!sensed) {
+    sense();
+  }
+  sensed = false;
+
+  //finish whatever planSlice didn't get to
+  no_wall_distances.repair(std::numeric_limits<unsigned int>::max());
+  mouse->distances.repair(std::numeric_limits<unsigned int>::max());
+  expansions = no_wall_distances.expansions + mouse->distances.expansions;
+
+  //path from the mouse to the goal, assuming no walls where we haven't looked
+  solvable = to_goal().route_to_root(&no_wall_path, mouse->getRow(), mouse->getCol());
+  //this way commands can see this used to visualize in gazebo
+  mouse->maze->path_to_next_goal = no_wall_path;
 
   //solve from origin to center
   //this is what tells us whether or not we need to keep searching
-  no_wall_maze.flood_fill_from_origin_to_center(&no_wall_maze.fastest_route);
-  all_wall_maze->flood_fill_from_origin_to_center(&all_wall_maze->fastest_route);
+  no_wall_distances.to_start().route_from_root(&no_wall_maze.fastest_route, smartmouse::maze::CENTER,
+                                               smartmouse::maze::CENTER);
+  mouse->distances.to_start().route_from_root(&all_wall_maze->fastest_route, smartmouse::maze::CENTER,
+                                              smartmouse::maze::CENTER);
 
   //this way commands can see this
   //used to visualize in gazebo
@@ -68,6 +101,9 @@ motion_primitive_t Flood::planNextStep() {
   // Walk along the no_wall_path as far as possible in the all_wall_maze
   // This will results in the longest path where we know there are no walls
   route_t nextPath = all_wall_maze->truncate(mouse->getRow(), mouse->getCol(), mouse->getDir(), no_wall_path);
+  if (nextPath.empty()) {
+    return {0, Direction::INVALID};
+  }
   return nextPath.at(0);
 }
 
@@ -9,6 +9,7 @@
 
 #include "Solver.h"
 #include "Mouse.h"
+#include "DistanceCache.h"
 
 class Flood : public Solver {
 
@@ -20,6 +21,9 @@ public:
 
   virtual motion_primitive_t planNextStep() override;
 
+  /** \brief senses the walls on the first call, then repairs the distance fields a few expansions at a time */
+  virtual bool planSlice(unsigned int max_expansions) override;
+
   virtual route_t solve() override;
 
   virtual void teardown() override;
@@ -32,15 +36,28 @@ public:
 
 private:
 
+  /// \brief read the walls around the mouse and queue up the distance repairs they cause
+  void sense();
+
+  /// \brief distance to the current goal in the no wall maze
+  const DistanceField &to_goal();
+
   /// \brief this maze is initially no walls, and walls are filled out every time the mouse moves
   AbstractMaze no_wall_maze;
 
   /// \brief this maze is initially all walls, and walls are removed every time the mouse moves
   AbstractMaze *all_wall_maze;
 
+  /// \brief distances to the center and to the start in the no wall maze. Both are kept up to date the whole time, so
+  /// switching goals doesn't recompute anything. The all wall maze is the mouse's maze, so it uses mouse->distances.
+  /// The distance to the start doubles as the distance from the origin, which gives the fastest route to the center.
+  DistanceCache no_wall_distances;
+
   route_t no_wall_path;
-  route_t all_wall_path;
   Solver::Goal goal;
 
   bool solved;
+
+  /// \brief whether the walls for the next step have been read, but the step hasn't been planned yet
+  bool sensed;
 };
@@ -0,0 +1,250 @@
+#ifndef ARDUINO
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MazeFile.h"
+
+namespace {
+
+const char MAGIC[4] = {'S', 'M', 'Z', 'B'};
+
+inline bool get_bit(const uint8_t *bits, unsigned int i) {
+  return (bits[i / 8] >> (i % 8)) & 1;
+}
+
+inline void set_bit(uint8_t *bits, unsigned int i) {
+  bits[i / 8] |= (uint8_t) (1 << (i % 8));
+}
+
+}
+
+static_assert(sizeof(MazeFileHeader) == 16, "the maze file header must not be padded");
+static_assert(sizeof(BasicMazeRecord<8>) == 52, "maze records must not be padded");
+static_assert(sizeof(BasicMazeRecord<16>) == 100, "maze records must not be padded");
+static_assert(sizeof(BasicMazeRecord<32>) == 292, "maze records must not be padded");
+
+constexpr uint16_t MazeFileHeader::VERSION;
+
+template<unsigned int S>
+constexpr uint16_t BasicMazeRecord<S>::NO_ROUTE;
+
+template<unsigned int S>
+BasicMazeRecord<S> BasicMazeRecord<S>::from_maze(BasicMaze<S> *maze, const std::string &name) {
+  BasicMazeRecord record;
+  memset(&record, 0, sizeof(record));
+  memcpy(record.name, name.data(), std::min<size_t>(name.size(), NAME_SIZE));
+  record.size = S;
+
+  BasicWallGrid<S> grid(maze);
+  for (unsigned int i = 0; i < S; i++) {
+    for (unsigned int j = 0; j < S; j++) {
+      if (grid.is_wall(i, j, Direction::S)) {
+        set_bit(record.south_walls, i * S + j);
+      }
+      if (grid.is_wall(i, j, Direction::E)) {
+        set_bit(record.east_walls, i * S + j);
+      }
+    }
+  }
+
+  route_t route;
+  record.route_length = NO_ROUTE;
+  if (grid.flood_fill_from_origin_to_center(&route)) {
+    unsigned int length = 0;
+    for (motion_primitive_t prim : route) {
+      length += prim.n;
+    }
+    record.route_length = (uint16_t) length;
+  }
+  return record;
+}
+
+template<unsigned int S>
+std::string BasicMazeRecord<S>::get_name() const {
+  return std::string(name, strnlen(name, NAME_SIZE));
+}
+
+template<unsigned int S>
+bool BasicMazeRecord<S>::is_wall(unsigned int row, unsigned int col, const Direction dir) const {
+  switch (dir) {
+    case Direction::N:
+      return row == 0 || get_bit(south_walls, (row - 1) * S + col);
+    case Direction::E:
+      return col == S - 1 || get_bit(east_walls, row * S + col);
+    case Direction::S:
+      return row == S - 1 || get_bit(south_walls, row * S + col);
+    case Direction::W:
+      return col == 0 || get_bit(east_walls, row * S + col - 1);
+    default:
+      return true;
+  }
+}
+
+template<unsigned int S>
+BasicWallGrid<S> BasicMazeRecord<S>::to_wall_grid() const {
+  BasicWallGrid<S> grid;
+  for (unsigned int i = 0; i < S; i++) {
+    for (unsigned int j = 0; j < S; j++) {
+      if (!is_wall(i, j, Direction::S)) {
+        grid.connect_neighbor(i, j, Direction::S);
+      }
+      if (!is_wall(i, j, Direction::E)) {
+        grid.connect_neighbor(i, j, Direction::E);
+      }
+    }
+  }
+  return grid;
+}
+
+template<unsigned int S>
+void BasicMazeRecord<S>::to_abstract_maze(BasicMaze<S> *maze) const {
+  to_wall_grid().to_abstract_maze(maze);
+}
+
+template<unsigned int S>
+BasicMazeFile<S>::BasicMazeFile() : data(nullptr), length(0), maze_count(0) {}
+
+template<unsigned int S>
+BasicMazeFile<S>::~BasicMazeFile() {
+  close();
+}
+
+template<unsigned int S>
+bool BasicMazeFile<S>::open(const std::string &path) {
+  close();
+
+#ifdef _WIN32
+  std::ifstream fs(path, std::ifstream::in | std::ifstream::binary);
+  if (!fs.good()) {
+    return false;
+  }
+  buffer.assign(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+  data = buffer.data();
+  length = buffer.size();
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+  void *mapping = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping keeps the file open on its own
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  data = (const uint8_t *) mapping;
+  length = (size_t) st.st_size;
+#endif
+
+  MazeFileHeader header;
+  if (length < sizeof(header)) {
+    close();
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  bool valid = memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == MazeFileHeader::VERSION
+               && header.maze_size == S && header.record_size == sizeof(BasicMazeRecord<S>)
+               && length >= sizeof(header) + (size_t) header.count * sizeof(BasicMazeRecord<S>);
+  if (!valid) {
+    close();
+    return false;
+  }
+  maze_count = header.count;
+  return true;
+}
+
+template<unsigned int S>
+void BasicMazeFile<S>::close() {
+#ifdef _WIN32
+  buffer.clear();
+#else
+  if (data != nullptr) {
+    munmap((void *) data, length);
+  }
+#endif
+  data = nullptr;
+  length = 0;
+  maze_count = 0;
+}
+
+template<unsigned int S>
+unsigned int BasicMazeFile<S>::count() const {
+  return maze_count;
+}
+
+template<unsigned int S>
+const BasicMazeRecord<S> &BasicMazeFile<S>::operator[](unsigned int i) const {
+  // records are all multiples of 2 bytes and the header is 16, so every record is aligned for its uint16_t fields
+  return *(const BasicMazeRecord<S> *) (data + sizeof(MazeFileHeader) + (size_t) i * sizeof(BasicMazeRecord<S>));
+}
+
+template<unsigned int S>
+BasicMazeFileWriter<S>::BasicMazeFileWriter() : maze_count(0) {}
+
+template<unsigned int S>
+BasicMazeFileWriter<S>::~BasicMazeFileWriter() {
+  if (fs.is_open()) {
+    close();
+  }
+}
+
+template<unsigned int S>
+bool BasicMazeFileWriter<S>::open(const std::string &path) {
+  fs.open(path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+  if (!fs.good()) {
+    return false;
+  }
+  maze_count = 0;
+  // the count gets filled in at the end
+  MazeFileHeader header = {{MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3]}, MazeFileHeader::VERSION, S, 0,
+                           sizeof(BasicMazeRecord<S>)};
+  fs.write((const char *) &header, sizeof(header));
+  return fs.good();
+}
+
+template<unsigned int S>
+void BasicMazeFileWriter<S>::add(const BasicMazeRecord<S> &record) {
+  fs.write((const char *) &record, sizeof(record));
+  maze_count++;
+}
+
+template<unsigned int S>
+bool BasicMazeFileWriter<S>::close() {
+  fs.seekp(offsetof(MazeFileHeader, count));
+  fs.write((const char *) &maze_count, sizeof(maze_count));
+  bool good = fs.good();
+  fs.close();
+  return good;
+}
+
+template struct BasicMazeRecord<8>;
+template struct BasicMazeRecord<16>;
+template struct BasicMazeRecord<32>;
+template class BasicMazeFile<8>;
+template class BasicMazeFile<16>;
+template class BasicMazeFile<32>;
+template class BasicMazeFileWriter<8>;
+template class BasicMazeFileWriter<16>;
+template class BasicMazeFileWriter<32>;
+#if SMARTMOUSE_MAZE_SIZE != 8 && SMARTMOUSE_MAZE_SIZE != 16 && SMARTMOUSE_MAZE_SIZE != 32
+template struct BasicMazeRecord<smartmouse::maze::SIZE>;
+template class BasicMazeFile<smartmouse::maze::SIZE>;
+template class BasicMazeFileWriter<smartmouse::maze::SIZE>;
+#endif
+
+#endif
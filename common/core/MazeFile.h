@@ -0,0 +1,120 @@
+#pragma once
+
+#ifndef ARDUINO // there's no file system on the robot
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "AbstractMaze.h"
+#include "WallGrid.h"
+
+/**
+ * \brief one maze in a maze file: its walls as two fixed size bitsets, plus a name and the length of its shortest
+ * route from the origin to the center. The bits are laid out like WallGrid, bit row * S + col of south_walls is the
+ * wall on the south side of that cell, and the outside edge is always a wall.
+ *
+ * Records are plain bytes with no padding and no pointers, so a MazeFile hands out pointers straight into the file.
+ */
+template<unsigned int S>
+struct BasicMazeRecord {
+  static constexpr unsigned int NAME_SIZE = 32;
+  static constexpr unsigned int WALL_BYTES = (S * S + 7) / 8;
+  static constexpr uint16_t NO_ROUTE = 0xFFFF;
+
+  /// NUL padded, and not NUL terminated if the name is exactly NAME_SIZE long
+  char name[NAME_SIZE];
+  uint16_t size;
+  /// cells on the shortest route from the origin to the center, or NO_ROUTE if there isn't one
+  uint16_t route_length;
+  uint8_t south_walls[WALL_BYTES];
+  uint8_t east_walls[WALL_BYTES];
+
+  /** \brief copy the walls out of a maze and work out its route length. Names longer than NAME_SIZE are cut off */
+  static BasicMazeRecord from_maze(BasicMaze<S> *maze, const std::string &name);
+
+  std::string get_name() const;
+
+  bool is_wall(unsigned int row, unsigned int col, const Direction dir) const;
+
+  BasicWallGrid<S> to_wall_grid() const;
+
+  /** \brief write our walls into a node based maze, replacing all of its connections */
+  void to_abstract_maze(BasicMaze<S> *maze) const;
+};
+
+/// \brief the first bytes of a maze file. Everything in the file is little endian
+struct MazeFileHeader {
+  static constexpr uint16_t VERSION = 1;
+
+  /// always "SMZB"
+  char magic[4];
+  uint16_t version;
+  uint16_t maze_size;
+  uint32_t count;
+  /// sizeof(BasicMazeRecord<maze_size>), so readers can check they agree on the layout
+  uint32_t record_size;
+};
+
+/**
+ * \brief reads a maze file, which is a MazeFileHeader followed by count records back to back.
+ * The file is memory mapped, so opening it doesn't read it, and getting a maze is just pointer arithmetic.
+ * Nothing is allocated per maze. On Windows the whole file is read into one buffer instead.
+ * Instantiated in MazeFile.cpp for the same sizes as BasicMaze.
+ */
+template<unsigned int S>
+class BasicMazeFile {
+public:
+  BasicMazeFile();
+
+  ~BasicMazeFile();
+
+  BasicMazeFile(const BasicMazeFile &) = delete;
+
+  BasicMazeFile &operator=(const BasicMazeFile &) = delete;
+
+  /** \return false if the file can't be read, isn't a maze file, or holds mazes of a different size */
+  bool open(const std::string &path);
+
+  void close();
+
+  unsigned int count() const;
+
+  /** \brief the record for maze i, which stays valid until the file is closed */
+  const BasicMazeRecord<S> &operator[](unsigned int i) const;
+
+private:
+  const uint8_t *data;
+  size_t length;
+  unsigned int maze_count;
+#ifdef _WIN32
+  std::vector<uint8_t> buffer;
+#endif
+};
+
+/** \brief writes a maze file one record at a time. The count in the header is filled in by close() */
+template<unsigned int S>
+class BasicMazeFileWriter {
+public:
+  BasicMazeFileWriter();
+
+  ~BasicMazeFileWriter();
+
+  bool open(const std::string &path);
+
+  void add(const BasicMazeRecord<S> &record);
+
+  /** \return false if anything failed to write */
+  bool close();
+
+private:
+  std::ofstream fs;
+  uint32_t maze_count;
+};
+
+typedef BasicMazeRecord<smartmouse::maze::SIZE> MazeRecord;
+typedef BasicMazeFile<smartmouse::maze::SIZE> MazeFile;
+typedef BasicMazeFileWriter<smartmouse::maze::SIZE> MazeFileWriter;
+
+#endif
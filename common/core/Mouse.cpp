@@ -2,15 +2,18 @@
 #include "common/core/util.h"
 #include "Mouse.h"
 
-Mouse::Mouse() : maze(new AbstractMaze()), row(0), col(0), dir(Direction::E) {}
+Mouse::Mouse() : maze(new AbstractMaze()), distances(maze), row(0), col(0), dir(Direction::E) {}
 
-Mouse::Mouse(unsigned int starting_row, unsigned int starting_col) : maze(new AbstractMaze()), row(starting_row), col(starting_col),
-                                                   dir(Direction::E) {}
+Mouse::Mouse(unsigned int starting_row, unsigned int starting_col) : maze(new AbstractMaze()), distances(maze),
+                                                                     row(starting_row), col(starting_col),
+                                                                     dir(Direction::E) {}
 
-Mouse::Mouse(AbstractMaze *maze) : maze(maze), row(0), col(0), dir(Direction::E) {}
+Mouse::Mouse(AbstractMaze *maze) : maze(maze), distances(maze), row(0), col(0), dir(Direction::E) {}
 
-Mouse::Mouse(AbstractMaze *maze, unsigned int starting_row, unsigned int starting_col) : maze(maze), row(starting_row), col(starting_col),
-                                                                       dir(Direction::E) {}
+Mouse::Mouse(AbstractMaze *maze, unsigned int starting_row, unsigned int starting_col) : maze(maze), distances(maze),
+                                                                                         row(starting_row),
+                                                                                         col(starting_col),
+                                                                                         dir(Direction::E) {}
 
 void Mouse::reset() {
   row = 0;
@@ -3,6 +3,7 @@
 #include <math.h>
 #include "common/core/Direction.h"
 #include "common/core/AbstractMaze.h"
+#include "common/core/DistanceCache.h"
 #include "common/core/Pose.h"
 
 typedef struct {
@@ -78,6 +79,9 @@ public:
 
   AbstractMaze *maze;
 
+  /// \brief distances to the goals in maze. Whatever changes the walls of maze should report it here
+  DistanceCache distances;
+
   virtual GlobalPose getGlobalPose() = 0;
   virtual LocalPose getLocalPose() = 0;
 
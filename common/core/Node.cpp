@@ -34,7 +34,7 @@ unsigned int Node::col() {
 }
 
 
-void Node::assign_weights_to_neighbors(Node *goal, int weight, bool *success) {
+void Node::assign_weights_to_neighbors(Node *goal, int weight, bool *success, unsigned int *visits) {
   //check all nodes that are unvisited, or would be given a lower weight
   if (!this->known || weight < this->weight) {
     //don't visit it again unless you find a shorter path
@@ -47,12 +47,15 @@ void Node::assign_weights_to_neighbors(Node *goal, int weight, bool *success) {
 
     //update weight
     this->weight = weight;
+    if (visits) {
+      (*visits)++;
+    }
 
     //recursive call to explore each neighbors
     int i;
     for (i = 0; i < 4; i++) {
       if (this->neighbors[i] != 0) {
-        this->neighbors[i]->assign_weights_to_neighbors(goal, weight + 1, success);
+        this->neighbors[i]->assign_weights_to_neighbors(goal, weight + 1, success, visits);
       }
     }
   }
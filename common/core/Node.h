@@ -36,7 +36,10 @@ public:
 
   bool wall(const Direction dir);
 
-  void assign_weights_to_neighbors(Node *goal, int weight, bool *success);
+  /** \brief recursive depth first flood fill.
+   * \param visits if not null, incremented every time a node is (re)assigned a weight
+   */
+  void assign_weights_to_neighbors(Node *goal, int weight, bool *success, unsigned int *visits = nullptr);
 
 private:
   unsigned int r;
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * \brief fixed capacity FIFO queue. Never allocates, so it's safe to use on the teensy.
+ * push on a full buffer and pop on an empty buffer are refused and return false.
+ */
+template<typename T, std::size_t N>
+class RingBuffer {
+public:
+  RingBuffer() : head(0), count(0) {}
+
+  bool push(const T &value) {
+    if (count == N) {
+      return false;
+    }
+    data[(head + count) % N] = value;
+    count++;
+    return true;
+  }
+
+  bool pop(T *out) {
+    if (count == 0) {
+      return false;
+    }
+    *out = data[head];
+    head = (head + 1) % N;
+    count--;
+    return true;
+  }
+
+  void clear() {
+    head = 0;
+    count = 0;
+  }
+
+  std::size_t size() const {
+    return count;
+  }
+
+  bool empty() const {
+    return count == 0;
+  }
+
+  bool full() const {
+    return count == N;
+  }
+
+  static constexpr std::size_t capacity() {
+    return N;
+  }
+
+private:
+  T data[N];
+  std::size_t head;
+  std::size_t count;
+};
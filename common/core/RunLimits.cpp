@@ -0,0 +1,31 @@
+#include <cmath>
+
+#include "RunLimits.h"
+
+#if !defined M_PI
+#define M_PI 3.14159265358979
+#endif
+
+double RunLimits::straight_time(double length, bool diagonal, bool from_rest) const {
+  double a = a_max;
+  double v0 = from_rest ? 0 : v_turn;
+  double v1 = v_turn;
+  double vm = std::fmax(diagonal ? v_max_diagonal : v_max, v1);
+
+  double d_up = (vm * vm - v0 * v0) / (2 * a);
+  double d_down = (vm * vm - v1 * v1) / (2 * a);
+  if (d_up + d_down <= length) {
+    return (vm - v0) / a + (vm - v1) / a + (length - d_up - d_down) / vm;
+  }
+
+  // a triangle, if there's room to get back up to v_turn at all
+  double v_peak = sqrt((2 * a * length + v0 * v0 + v1 * v1) / 2);
+  if (v_peak >= v1) {
+    return (v_peak - v0) / a + (v_peak - v1) / a;
+  }
+  return (sqrt(v0 * v0 + 2 * a * length) - v0) / a;
+}
+
+double RunLimits::turn_time(unsigned int steps) const {
+  return steps * (M_PI / 4) * turn_radius / v_turn;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+/**
+ * \brief how fast the mouse drives a speed run, in cells and seconds. These are the speed run planners' edge costs,
+ * so they should come from what the robot actually manages, see RobotConfig.h
+ */
+struct RunLimits {
+  /// top speed on straights between cell centers
+  double v_max;
+  /// top speed on diagonals, which have much less room on either side
+  double v_max_diagonal;
+  double a_max;
+  /// every straight starts and ends at this speed, except the first which starts from rest
+  double v_turn;
+  /// turns are arcs of this radius taken at v_turn
+  double turn_radius;
+
+  /** \brief seconds to drive a straight of this many cells, speeding up towards the top speed and back down to v_turn
+   * by the end of it
+   */
+  double straight_time(double length, bool diagonal, bool from_rest) const;
+
+  /** \brief seconds to turn through this many 45 degree steps */
+  double turn_time(unsigned int steps) const;
+};
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "RunPlanner.h"
+
+namespace {
+
+constexpr float UNREACHED = 1e30f;
+
+}
+
+template<unsigned int S>
+BasicRunPlanner<S>::BasicRunPlanner(BasicMaze<S> *maze, RunLimits limits)
+    : expansions(0), maze(maze), limits(limits), heap_size(0) {}
+
+template<unsigned int S>
+bool BasicRunPlanner<S>::plan(route_t *route, unsigned int r0, unsigned int c0, Direction start_dir, unsigned int r1,
+                              unsigned int c1) {
+  route->clear();
+  for (unsigned int i = 0; i < STATES; i++) {
+    cost[i] = UNREACHED;
+    parent[i] = -1;
+    closed[i] = false;
+    heap_index[i] = -1;
+  }
+  heap_size = 0;
+  expansions = 0;
+
+  uint16_t start = (uint16_t) ((r0 * S + c0) * DIRECTIONS + (unsigned int) start_dir);
+  unsigned int goal_cell = r1 * S + c1;
+  cost[start] = 0;
+  heap_push(start);
+
+  while (heap_size > 0) {
+    uint16_t state = heap_pop();
+    closed[state] = true;
+    expansions++;
+
+    unsigned int cell = state / DIRECTIONS;
+    Direction dir = (Direction) (state % DIRECTIONS);
+    unsigned int row = cell / S;
+    unsigned int col = cell % S;
+
+    if (cell == goal_cell) {
+      // walk back to the start collecting runs, then put them in driving order
+      while (state != start) {
+        uint16_t prev = (uint16_t) parent[state];
+        unsigned int prev_cell = prev / DIRECTIONS;
+        unsigned int n = (unsigned int) std::abs((int) (cell / S) - (int) (prev_cell / S))
+                         + (unsigned int) std::abs((int) (cell % S) - (int) (prev_cell % S));
+        insert_motion_primitive_back(route, {(uint8_t) n, (Direction) (state % DIRECTIONS)});
+        state = prev;
+        cell = prev_cell;
+      }
+      std::reverse(route->begin(), route->end());
+      return true;
+    }
+
+    for (Direction d = Direction::First; d < Direction::Last; d++) {
+      unsigned int steps = heading_steps(dir_to_heading(dir), dir_to_heading(d));
+      // turning around is only worth it at the start, and going on in the same direction is the same run
+      if ((steps == 4 || steps == 0) && state != start) {
+        continue;
+      }
+
+      float base = cost[state] + (float) limits.turn_time(steps);
+      Node *n = maze->nodes[row][col];
+      for (unsigned int k = 1; (n = n->neighbor(d)) != nullptr; k++) {
+        uint16_t next = (uint16_t) ((n->row() * S + n->col()) * DIRECTIONS + (unsigned int) d);
+        relax(state, next, base + (float) limits.straight_time(k, false, state == start));
+      }
+    }
+  }
+
+  return false;
+}
+
+template<unsigned int S>
+void BasicRunPlanner<S>::set_limits(RunLimits limits) {
+  this->limits = limits;
+}
+
+template<unsigned int S>
+double BasicRunPlanner<S>::route_time(const route_t &route, Direction start_dir) const {
+  Heading h = dir_to_heading(start_dir);
+  double t = 0;
+  bool first = true;
+  for (motion_primitive_t prim : route) {
+    t += limits.turn_time(heading_steps(h, dir_to_heading(prim.d))) + limits.straight_time(prim.n, false, first);
+    h = dir_to_heading(prim.d);
+    first = false;
+  }
+  return t;
+}
+
+template<unsigned int S>
+void BasicRunPlanner<S>::relax(uint16_t from, uint16_t to, float new_cost) {
+  if (closed[to] || new_cost >= cost[to]) {
+    return;
+  }
+  cost[to] = new_cost;
+  parent[to] = (int16_t) from;
+  if (heap_index[to] < 0) {
+    heap_push(to);
+  } else {
+    sift_up((unsigned int) heap_index[to]);
+  }
+}
+
+template<unsigned int S>
+void BasicRunPlanner<S>::heap_push(uint16_t state) {
+  heap[heap_size] = state;
+  heap_index[state] = (int16_t) heap_size;
+  heap_size++;
+  sift_up(heap_size - 1);
+}
+
+template<unsigned int S>
+uint16_t BasicRunPlanner<S>::heap_pop() {
+  uint16_t top = heap[0];
+  heap_size--;
+  if (heap_size > 0) {
+    heap_swap(0, heap_size);
+    sift_down(0);
+  }
+  heap_index[top] = -1;
+  return top;
+}
+
+template<unsigned int S>
+void BasicRunPlanner<S>::sift_up(unsigned int i) {
+  while (i > 0) {
+    unsigned int parent_i = (i - 1) / 2;
+    if (cost[heap[i]] >= cost[heap[parent_i]]) {
+      break;
+    }
+    heap_swap(i, parent_i);
+    i = parent_i;
+  }
+}
+
+template<unsigned int S>
+void BasicRunPlanner<S>::sift_down(unsigned int i) {
+  while (true) {
+    unsigned int smallest = i;
+    unsigned int left = 2 * i + 1;
+    unsigned int right = 2 * i + 2;
+    if (left < heap_size && cost[heap[left]] < cost[heap[smallest]]) {
+      smallest = left;
+    }
+    if (right < heap_size && cost[heap[right]] < cost[heap[smallest]]) {
+      smallest = right;
+    }
+    if (smallest == i) {
+      break;
+    }
+    heap_swap(i, smallest);
+    i = smallest;
+  }
+}
+
+template<unsigned int S>
+void BasicRunPlanner<S>::heap_swap(unsigned int i, unsigned int j) {
+  uint16_t tmp = heap[i];
+  heap[i] = heap[j];
+  heap[j] = tmp;
+  heap_index[heap[i]] = (int16_t) i;
+  heap_index[heap[j]] = (int16_t) j;
+}
+
+template class BasicRunPlanner<8>;
+template class BasicRunPlanner<16>;
+template class BasicRunPlanner<32>;
+#if SMARTMOUSE_MAZE_SIZE != 8 && SMARTMOUSE_MAZE_SIZE != 16 && SMARTMOUSE_MAZE_SIZE != 32
+template class BasicRunPlanner<smartmouse::maze::SIZE>;
+#endif
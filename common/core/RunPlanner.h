@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+#include "AbstractMaze.h"
+#include "RunLimits.h"
+
+/**
+ * \brief the quickest route between two cells for the four direction commands, where flood_fill finds the one with
+ * the fewest cells. A staircase of short straights can be fewer cells than a detour down one long straight, but the
+ * mouse never gets up to speed on it and pays for every turn.
+ *
+ * A search state is a cell and the direction the mouse is facing in it, and each edge is a turn followed by a whole
+ * straight run, costed with the same RunLimits as BasicDiagonalPlanner. Walls that aren't open are walls, so plan on
+ * the maze the mouse explored and unknown walls count as there.
+ *
+ * There are only S*S*4 states, so unlike BasicDiagonalPlanner all the storage is fixed size and it fits on the
+ * robot. Instantiated in RunPlanner.cpp for the same sizes as BasicMaze.
+ */
+template<unsigned int S>
+class BasicRunPlanner {
+public:
+  BasicRunPlanner(BasicMaze<S> *maze, RunLimits limits);
+
+  /**
+   * \brief the quickest route from r0,c0 to r1,c1, starting at rest facing start_dir
+   * \return false if there is no route
+   */
+  bool plan(route_t *route, unsigned int r0, unsigned int c0, Direction start_dir, unsigned int r1, unsigned int c1);
+
+  /** \brief use new costs from the next plan on, for when the robot's speed limits are changed at run time */
+  void set_limits(RunLimits limits);
+
+  /** \brief how long any route takes with the planner's costs, starting from rest facing start_dir */
+  double route_time(const route_t &route, Direction start_dir) const;
+
+  /// \brief number of states taken off the queue during the last plan
+  unsigned int expansions;
+
+private:
+  static constexpr unsigned int DIRECTIONS = 4;
+  static constexpr unsigned int STATES = S * S * DIRECTIONS;
+
+  void relax(uint16_t from, uint16_t to, float cost);
+
+  void heap_push(uint16_t state);
+  uint16_t heap_pop();
+  void sift_up(unsigned int i);
+  void sift_down(unsigned int i);
+  void heap_swap(unsigned int i, unsigned int j);
+
+  BasicMaze<S> *maze;
+  RunLimits limits;
+
+  float cost[STATES];
+  int16_t parent[STATES];
+  bool closed[STATES];
+  uint16_t heap[STATES];
+  int16_t heap_index[STATES];
+  unsigned int heap_size;
+};
+
+typedef BasicRunPlanner<smartmouse::maze::SIZE> RunPlanner;
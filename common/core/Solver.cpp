@@ -1,7 +1,58 @@
+#include <cctype>
+
 #include "Solver.h"
+#include "AStar.h"
+#include "Flood.h"
+#include "WallFollow.h"
+
+constexpr Solver::Type Solver::TYPES[];
+
+Solver::Solver(Mouse *mouse) : solvable(true), mouse(mouse), expansions(0) {}
+
+Solver *Solver::make(Type type, Mouse *mouse) {
+  switch (type) {
+    case Type::FLOOD:
+      return new Flood(mouse);
+    case Type::ASTAR:
+      return new AStar(mouse);
+    case Type::WALL_FOLLOW:
+      return new WallFollow(mouse);
+  }
+  return nullptr;
+}
 
-Solver::Solver(Mouse *mouse) : solvable(true), mouse(mouse) {}
+const char *Solver::name(Type type) {
+  switch (type) {
+    case Type::FLOOD:
+      return "Flood";
+    case Type::ASTAR:
+      return "AStar";
+    case Type::WALL_FOLLOW:
+      return "WallFollow";
+  }
+  return "";
+}
+
+bool Solver::parseType(const char *name, Type *type) {
+  for (Type t : TYPES) {
+    const char *a = name;
+    const char *b = Solver::name(t);
+    while (*a && *b && tolower(*a) == tolower(*b)) {
+      a++;
+      b++;
+    }
+    if (*a == '\0' && *b == '\0') {
+      *type = t;
+      return true;
+    }
+  }
+  return false;
+}
 
 bool Solver::isSolvable() {
   return solvable;
 }
+
+bool Solver::planSlice(unsigned int max_expansions) {
+  return true;
+}
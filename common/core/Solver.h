@@ -10,12 +10,41 @@ public:
     START
   };
 
+  /// \brief the solvers programs can pick from
+  enum class Type {
+    FLOOD,
+    ASTAR,
+    WALL_FOLLOW
+  };
+
+  static constexpr Type TYPES[] = {Type::FLOOD, Type::ASTAR, Type::WALL_FOLLOW};
+
   Solver(Mouse *mouse);
 
+  virtual ~Solver() = default;
+
+  /** \brief a new solver of the given type for the mouse */
+  static Solver *make(Type type, Mouse *mouse);
+
+  /** \brief the name programs print, and take on the command line */
+  static const char *name(Type type);
+
+  /** \brief the type with the given name, ignoring case
+   * \return false if there isn't one
+   */
+  static bool parseType(const char *name, Type *type);
+
   virtual void setup() = 0;
 
   virtual motion_primitive_t planNextStep() = 0;
 
+  /** \brief do at most max_expansions worth of the work for the next planNextStep, so commands can spread planning
+   * over several control cycles. Keep calling it until it returns true, then call planNextStep.
+   * Solvers that can't split their work up just leave it all for planNextStep.
+   * \return true once planNextStep has nothing left to do but pick the step
+   */
+  virtual bool planSlice(unsigned int max_expansions);
+
   virtual bool isFinished() = 0;
 
   virtual route_t solve() = 0;
@@ -28,4 +57,7 @@ public:
 
   bool solvable;
   Mouse *mouse;
+
+  /// \brief cells the last planNextStep expanded, for comparing solvers. Solvers that don't search leave it at 0
+  unsigned int expansions;
 };
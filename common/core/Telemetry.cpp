@@ -0,0 +1,212 @@
+#include <cstring>
+#include <common/core/Telemetry.h>
+
+constexpr unsigned int TelemetryRecord::MAX_VALUES;
+constexpr unsigned int TelemetryRing::CAPACITY_BYTES;
+
+static_assert((TelemetryRing::CAPACITY_BYTES & (TelemetryRing::CAPACITY_BYTES - 1)) == 0,
+              "TelemetryRing indexes with a mask");
+
+const char *telemetry_kind_name(TelemetryKind kind) {
+  switch (kind) {
+    case TelemetryKind::PHASE:
+      return "Phase";
+    case TelemetryKind::RANGE:
+      return "Range";
+    case TelemetryKind::POSE:
+      return "Pose";
+    case TelemetryKind::PID:
+      return "PID";
+    case TelemetryKind::DROPPED:
+      return "Dropped";
+    default:
+      return "Unknown";
+  }
+}
+
+const char *loop_phase_name(LoopPhase phase) {
+  switch (phase) {
+    case LoopPhase::SENSORS:
+      return "Sensors";
+    case LoopPhase::KC:
+      return "KC";
+    case LoopPhase::MOTORS:
+      return "Motors";
+    case LoopPhase::SCHEDULE:
+      return "Schedule";
+    default:
+      return "Unknown";
+  }
+}
+
+namespace {
+
+void put_u32(uint32_t value, uint8_t *out) {
+  out[0] = (uint8_t) value;
+  out[1] = (uint8_t) (value >> 8);
+  out[2] = (uint8_t) (value >> 16);
+  out[3] = (uint8_t) (value >> 24);
+}
+
+uint32_t get_u32(const uint8_t *in) {
+  return (uint32_t) in[0] | ((uint32_t) in[1] << 8) | ((uint32_t) in[2] << 16) | ((uint32_t) in[3] << 24);
+}
+
+uint8_t checksum(const uint8_t *frame, unsigned int length) {
+  uint8_t sum = 0;
+  for (unsigned int i = 2; i < length; i++) {
+    sum += frame[i];
+  }
+  return sum;
+}
+
+}
+
+unsigned int telemetry_frame::encode(const TelemetryRecord &record, uint8_t *out) {
+  uint8_t count = record.count < TelemetryRecord::MAX_VALUES ? record.count : (uint8_t) TelemetryRecord::MAX_VALUES;
+  out[0] = SYNC0;
+  out[1] = SYNC1;
+  out[2] = (uint8_t) record.kind;
+  out[3] = record.id;
+  out[4] = count;
+  put_u32(record.t_us, out + 5);
+  unsigned int length = HEADER_BYTES;
+  for (unsigned int i = 0; i < count; i++) {
+    uint32_t bits;
+    memcpy(&bits, &record.values[i], sizeof(bits));
+    put_u32(bits, out + length);
+    length += 4;
+  }
+  out[length] = checksum(out, length);
+  return length + 1;
+}
+
+TelemetryRing::TelemetryRing() : head(0), tail(0), total_dropped(0), unreported_drops(0) {}
+
+bool TelemetryRing::push(TelemetryKind kind, uint8_t id, uint32_t t_us, const float *values, uint8_t count) {
+  if (unreported_drops > 0) {
+    TelemetryRecord dropped_record = {t_us, TelemetryKind::DROPPED, 0, 1, {(float) unreported_drops}};
+    if (!pushFrame(dropped_record)) {
+      unreported_drops++;
+      total_dropped++;
+      return false;
+    }
+    unreported_drops = 0;
+  }
+
+  TelemetryRecord record = {t_us, kind, id, count, {}};
+  for (unsigned int i = 0; i < count && i < TelemetryRecord::MAX_VALUES; i++) {
+    record.values[i] = values[i];
+  }
+  if (!pushFrame(record)) {
+    unreported_drops++;
+    total_dropped++;
+    return false;
+  }
+  return true;
+}
+
+bool TelemetryRing::phase(LoopPhase phase, uint32_t t_us, uint32_t duration_us) {
+  float value = (float) duration_us;
+  return push(TelemetryKind::PHASE, (uint8_t) phase, t_us, &value, 1);
+}
+
+bool TelemetryRing::range(uint32_t t_us, const RangeData &range_data) {
+  float values[] = {(float) range_data.gerald_left, (float) range_data.gerald_right, (float) range_data.front_left,
+                    (float) range_data.front_right, (float) range_data.back_left, (float) range_data.back_right,
+                    (float) range_data.front};
+  return push(TelemetryKind::RANGE, 0, t_us, values, 7);
+}
+
+bool TelemetryRing::pose(uint32_t t_us, const GlobalPose &pose) {
+  float values[] = {(float) pose.col, (float) pose.row, (float) pose.yaw};
+  return push(TelemetryKind::POSE, 0, t_us, values, 3);
+}
+
+bool TelemetryRing::pushFrame(const TelemetryRecord &record) {
+  uint8_t frame[telemetry_frame::MAX_BYTES];
+  unsigned int length = telemetry_frame::encode(record, frame);
+
+  unsigned int h = head.load(std::memory_order_relaxed);
+  unsigned int t = tail.load(std::memory_order_acquire);
+  if (CAPACITY_BYTES - (h - t) < length) {
+    return false;
+  }
+  for (unsigned int i = 0; i < length; i++) {
+    bytes[(h + i) & (CAPACITY_BYTES - 1)] = frame[i];
+  }
+  head.store(h + length, std::memory_order_release);
+  return true;
+}
+
+unsigned int TelemetryRing::drain(uint8_t *out, unsigned int max_bytes) {
+  unsigned int t = tail.load(std::memory_order_relaxed);
+  unsigned int h = head.load(std::memory_order_acquire);
+  unsigned int n = h - t < max_bytes ? h - t : max_bytes;
+  for (unsigned int i = 0; i < n; i++) {
+    out[i] = bytes[(t + i) & (CAPACITY_BYTES - 1)];
+  }
+  tail.store(t + n, std::memory_order_release);
+  return n;
+}
+
+unsigned int TelemetryRing::size() const {
+  return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+}
+
+unsigned long TelemetryRing::dropped() const {
+  return total_dropped;
+}
+
+TelemetryDecoder::TelemetryDecoder() : record(), bad_frames(0), state(State::SYNC0), length(0), expected_length(0) {}
+
+bool TelemetryDecoder::feed(uint8_t byte) {
+  switch (state) {
+    case State::SYNC0:
+      if (byte == telemetry_frame::SYNC0) {
+        state = State::SYNC1;
+      }
+      return false;
+    case State::SYNC1:
+      if (byte == telemetry_frame::SYNC1) {
+        frame[0] = telemetry_frame::SYNC0;
+        frame[1] = telemetry_frame::SYNC1;
+        length = 2;
+        expected_length = 0;
+        state = State::BODY;
+      } else if (byte != telemetry_frame::SYNC0) {
+        state = State::SYNC0;
+      }
+      return false;
+    case State::BODY:
+      frame[length++] = byte;
+      if (length == 5) {
+        uint8_t count = frame[4];
+        if (frame[2] >= (uint8_t) TelemetryKind::COUNT || count > TelemetryRecord::MAX_VALUES) {
+          bad_frames++;
+          state = State::SYNC0;
+          return false;
+        }
+        expected_length = telemetry_frame::HEADER_BYTES + 4 * count + 1;
+      }
+      if (expected_length == 0 || length < expected_length) {
+        return false;
+      }
+
+      state = State::SYNC0;
+      if (checksum(frame, length - 1) != frame[length - 1]) {
+        bad_frames++;
+        return false;
+      }
+      record.kind = (TelemetryKind) frame[2];
+      record.id = frame[3];
+      record.count = frame[4];
+      record.t_us = get_u32(frame + 5);
+      for (unsigned int i = 0; i < record.count; i++) {
+        uint32_t bits = get_u32(frame + telemetry_frame::HEADER_BYTES + 4 * i);
+        memcpy(&record.values[i], &bits, sizeof(bits));
+      }
+      return true;
+  }
+  return false;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <common/core/Mouse.h>
+#include <common/core/Pose.h>
+
+enum class TelemetryKind : uint8_t {
+  /// values[0] is how long the phase took in microseconds
+  PHASE,
+  /// values are a RangeData, in the order of its fields
+  RANGE,
+  /// values are col, row, yaw
+  POSE,
+  /// id is the wheel, 0 for left and 1 for right. values are setpoint_rps, velocity_rps, the P, I, and D terms,
+  /// feed forward, and the abstract force
+  PID,
+  /// values[0] is how many records were dropped because the ring was full
+  DROPPED,
+  COUNT
+};
+
+/// \brief the parts of a control loop cycle that get timed. The names match the old text profiling output
+enum class LoopPhase : uint8_t {
+  SENSORS,
+  KC,
+  MOTORS,
+  SCHEDULE,
+  COUNT
+};
+
+const char *telemetry_kind_name(TelemetryKind kind);
+
+const char *loop_phase_name(LoopPhase phase);
+
+struct TelemetryRecord {
+  static constexpr unsigned int MAX_VALUES = 7;
+
+  uint32_t t_us;
+  TelemetryKind kind;
+  uint8_t id;
+  uint8_t count;
+  float values[MAX_VALUES];
+};
+
+/**
+ * \brief on the wire a record is a frame of
+ *   0xA5 0x5A kind id count t_us values... checksum
+ * with t_us and the values little endian, and the checksum the low byte of the sum of everything between the sync
+ * bytes and it. Frames are only as long as their values, so a phase is 14 bytes and a range reading 38.
+ */
+namespace telemetry_frame {
+constexpr uint8_t SYNC0 = 0xA5;
+constexpr uint8_t SYNC1 = 0x5A;
+constexpr unsigned int HEADER_BYTES = 9;
+constexpr unsigned int MAX_BYTES = HEADER_BYTES + 4 * TelemetryRecord::MAX_VALUES + 1;
+
+/** \return the number of bytes written to out, which must have room for MAX_BYTES */
+unsigned int encode(const TelemetryRecord &record, uint8_t *out);
+}
+
+/**
+ * \brief a fixed size ring of encoded telemetry frames.
+ * The control loop pushes records as it goes, which only copies a few dozen bytes, and something with nothing better
+ * to do drains the bytes out to a serial port whenever it has room. Nothing is formatted on the robot and nothing is
+ * ever allocated.
+ *
+ * When the ring is full new records are dropped, never old ones, and the next record that fits is preceded by a
+ * DROPPED record saying how many went missing. One context pushes and one drains, which may be different ones.
+ */
+class TelemetryRing {
+public:
+  /// must be a power of two
+  static constexpr unsigned int CAPACITY_BYTES = 2048;
+
+  TelemetryRing();
+
+  /** \return false if the ring was full and the record was dropped */
+  bool push(TelemetryKind kind, uint8_t id, uint32_t t_us, const float *values, uint8_t count);
+
+  bool phase(LoopPhase phase, uint32_t t_us, uint32_t duration_us);
+
+  bool range(uint32_t t_us, const RangeData &range_data);
+
+  bool pose(uint32_t t_us, const GlobalPose &pose);
+
+  /** \brief copy out up to max_bytes of frames. Frames may be split over several calls.
+   * \return the number of bytes copied
+   */
+  unsigned int drain(uint8_t *out, unsigned int max_bytes);
+
+  /** \brief bytes waiting to be drained */
+  unsigned int size() const;
+
+  /** \brief records dropped since construction */
+  unsigned long dropped() const;
+
+private:
+  bool pushFrame(const TelemetryRecord &record);
+
+  uint8_t bytes[CAPACITY_BYTES];
+  std::atomic<unsigned int> head;
+  std::atomic<unsigned int> tail;
+
+  // these belong to the pushing side
+  unsigned long total_dropped;
+  unsigned long unreported_drops;
+};
+
+/**
+ * \brief turns a stream of frame bytes back into records.
+ * It finds its own way to the start of a frame, so the stream can start anywhere, and a frame with a bad checksum is
+ * skipped.
+ */
+class TelemetryDecoder {
+public:
+  TelemetryDecoder();
+
+  /** \return true if that byte finished a good frame, which is then in record */
+  bool feed(uint8_t byte);
+
+  TelemetryRecord record;
+  unsigned long bad_frames;
+
+private:
+  enum class State {
+    SYNC0,
+    SYNC1,
+    BODY
+  };
+
+  State state;
+  uint8_t frame[telemetry_frame::MAX_BYTES];
+  unsigned int length;
+  unsigned int expected_length;
+};
@@ -0,0 +1,259 @@
+#include "WallGrid.h"
+#include "RingBuffer.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+template<unsigned int S>
+inline unsigned int index_of(unsigned int row, unsigned int col) {
+  return row * S + col;
+}
+
+/// \brief move one cell in the given direction, without any bounds checking
+template<unsigned int S>
+inline unsigned int step(unsigned int index, Direction dir) {
+  switch (dir) {
+    case Direction::N:
+      return index - S;
+    case Direction::E:
+      return index + 1;
+    case Direction::S:
+      return index + S;
+    case Direction::W:
+      return index - 1;
+    default:
+      return index;
+  }
+}
+
+}
+
+template<unsigned int S>
+BasicWallGrid<S>::BasicWallGrid() {
+  south_walls.set();
+  east_walls.set();
+}
+
+template<unsigned int S>
+BasicWallGrid<S>::BasicWallGrid(BasicMaze<S> *maze) : BasicWallGrid() {
+  for (unsigned int i = 0; i < S; i++) {
+    for (unsigned int j = 0; j < S; j++) {
+      if (!maze->nodes[i][j]->wall(Direction::S)) {
+        connect_neighbor(i, j, Direction::S);
+      }
+      if (!maze->nodes[i][j]->wall(Direction::E)) {
+        connect_neighbor(i, j, Direction::E);
+      }
+    }
+  }
+}
+
+template<unsigned int S>
+void BasicWallGrid<S>::to_abstract_maze(BasicMaze<S> *maze) const {
+  for (unsigned int i = 0; i < S; i++) {
+    for (unsigned int j = 0; j < S; j++) {
+      for (Direction d = Direction::First; d < Direction::Last; d++) {
+        if (is_wall(i, j, d)) {
+          maze->disconnect_neighbor(i, j, d);
+        } else {
+          maze->connect_neighbor(i, j, d);
+        }
+      }
+    }
+  }
+}
+
+template<unsigned int S>
+bool BasicWallGrid<S>::is_wall(unsigned int row, unsigned int col, const Direction dir) const {
+  switch (dir) {
+    case Direction::N:
+      return row == 0 || south_walls[index_of<S>(row - 1, col)];
+    case Direction::E:
+      return col == S - 1 || east_walls[index_of<S>(row, col)];
+    case Direction::S:
+      return row == S - 1 || south_walls[index_of<S>(row, col)];
+    case Direction::W:
+      return col == 0 || east_walls[index_of<S>(row, col - 1)];
+    default:
+      return true;
+  }
+}
+
+template<unsigned int S>
+void BasicWallGrid<S>::connect_neighbor(unsigned int row, unsigned int col, const Direction dir) {
+  switch (dir) {
+    case Direction::N:
+      if (row > 0) {
+        south_walls[index_of<S>(row - 1, col)] = false;
+      }
+      break;
+    case Direction::E:
+      if (col < S - 1) {
+        east_walls[index_of<S>(row, col)] = false;
+      }
+      break;
+    case Direction::S:
+      if (row < S - 1) {
+        south_walls[index_of<S>(row, col)] = false;
+      }
+      break;
+    case Direction::W:
+      if (col > 0) {
+        east_walls[index_of<S>(row, col - 1)] = false;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+template<unsigned int S>
+void BasicWallGrid<S>::disconnect_neighbor(unsigned int row, unsigned int col, const Direction dir) {
+  switch (dir) {
+    case Direction::N:
+      if (row > 0) {
+        south_walls[index_of<S>(row - 1, col)] = true;
+      }
+      break;
+    case Direction::E:
+      east_walls[index_of<S>(row, col)] = true;
+      break;
+    case Direction::S:
+      south_walls[index_of<S>(row, col)] = true;
+      break;
+    case Direction::W:
+      if (col > 0) {
+        east_walls[index_of<S>(row, col - 1)] = true;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+template<unsigned int S>
+void BasicWallGrid<S>::connect_all_neighbors(unsigned int row, unsigned int col) {
+  for (Direction d = Direction::First; d < Direction::Last; d++) {
+    connect_neighbor(row, col, d);
+  }
+}
+
+template<unsigned int S>
+void BasicWallGrid<S>::connect_all_neighbors_in_maze() {
+  for (unsigned int i = 0; i < S; i++) {
+    for (unsigned int j = 0; j < S; j++) {
+      connect_all_neighbors(i, j);
+    }
+  }
+}
+
+template<unsigned int S>
+void BasicWallGrid<S>::update(SensorReading sr) {
+  for (Direction d = Direction::First; d < Direction::Last; d++) {
+    if (sr.isWall(d)) {
+      disconnect_neighbor(sr.row, sr.col, d);
+    } else {
+      connect_neighbor(sr.row, sr.col, d);
+    }
+  }
+}
+
+template<unsigned int S>
+bool BasicWallGrid<S>::flood_fill(route_t *path, unsigned int r0, unsigned int c0, unsigned int r1, unsigned int c1) const {
+  constexpr uint16_t UNKNOWN = 0xFFFF;
+  uint16_t weights[N];
+  for (unsigned int i = 0; i < N; i++) {
+    weights[i] = UNKNOWN;
+  }
+
+  path->clear();
+
+  // breadth first from the start, every cell goes on the queue at most once
+  RingBuffer<uint16_t, N> frontier;
+  unsigned int start = index_of<S>(r0, c0);
+  weights[start] = 0;
+  frontier.push((uint16_t) start);
+  auto visit = [&](uint16_t from, unsigned int to) {
+    if (weights[to] == UNKNOWN) {
+      weights[to] = (uint16_t) (weights[from] + 1);
+      frontier.push((uint16_t) to);
+    }
+  };
+
+  // this is the hot loop, so check the bits directly in N, E, S, W order instead of going through is_wall
+  uint16_t n;
+  while (frontier.pop(&n)) {
+    unsigned int row = n / S;
+    unsigned int col = n % S;
+    if (row > 0 && !south_walls[n - S]) {
+      visit(n, n - S);
+    }
+    if (col < S - 1 && !east_walls[n]) {
+      visit(n, n + 1);
+    }
+    if (row < S - 1 && !south_walls[n]) {
+      visit(n, n + S);
+    }
+    if (col > 0 && !east_walls[n - 1]) {
+      visit(n, n - 1);
+    }
+  }
+
+  unsigned int goal = index_of<S>(r1, c1);
+  if (weights[goal] == UNKNOWN) {
+    return false;
+  }
+
+  // walk back from the goal, always to the lowest neighbor. The steps come out last to first, so reverse at the end
+  unsigned int current = goal;
+  while (current != start) {
+    unsigned int row = current / S;
+    unsigned int col = current % S;
+    unsigned int min_index = current;
+    Direction min_dir = Direction::N;
+    for (Direction d = Direction::First; d < Direction::Last; d++) {
+      if (!is_wall(row, col, d)) {
+        unsigned int neighbor = step<S>(current, d);
+        if (weights[neighbor] < weights[min_index]) {
+          min_index = neighbor;
+          min_dir = opposite_direction(d);
+        }
+      }
+    }
+    current = min_index;
+    insert_motion_primitive_back(path, {1, min_dir});
+  }
+  std::reverse(path->begin(), path->end());
+
+  return true;
+}
+
+template<unsigned int S>
+bool BasicWallGrid<S>::flood_fill_from_point(route_t *path, unsigned int r0, unsigned int c0, unsigned int r1,
+                                             unsigned int c1) const {
+  return flood_fill(path, r0, c0, r1, c1);
+}
+
+template<unsigned int S>
+bool BasicWallGrid<S>::flood_fill_from_origin(route_t *path, unsigned int r1, unsigned int c1) const {
+  return flood_fill(path, 0, 0, r1, c1);
+}
+
+template<unsigned int S>
+bool BasicWallGrid<S>::flood_fill_from_origin_to_center(route_t *path) const {
+  return flood_fill(path, 0, 0, S / 2, S / 2);
+}
+
+template<unsigned int S>
+bool BasicWallGrid<S>::operator==(const BasicWallGrid &other) const {
+  return south_walls == other.south_walls && east_walls == other.east_walls;
+}
+
+template class BasicWallGrid<8>;
+template class BasicWallGrid<16>;
+template class BasicWallGrid<32>;
+#if SMARTMOUSE_MAZE_SIZE != 8 && SMARTMOUSE_MAZE_SIZE != 16 && SMARTMOUSE_MAZE_SIZE != 32
+template class BasicWallGrid<smartmouse::maze::SIZE>;
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <bitset>
+
+#include "AbstractMaze.h"
+
+/**
+ * \brief a maze stored as two bitsets of walls instead of a graph of nodes.
+ * south_walls has a bit for the wall on the south side of every cell, east_walls for the east side.
+ * The north and west walls of a cell are the south and east walls of its neighbors, and the outside edge of the maze
+ * is always a wall. That's 64 bytes for a 16x16 maze, with no heap use, so copies are cheap.
+ *
+ * Like AbstractMaze, a default constructed WallGrid has every wall.
+ * Instantiated in WallGrid.cpp for the same sizes as BasicMaze.
+ */
+template<unsigned int S>
+class BasicWallGrid {
+public:
+  BasicWallGrid();
+
+  /** \brief copy the walls out of a node based maze */
+  BasicWallGrid(BasicMaze<S> *maze);
+
+  /** \brief write our walls into a node based maze, replacing all of its connections */
+  void to_abstract_maze(BasicMaze<S> *maze) const;
+
+  bool is_wall(unsigned int row, unsigned int col, const Direction dir) const;
+
+  /** \brief remove the wall in the given direction. Walls on the edge of the maze can't be removed. */
+  void connect_neighbor(unsigned int row, unsigned int col, const Direction dir);
+
+  /** \brief add a wall in the given direction */
+  void disconnect_neighbor(unsigned int row, unsigned int col, const Direction dir);
+
+  void connect_all_neighbors(unsigned int row, unsigned int col);
+
+  void connect_all_neighbors_in_maze();
+
+  /** \brief add or remove walls around a cell to match a sensor reading */
+  void update(SensorReading sr);
+
+  /** \brief breadth first flood fill from r0, c0 to r1, c1.
+   * ties are broken the same way AbstractMaze::flood_fill breaks them, so both give the same route.
+   * \return false if there is no route
+   */
+  bool flood_fill(route_t *path, unsigned int r0, unsigned int c0, unsigned int r1, unsigned int c1) const;
+
+  bool flood_fill_from_point(route_t *path, unsigned int r0, unsigned int c0, unsigned int r1, unsigned int c1) const;
+
+  bool flood_fill_from_origin(route_t *path, unsigned int r1, unsigned int c1) const;
+
+  bool flood_fill_from_origin_to_center(route_t *path) const;
+
+  bool operator==(const BasicWallGrid &other) const;
+
+private:
+  static constexpr unsigned int N = S * S;
+
+  std::bitset<N> south_walls;
+  std::bitset<N> east_walls;
+};
+
+typedef BasicWallGrid<smartmouse::maze::SIZE> WallGrid;
@@ -1,6 +1,18 @@
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <common/core/DoubleBuffer.h>
+#include <common/KinematicController/IRConverter.h>
 #include <common/KinematicController/KinematicController.h>
+#include <common/KinematicController/MultiRateExecutive.h>
+#include <common/KinematicController/RangeSampler.h>
+#include <common/KinematicController/RobotConfig.h>
+#include <common/KinematicController/TrajectoryPlanner.h>
+#include <common/KinematicController/VelocityProfile.h>
 
 TEST(ForwardKinematicsTest, Forward_one_second) {
   GlobalPose d_pose = KinematicController::forwardKinematics(1, 1, 0, 1);
@@ -50,6 +62,540 @@ TEST(ForwardKinematicsTest, ccw_turn_one_second) {
   EXPECT_DOUBLE_EQ(d_pose.yaw, -2 * M_PI);
 }
 
+struct Triple {
+  unsigned long a, b, c;
+};
+
+TEST(DoubleBufferTest, NoTornReadsTest) {
+  DoubleBuffer<Triple> buffer({0, 0, 0});
+  std::atomic<bool> done(false);
+
+  std::thread writer([&]() {
+    for (unsigned long i = 1; i <= 200000; i++) {
+      buffer.write({i, i, i});
+    }
+    done = true;
+  });
+
+  unsigned long last = 0;
+  while (!done) {
+    Triple t = buffer.read();
+    ASSERT_EQ(t.a, t.b);
+    ASSERT_EQ(t.a, t.c);
+    ASSERT_GE(t.a, last);
+    last = t.a;
+  }
+  writer.join();
+
+  EXPECT_EQ(buffer.read().a, 200000ul);
+}
+
+/// \brief just enough of a mouse for the kinematic controller to estimate a pose
+class StubMouse : public Mouse {
+public:
+  SensorReading checkWalls() override {
+    return SensorReading(row, col);
+  }
+
+  GlobalPose getGlobalPose() override {
+    return GlobalPose();
+  }
+
+  LocalPose getLocalPose() override {
+    return LocalPose();
+  }
+};
+
+/// \brief a wheel whose speed lags behind the force on it
+struct StubWheel {
+  double angle_rad = 0;
+  double velocity_rps = 0;
+
+  void step(double force, double dt_s) {
+    velocity_rps += (force * 0.25 - velocity_rps) * dt_s / 0.05;
+    angle_rad += velocity_rps * dt_s;
+  }
+};
+
+TEST(MultiRateExecutiveTest, LockStepTest) {
+  StubMouse mouse;
+  KinematicController kc(&mouse);
+  MultiRateExecutive executive;
+  kc.useExecutive(&executive);
+  kc.setAccelerationCpss(10);
+  // the default gains are tuned for the real motors, not StubWheel
+  kc.setParams(150, 0, 0, 4, 0);
+  kc.setSpeedCps(1, 1);
+
+  StubWheel left, right;
+  for (unsigned int slow = 0; slow < 200; slow++) {
+    for (unsigned int fast = 0; fast < 10; fast++) {
+      auto forces = executive.fastTick(left.angle_rad, right.angle_rad);
+      left.step(forces.first, MultiRateExecutive::FAST_PERIOD_S);
+      right.step(forces.second, MultiRateExecutive::FAST_PERIOD_S);
+    }
+    kc.run(0.01, left.angle_rad, right.angle_rad, {0.18, 0.18, 0.18, 0.18, 0.18, 0.18, 0.18});
+  }
+
+  WheelState state = executive.state();
+  EXPECT_EQ(state.ticks, 2000ul);
+  EXPECT_NEAR(smartmouse::kc::radToCU(state.left_velocity_rps), 1, 0.1);
+  EXPECT_NEAR(smartmouse::kc::radToCU(state.right_velocity_rps), 1, 0.1);
+
+  // driving straight along yaw 0, so the pose only moves in col, by as much as the wheels turned
+  GlobalPose pose = kc.getGlobalPose();
+  EXPECT_NEAR(pose.col, smartmouse::kc::radToCU(left.angle_rad), 0.01);
+  EXPECT_NEAR(pose.row, 0, 1e-6);
+  EXPECT_NEAR(pose.yaw, 0, 1e-6);
+}
+
+TEST(MultiRateExecutiveTest, ThreadedTest) {
+  StubMouse mouse;
+  KinematicController kc(&mouse);
+  MultiRateExecutive executive;
+  kc.useExecutive(&executive);
+  kc.setAccelerationCpss(10);
+  // the default gains are tuned for the real motors, not StubWheel
+  kc.setParams(150, 0, 0, 4, 0);
+
+  // the fast loop gets its own thread like it would get a timer interrupt, and owns the wheels
+  std::atomic<bool> done(false);
+  std::thread fast_loop([&]() {
+    StubWheel left, right;
+    while (!done) {
+      auto forces = executive.fastTick(left.angle_rad, right.angle_rad);
+      left.step(forces.first, MultiRateExecutive::FAST_PERIOD_S);
+      right.step(forces.second, MultiRateExecutive::FAST_PERIOD_S);
+      std::this_thread::sleep_for(std::chrono::microseconds(MultiRateExecutive::FAST_PERIOD_US));
+    }
+  });
+
+  kc.setSpeedCps(-1, 1);
+  while (executive.state().ticks < 2000) {
+    kc.run(0.01, 0, 0, {0.18, 0.18, 0.18, 0.18, 0.18, 0.18, 0.18});
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  done = true;
+  fast_loop.join();
+
+  WheelState state = executive.state();
+  EXPECT_NEAR(smartmouse::kc::radToCU(state.left_velocity_rps), -1, 0.1);
+  EXPECT_NEAR(smartmouse::kc::radToCU(state.right_velocity_rps), 1, 0.1);
+  // spinning in place
+  EXPECT_NEAR(kc.getGlobalPose().col, 0, 0.01);
+  EXPECT_NEAR(kc.getGlobalPose().row, 0, 0.01);
+}
+
+TEST(IRConverterTest, TableMatchesCurveTest) {
+  IRConverter converter;
+  for (int adc = 0; adc < (int) IRConverter::TABLE_SIZE; adc++) {
+    double expected = IRConverter::curveToMeters(adc * 1024.0 / IRConverter::TABLE_SIZE, 0);
+    ASSERT_NEAR(converter.adcToMeters(adc), expected, IRConverter::METERS_PER_UNIT);
+  }
+
+  // out of range readings are clamped instead of read past the table
+  EXPECT_DOUBLE_EQ(converter.adcToMeters(-1), converter.adcToMeters(0));
+  EXPECT_DOUBLE_EQ(converter.adcToMeters(IRConverter::TABLE_SIZE), converter.adcToMeters(IRConverter::TABLE_SIZE - 1));
+}
+
+TEST(IRConverterTest, CalibrateTest) {
+  IRConverter left, right;
+  int adc = 300;
+  double measured = left.adcToMeters(adc);
+  left.calibrate(adc, measured + 0.005);
+
+  // each converter has its own curve
+  EXPECT_NEAR(left.adcToMeters(adc), measured + 0.005, IRConverter::METERS_PER_UNIT);
+  EXPECT_NEAR(right.adcToMeters(adc), measured, IRConverter::METERS_PER_UNIT);
+  EXPECT_NEAR(left.getCalibrationOffset(), 0.005, IRConverter::METERS_PER_UNIT);
+}
+
+/// \brief latches whatever the test set for a pin when its conversion starts, and remembers the order of the pins
+class MockAdc : public AdcInterface {
+public:
+  void start(unsigned int pin) override {
+    starts.push_back(pin);
+    result = values[pin];
+  }
+
+  int read() override {
+    reads++;
+    return result;
+  }
+
+  int values[RANGE_SENSOR_COUNT + 10] = {};
+  std::vector<unsigned int> starts;
+  unsigned int reads = 0;
+
+private:
+  int result = 0;
+};
+
+const std::array<unsigned int, RANGE_SENSOR_COUNT> MOCK_PINS = {10, 11, 12, 13, 14, 15, 16};
+
+void sample_ticks(RangeSampler *sampler, unsigned int ticks) {
+  for (unsigned int i = 0; i < ticks; i++) {
+    sampler->sample();
+  }
+}
+
+TEST(RangeSamplerTest, InitialSnapshotTest) {
+  MockAdc adc;
+  IRConverter ir;
+  RangeSampler sampler(&adc, MOCK_PINS, {&ir, &ir, &ir, &ir, &ir, &ir, &ir});
+
+  RangeSnapshot snapshot = sampler.latest();
+  EXPECT_EQ(snapshot.count, 0ul);
+  EXPECT_EQ(snapshot.range_data.front, smartmouse::kc::ANALOG_MAX_DIST_M);
+  EXPECT_EQ(snapshot.range_data.gerald_left, smartmouse::kc::ANALOG_MAX_DIST_M);
+  EXPECT_TRUE(adc.starts.empty());
+}
+
+TEST(RangeSamplerTest, RoundRobinTest) {
+  MockAdc adc;
+  IRConverter ir;
+  RangeSampler sampler(&adc, MOCK_PINS, {&ir, &ir, &ir, &ir, &ir, &ir, &ir});
+
+  // every tick reads one conversion and starts one, so the first tick only starts
+  sampler.sample();
+  EXPECT_EQ(adc.starts.size(), 1u);
+  EXPECT_EQ(adc.reads, 0u);
+  sample_ticks(&sampler, RANGE_SENSOR_COUNT - 1);
+  EXPECT_EQ(sampler.latest().count, 0ul);
+  sampler.sample();
+  EXPECT_EQ(sampler.latest().count, 1ul);
+  sample_ticks(&sampler, 1);
+
+  ASSERT_EQ(adc.starts.size(), 9u);
+  EXPECT_EQ(adc.reads, 8u);
+  for (unsigned int i = 0; i < adc.starts.size(); i++) {
+    EXPECT_EQ(adc.starts[i], MOCK_PINS[i % RANGE_SENSOR_COUNT]);
+  }
+}
+
+TEST(RangeSamplerTest, ConvertsEachSensorTest) {
+  MockAdc adc;
+  IRConverter left, right, other;
+  left.calibrate(300, left.adcToMeters(300) + 0.01);
+  RangeSampler sampler(&adc, MOCK_PINS, {&other, &other, &left, &right, &other, &other, &other});
+
+  for (unsigned int i = 0; i < RANGE_SENSOR_COUNT; i++) {
+    adc.values[MOCK_PINS[i]] = 300 + 10 * i;
+  }
+  sample_ticks(&sampler, sampler.conversionsPerSnapshot() + 1);
+
+  RangeSnapshot snapshot = sampler.latest();
+  EXPECT_EQ(snapshot.count, 1ul);
+  EXPECT_EQ(snapshot.adc[static_cast<unsigned int>(RangeSensor::FRONT_LEFT)], 320);
+  EXPECT_EQ(snapshot.range_data.gerald_left, other.adcToMeters(300));
+  EXPECT_EQ(snapshot.range_data.gerald_right, other.adcToMeters(310));
+  EXPECT_EQ(snapshot.range_data.front_left, left.adcToMeters(320));
+  EXPECT_EQ(snapshot.range_data.front_right, right.adcToMeters(330));
+  EXPECT_EQ(snapshot.range_data.back_left, other.adcToMeters(340));
+  EXPECT_EQ(snapshot.range_data.back_right, other.adcToMeters(350));
+  EXPECT_EQ(snapshot.range_data.front, other.adcToMeters(360));
+}
+
+TEST(RangeSamplerTest, PauseTest) {
+  MockAdc adc;
+  IRConverter ir;
+  RangeSampler sampler(&adc, MOCK_PINS, {&ir, &ir, &ir, &ir, &ir, &ir, &ir});
+
+  // the conversion started before pausing is dropped, since it's stale by the time sampling resumes
+  sampler.sample();
+  sampler.pause();
+  sample_ticks(&sampler, sampler.conversionsPerSnapshot() + 1);
+  // while it's paused, calibrating can rewrite the tables without the sampler reading them
+  ir.calibrate(300, ir.adcToMeters(300) + 0.01);
+  EXPECT_EQ(adc.starts.size(), 1u);
+  EXPECT_EQ(adc.reads, 0u);
+  EXPECT_EQ(sampler.latest().count, 0ul);
+
+  sampler.resume();
+  adc.values[MOCK_PINS[static_cast<unsigned int>(RangeSensor::FRONT)]] = 300;
+  sample_ticks(&sampler, sampler.conversionsPerSnapshot() + 1);
+  EXPECT_EQ(adc.starts[1], MOCK_PINS[0]);
+  EXPECT_EQ(sampler.latest().count, 1ul);
+  EXPECT_EQ(sampler.latest().range_data.front, ir.adcToMeters(300));
+}
+
+TEST(RangeSamplerTest, OversamplingTest) {
+  MockAdc adc;
+  IRConverter ir;
+  RangeSampler sampler(&adc, MOCK_PINS, {&ir, &ir, &ir, &ir, &ir, &ir, &ir}, 4);
+  ASSERT_EQ(sampler.conversionsPerSnapshot(), 4 * RANGE_SENSOR_COUNT);
+
+  // the front sensor reads 100, 101, 102, 103, which averages to 101.5 and rounds to 102
+  for (int reading = 100; reading < 104; reading++) {
+    adc.values[MOCK_PINS[static_cast<unsigned int>(RangeSensor::FRONT)]] = reading;
+    EXPECT_EQ(sampler.latest().count, 0ul);
+    sample_ticks(&sampler, RANGE_SENSOR_COUNT);
+  }
+  // the last conversion is read on the next tick
+  EXPECT_EQ(sampler.latest().count, 0ul);
+  sampler.sample();
+
+  RangeSnapshot snapshot = sampler.latest();
+  EXPECT_EQ(snapshot.count, 1ul);
+  EXPECT_EQ(snapshot.adc[static_cast<unsigned int>(RangeSensor::FRONT)], 102);
+  EXPECT_EQ(snapshot.range_data.front, ir.adcToMeters(102));
+
+  // and the sums start over for the next snapshot
+  sample_ticks(&sampler, sampler.conversionsPerSnapshot());
+  EXPECT_EQ(sampler.latest().count, 2ul);
+  EXPECT_EQ(sampler.latest().adc[static_cast<unsigned int>(RangeSensor::FRONT)], 103);
+}
+
+/// \brief step through a profile and check it never breaks its limits and that the speed adds up to the distance
+void check_profile(const VelocityProfile &profile, ProfileLimits limits) {
+  constexpr double dt = 1e-4;
+  ProfileSample last = profile.sample(0);
+  double integrated_s = 0;
+  for (double t = dt; t < profile.duration() + dt; t += dt) {
+    ProfileSample sample = profile.sample(std::min(t, profile.duration()));
+    EXPECT_LE(sample.v, limits.v_max + 1e-9);
+    EXPECT_GE(sample.v, -1e-9);
+    EXPECT_LE(fabs(sample.v - last.v), limits.a_max * dt + 1e-9);
+    if (limits.j_max > 0) {
+      EXPECT_LE(fabs(sample.a), limits.a_max + 1e-9);
+      EXPECT_LE(fabs(sample.a - last.a), limits.j_max * dt + 1e-9);
+    }
+    integrated_s += (sample.v + last.v) / 2 * dt;
+    last = sample;
+  }
+  EXPECT_NEAR(last.s, profile.length(), 1e-6);
+  EXPECT_NEAR(integrated_s, profile.length(), 1e-3);
+
+  // past the end it stays at the end, still going the exit speed
+  EXPECT_NEAR(profile.sample(profile.duration() + 1).s, profile.length(), 1e-6);
+}
+
+TEST(VelocityProfileTest, TrapezoidTest) {
+  ProfileLimits limits = {2, 4, 0};
+  VelocityProfile profile;
+  profile.planStraight(3, 0, 0, limits);
+
+  // half a cell to get up to speed, two at full speed, and half a cell to stop
+  EXPECT_DOUBLE_EQ(profile.peakSpeed(0), 2);
+  EXPECT_DOUBLE_EQ(profile.duration(), 2);
+  EXPECT_DOUBLE_EQ(profile.sample(0.25).v, 1);
+  EXPECT_DOUBLE_EQ(profile.sample(0.25).s, 0.125);
+  EXPECT_DOUBLE_EQ(profile.sample(1).v, 2);
+  EXPECT_DOUBLE_EQ(profile.sample(1).s, 1.5);
+  EXPECT_DOUBLE_EQ(profile.sample(10).s, 3);
+  EXPECT_DOUBLE_EQ(profile.sample(10).v, 0);
+  EXPECT_NEAR(profile.speedAt(0.125), 1, 1e-9);
+  check_profile(profile, limits);
+}
+
+TEST(VelocityProfileTest, TriangleTest) {
+  // too short to reach full speed
+  ProfileLimits limits = {5, 4, 0};
+  VelocityProfile profile;
+  profile.planStraight(1, 0, 0, limits);
+  EXPECT_DOUBLE_EQ(profile.peakSpeed(0), 2);
+  EXPECT_DOUBLE_EQ(profile.duration(), 1);
+  check_profile(profile, limits);
+
+  // and when it can't brake in time, it ends as slow as it can
+  profile.planStraight(1, 4, 0, limits);
+  EXPECT_DOUBLE_EQ(profile.exitSpeed(0), sqrt(8));
+  check_profile(profile, limits);
+}
+
+TEST(VelocityProfileTest, SCurveTest) {
+  ProfileLimits limits = {3, 4, 40};
+  VelocityProfile profile;
+  profile.planStraight(4, 0.5, 0.3, limits);
+  EXPECT_DOUBLE_EQ(profile.peakSpeed(0), 3);
+  EXPECT_DOUBLE_EQ(profile.sample(0).a, 0);
+  check_profile(profile, limits);
+
+  // too short for full acceleration or full speed
+  profile.planStraight(0.2, 0, 0, limits);
+  EXPECT_LT(profile.peakSpeed(0), 1);
+  check_profile(profile, limits);
+
+  // the S-curve is never faster than the trapezoid
+  VelocityProfile trapezoid;
+  trapezoid.planStraight(4, 0.5, 0.3, {3, 4, 0});
+  profile.planStraight(4, 0.5, 0.3, limits);
+  EXPECT_GT(profile.duration(), trapezoid.duration());
+}
+
+TEST(VelocityProfileTest, RouteTest) {
+  ProfileLimits limits = {4, 4, 80};
+  route_t route = {{3, Direction::N}, {1, Direction::E}, {4, Direction::N}, {2, Direction::W}};
+  VelocityProfile profile;
+  ASSERT_TRUE(profile.plan(route, 0, 0, 0.5, limits));
+  ASSERT_EQ(profile.segmentCount(), 4u);
+  EXPECT_DOUBLE_EQ(profile.length(), 10);
+
+  EXPECT_DOUBLE_EQ(profile.entrySpeed(0), 0);
+  EXPECT_DOUBLE_EQ(profile.exitSpeed(3), 0);
+  for (unsigned int i = 0; i + 1 < profile.segmentCount(); i++) {
+    EXPECT_DOUBLE_EQ(profile.exitSpeed(i), profile.entrySpeed(i + 1));
+    EXPECT_LE(profile.exitSpeed(i), 0.5);
+  }
+
+  // it doesn't slow down at cell edges in the middle of a straight
+  EXPECT_GT(profile.speedAt(1), 0.5);
+  EXPECT_GT(profile.speedAt(6), 0.5);
+  EXPECT_NEAR(profile.speedAt(3), profile.exitSpeed(0), 1e-6);
+  check_profile(profile, limits);
+
+  // sampling backwards works too, it just doesn't get to start where it left off
+  EXPECT_DOUBLE_EQ(profile.sample(0).s, 0);
+
+  route_t too_long(VelocityProfile::MAX_SEGMENTS + 1, {1, Direction::N});
+  EXPECT_FALSE(profile.plan(too_long, 0, 0, 0.5, limits));
+  EXPECT_EQ(profile.segmentCount(), 0u);
+}
+
+TEST(VelocityProfileTest, TimeAtTest) {
+  ProfileLimits limits = {4, 4, 80};
+  route_t route = {{6, Direction::E}, {2, Direction::S}};
+  VelocityProfile profile;
+  ASSERT_TRUE(profile.plan(route, 0, 0, 0.5, limits));
+
+  // a run picks the profile up at each cell from where it is along the route, so the first cell starts from rest
+  EXPECT_NEAR(profile.timeAt(0), 0, 1e-9);
+  EXPECT_NEAR(profile.sample(profile.timeAt(0)).v, 0, 1e-9);
+  for (double s = 0.5; s < profile.length(); s += 0.5) {
+    EXPECT_NEAR(profile.sample(profile.timeAt(s)).s, s, 1e-6);
+  }
+  EXPECT_NEAR(profile.sample(profile.timeAt(6)).v, 0.5, 1e-6);
+  EXPECT_DOUBLE_EQ(profile.timeAt(profile.length() + 1), profile.duration());
+}
+
+TEST(KinematicControllerTest, StartExitSpeedTest) {
+  // starting doesn't look at the mouse, only at the wheels, which are stopped
+  KinematicController controller(nullptr);
+  controller.start(GlobalPose(0.5, 0.5, 0), 1);
+
+  // profiles are in cells per second, so the default exit speed is the turn speed in cells per second, not m/s
+  const VelocityProfile &profile = controller.currentProfile();
+  ASSERT_EQ(profile.segmentCount(), 1u);
+  EXPECT_DOUBLE_EQ(profile.exitSpeed(0), smartmouse::kc::TURN_SPEED_CUPS);
+  EXPECT_DOUBLE_EQ(profile.exitSpeed(0), smartmouse::maze::toCellUnits(smartmouse::kc::END_SPEED_MPS));
+  EXPECT_DOUBLE_EQ(profile.sample(profile.duration()).v, smartmouse::kc::TURN_SPEED_CUPS);
+}
+
+TEST(TrajectoryPlannerTest, StraightLineTest) {
+  TrajectoryPlanner planner;
+  ASSERT_TRUE(planner.addWaypoint({0, GlobalState(GlobalPose(0.5, 0.5, 0), 1)}));
+  ASSERT_TRUE(planner.addWaypoint({1, GlobalState(GlobalPose(1.5, 0.5, 0), 1)}));
+
+  Trajectory trajectory;
+  ASSERT_TRUE(planner.plan(&trajectory));
+  for (double t = 0; t <= 1; t += 0.1) {
+    TrajectorySample sample = trajectory.sample(t);
+    EXPECT_NEAR(sample.pose.col, 0.5 + t, 1e-9);
+    EXPECT_NEAR(sample.pose.row, 0.5, 1e-9);
+    EXPECT_NEAR(sample.velocity, 1, 1e-9);
+    EXPECT_NEAR(sample.yaw_rate, 0, 1e-9);
+  }
+  auto wheels = trajectory.wheelVelocities(0.5);
+  EXPECT_NEAR(wheels.first, 1, 1e-9);
+  EXPECT_NEAR(wheels.second, 1, 1e-9);
+}
+
+TEST(TrajectoryPlannerTest, QuarterTurnTest) {
+  // a right turn along a half cell radius arc, at one cell per second
+  double duration = M_PI / 4;
+  GlobalPose start(0.5, 0, M_PI / 2);
+  GlobalPose end(1.0, 0.5, 0);
+
+  TrajectoryPlanner planner;
+  ASSERT_TRUE(planner.addWaypoint({0, GlobalState(start, 1)}));
+  ASSERT_TRUE(planner.addWaypoint({duration, GlobalState(end, 1)}));
+  Trajectory trajectory;
+  ASSERT_TRUE(planner.plan(&trajectory));
+
+  TrajectorySample first = trajectory.sample(0);
+  TrajectorySample last = trajectory.sample(duration);
+  EXPECT_NEAR(first.pose.col, start.col, 1e-9);
+  EXPECT_NEAR(first.pose.yaw, start.yaw, 1e-9);
+  EXPECT_NEAR(last.pose.row, end.row, 1e-9);
+  EXPECT_NEAR(last.pose.yaw, end.yaw, 1e-9);
+  EXPECT_NEAR(last.velocity, 1, 1e-9);
+
+  // driving the wheel speeds it asks for, the same way the kinematic controller does, ends up where it should
+  constexpr double dt = 0.001;
+  GlobalPose pose = start;
+  for (double t = 0; t < duration - dt / 2; t += dt) {
+    double vl, vr;
+    std::tie(vl, vr) = trajectory.wheelVelocities(t + dt / 2);
+    GlobalPose d_pose = KinematicController::forwardKinematics(vr, vl, pose.yaw, dt);
+    pose.col += d_pose.col;
+    pose.row += d_pose.row;
+    pose.yaw += d_pose.yaw;
+  }
+  EXPECT_NEAR(pose.col, end.col, 0.01);
+  EXPECT_NEAR(pose.row, end.row, 0.01);
+  EXPECT_NEAR(pose.yaw, end.yaw, 0.02);
+
+  // the trajectory goes through a waypoint in the middle of the arc, which pulls it closer to the arc
+  GlobalPose middle(1.0 - 0.5 * cos(M_PI / 4), 0.5 * sin(M_PI / 4), M_PI / 4);
+  auto miss = [&](const Trajectory &trajectory) {
+    GlobalPose halfway = trajectory.sample(duration / 2).pose;
+    return hypot(halfway.col - middle.col, halfway.row - middle.row);
+  };
+  double two_point_miss = miss(trajectory);
+
+  planner.clear();
+  planner.addWaypoint({0, GlobalState(start, 1)});
+  planner.addWaypoint({duration / 2, GlobalState(middle, 1)});
+  planner.addWaypoint({duration, GlobalState(end, 1)});
+  ASSERT_TRUE(planner.plan(&trajectory));
+  EXPECT_LT(miss(trajectory), two_point_miss);
+  EXPECT_LT(miss(trajectory), 1e-9);
+  EXPECT_NEAR(trajectory.sample(duration).pose.col, end.col, 1e-9);
+}
+
+TEST(TrajectoryPlannerTest, ThroughWaypointsTest) {
+  // a straight into a left turn, at one cell per second
+  Waypoint waypoints[] = {{0, GlobalState(GlobalPose(0.5, 0.5, 0), 1)},
+                          {0.5, GlobalState(GlobalPose(1.0, 0.5, 0), 1)},
+                          {0.5 + M_PI / 4, GlobalState(GlobalPose(1.5, 1.0, M_PI / 2), 1)}};
+  TrajectoryPlanner planner;
+  for (const Waypoint &waypoint : waypoints) {
+    ASSERT_TRUE(planner.addWaypoint(waypoint));
+  }
+  Trajectory trajectory;
+  ASSERT_TRUE(planner.plan(&trajectory));
+  EXPECT_EQ(trajectory.segment_count, 2u);
+
+  // every waypoint is hit exactly, not just close to
+  for (const Waypoint &waypoint : waypoints) {
+    TrajectorySample sample = trajectory.sample(waypoint.time);
+    EXPECT_NEAR(sample.pose.col, waypoint.state.pose.col, 1e-9);
+    EXPECT_NEAR(sample.pose.row, waypoint.state.pose.row, 1e-9);
+    EXPECT_NEAR(sample.pose.yaw, waypoint.state.pose.yaw, 1e-9);
+    EXPECT_NEAR(sample.velocity, waypoint.state.velocity, 1e-9);
+  }
+
+  // and the velocity and turn rate don't jump where the segments meet
+  TrajectorySample before = trajectory.sample(0.5 - 1e-7);
+  TrajectorySample after = trajectory.sample(0.5 + 1e-7);
+  EXPECT_NEAR(before.velocity, after.velocity, 1e-5);
+  EXPECT_NEAR(before.pose.yaw, after.pose.yaw, 1e-5);
+  EXPECT_NEAR(before.yaw_rate, after.yaw_rate, 1e-4);
+}
+
+TEST(TrajectoryPlannerTest, BadWaypointsTest) {
+  TrajectoryPlanner planner;
+  Trajectory trajectory;
+  ASSERT_TRUE(planner.addWaypoint({0, GlobalState(GlobalPose(0, 0, 0), 0)}));
+  EXPECT_FALSE(planner.plan(&trajectory));
+  EXPECT_FALSE(planner.addWaypoint({0, GlobalState(GlobalPose(1, 0, 0), 0)}));
+  for (unsigned int i = 1; i < TrajectoryPlanner::MAX_WAYPOINTS; i++) {
+    EXPECT_TRUE(planner.addWaypoint({(double) i, GlobalState(GlobalPose(i, 0, 0), 1)}));
+  }
+  EXPECT_FALSE(planner.addWaypoint({10, GlobalState(GlobalPose(10, 0, 0), 1)}));
+  EXPECT_TRUE(planner.plan(&trajectory));
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -1,21 +1,11 @@
 #include "ConsoleMouse.h"
 
-ConsoleMouse *ConsoleMouse::instance = nullptr;
-
-ConsoleMouse *ConsoleMouse::inst() {
-  if (instance == NULL) {
-    instance = new ConsoleMouse();
-  }
-
-  return instance;
-}
-
 void ConsoleMouse::seedMaze(AbstractMaze *maze) { this->true_maze = maze; }
 
-ConsoleMouse::ConsoleMouse() {}
+ConsoleMouse::ConsoleMouse() : true_maze(nullptr) {}
 
 ConsoleMouse::ConsoleMouse(int starting_row, int starting_col)
-        : Mouse(starting_row, starting_col) {}
+        : Mouse(starting_row, starting_col), true_maze(nullptr) {}
 
 SensorReading ConsoleMouse::checkWalls() {
   SensorReading sr(row, col);
@@ -13,16 +13,13 @@ public:
 
   virtual LocalPose getLocalPose() override;
 
-  static ConsoleMouse *inst();
+  ConsoleMouse();
+
+  ConsoleMouse(int starting_row, int starting_col);
 
   void seedMaze(AbstractMaze *maze);
 
 private:
 
-  static ConsoleMouse *instance;
   AbstractMaze *true_maze;
-
-  ConsoleMouse();
-
-  ConsoleMouse(int starting_row, int starting_col);
 };
@@ -1,13 +1,38 @@
 #include "Finish.h"
+#include <common/core/DiagonalPlanner.h>
+#include <common/core/RunPlanner.h>
+#include <common/KinematicController/RobotConfig.h>
 
-Finish::Finish(AbstractMaze *maze) : Command("end"), maze(maze) {}
+Finish::Finish(RobotContext *context, AbstractMaze *maze) : Command("end"), maze(maze) {}
 
 void Finish::initialize() {
   std::string s = route_to_string(maze->fastest_route);
   printf("end. Solution=%s\n", s.c_str());
+
+  // what a speed run would save by planning for time instead of cells, and by cutting diagonals, through what was
+  // explored. These times are the planners' cost model, not a drive: SpeedRun drives the timed route, but nothing
+  // drives a diagonal route yet, so its time is only an estimate of what one could reach
+  RunLimits limits = {smartmouse::kc::MAX_SPEED_CUPS,
+                      smartmouse::kc::MAX_SPEED_CUPS * smartmouse::kc::DIAGONAL_SPEED_SCALE,
+                      smartmouse::kc::MAX_ACCEL_CUPSS, smartmouse::kc::TURN_SPEED_CUPS, smartmouse::kc::TURN_RADIUS_CU};
+  RunPlanner run_planner(maze, limits);
+  route_t timed_route;
+  if (run_planner.plan(&timed_route, 0, 0, Direction::E, smartmouse::maze::CENTER, smartmouse::maze::CENTER)) {
+    printf("Speed run solution=%s (estimated %.2fs instead of %.2fs)\n", route_to_string(timed_route).c_str(),
+           run_planner.route_time(timed_route, Direction::E),
+           run_planner.route_time(maze->fastest_route, Direction::E));
+  }
+
+  DiagonalPlanner planner(maze, limits);
+  diagonal_route_t diagonal_route;
+  if (planner.plan(&diagonal_route, 0, 0, Direction::E, smartmouse::maze::CENTER, smartmouse::maze::CENTER)) {
+    double t = planner.route_time(DiagonalPlanner::from_route(maze->fastest_route), Direction::E);
+    double diagonal_t = planner.route_time(diagonal_route, Direction::E);
+    printf("Diagonal route=%s (estimated %.2fs instead of %.2fs, not driven)\n", diagonal_route_to_string(diagonal_route).c_str(),
+           diagonal_t, t);
+  }
 }
 
 bool Finish::isFinished() {
   return true;
 }
-
@@ -1,11 +1,12 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/AbstractMaze.h>
 
 class Finish : public Command {
 public:
-  Finish(AbstractMaze *maze);
+  Finish(RobotContext *context, AbstractMaze *maze);
 
   void initialize();
 
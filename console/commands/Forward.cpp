@@ -1,7 +1,9 @@
 #include <commands/Forward.h>
 #include <console/ConsoleMouse.h>
 
-Forward::Forward() : mouse(ConsoleMouse::inst()) {}
+Forward::Forward(RobotContext *context, double) : mouse(context->mouse) {}
+
+Forward::Forward(RobotContext *context, const VelocityProfile *, double) : mouse(context->mouse) {}
 
 void Forward::initialize() {
   mouse->internalForward();
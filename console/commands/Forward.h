@@ -1,11 +1,18 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Mouse.h>
+#include <common/KinematicController/RobotConfig.h>
+#include <common/KinematicController/VelocityProfile.h>
 
-class Forward : public Command {
+class Forward : public Command, public PooledCommand<Forward, smartmouse::maze::SIZE> {
 public:
-  Forward();
+  /** \brief move to the next cell. The console mouse moves a whole cell at once, so v_final is ignored */
+  Forward(RobotContext *context, double v_final = smartmouse::kc::TURN_SPEED_CUPS);
+
+  /** \brief move to the next cell. The speeds in route_profile are ignored for the same reason */
+  Forward(RobotContext *context, const VelocityProfile *route_profile, double s);
 
   void initialize();
 
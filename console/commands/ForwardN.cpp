@@ -2,7 +2,7 @@
 #include <iostream>
 #include "ForwardN.h"
 
-ForwardN::ForwardN(unsigned int n) : Command("ForwardN"), n(n), i(0), mouse(ConsoleMouse::inst())  {}
+ForwardN::ForwardN(RobotContext *context, unsigned int n) : Command("ForwardN"), n(n), i(0), mouse(context->mouse)  {}
 
 void ForwardN::initialize() {
 }
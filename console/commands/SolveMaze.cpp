@@ -3,8 +3,8 @@
 #include "WaitForStart.h"
 #include "ForwardN.h"
 
-SolveMaze::SolveMaze(Solver *solver, Solver::Goal goal) : CommandGroup("solve"), solver(solver), movements(0),
-                                                          goal(goal) {}
+SolveMaze::SolveMaze(RobotContext *context, Solver *solver, Solver::Goal goal)
+    : CommandGroup("solve"), context(context), solver(solver), movements(0), goal(goal) {}
 
 void SolveMaze::initialize() {
   solved = false;
@@ -18,6 +18,11 @@ bool SolveMaze::isFinished() {
     bool mazeSolved = solver->isFinished();
 
     if (!mazeSolved) {
+      // keep the robot waiting here until planning is done, instead of planning all at once
+      if (!solver->planSlice(PLAN_EXPANSIONS_PER_CYCLE)) {
+        return false;
+      }
+
       motion_primitive_t prim = solver->planNextStep();
 
       if (!solver->isSolvable()) {
@@ -25,10 +30,10 @@ bool SolveMaze::isFinished() {
         return true;
       }
 
-      addSequential(new Turn(prim.d));
-      addSequential(new ForwardN(prim.n));
+      addSequential(new Turn(context, prim.d));
+      addSequential(new ForwardN(context, prim.n));
       if (!GlobalProgramSettings.quiet) {
-        addSequential(new WaitForStart());
+        addSequential(new WaitForStart(context));
         solver->mouse->print_maze_mouse();
       }
     } else {
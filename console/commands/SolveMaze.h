@@ -1,12 +1,13 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Solver.h>
 #include <common/core/Mouse.h>
 
 class SolveMaze : public CommandGroup {
 public:
-  SolveMaze(Solver *solver, Solver::Goal goal);
+  SolveMaze(RobotContext *context, Solver *solver, Solver::Goal goal);
 
   void initialize();
 
@@ -14,7 +15,11 @@ public:
 
   void end();
 
+  /// \brief planning is spread over cycles, this many distance field expansions at a time
+  static constexpr unsigned int PLAN_EXPANSIONS_PER_CYCLE = 64;
+
 private:
+  RobotContext *context;
   Solver *solver;
   int movements;
   Solver::Goal goal;
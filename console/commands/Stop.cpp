@@ -1,8 +1,8 @@
 #include "Stop.h"
 
-Stop::Stop() : mouse(ConsoleMouse::inst()) {}
+Stop::Stop(RobotContext *context) : mouse(context->mouse) {}
 
-Stop::Stop(unsigned long stop_time) : mouse(ConsoleMouse::inst()) {}
+Stop::Stop(RobotContext *context, unsigned long stop_time) : mouse(context->mouse) {}
 
 void Stop::initialize() {
 }
@@ -1,15 +1,16 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Mouse.h>
 
 #include "ConsoleMouse.h"
 
 class Stop : public Command {
 public:
-  Stop(unsigned long stop_time);
+  Stop(RobotContext *context, unsigned long stop_time);
 
-  Stop();
+  Stop(RobotContext *context);
 
   void initialize();
 
@@ -1,7 +1,7 @@
 #include "Turn.h"
 #include "ConsoleMouse.h"
 
-Turn::Turn(Direction dir) : mouse(ConsoleMouse::inst()), dir(dir) {}
+Turn::Turn(RobotContext *context, Direction dir) : mouse(context->mouse), dir(dir) {}
 
 void Turn::initialize() {
   mouse->internalTurnToFace(dir);
@@ -1,11 +1,12 @@
 #pragma once
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Mouse.h>
 #include <common/core/Direction.h>
 
-class Turn : public Command {
+class Turn : public Command, public PooledCommand<Turn, 4> {
 public:
-  Turn(Direction dir);
+  Turn(RobotContext *context, Direction dir);
 
   void initialize();
 
@@ -1,7 +1,7 @@
 #include <iostream>
 #include "WaitForStart.h"
 
-WaitForStart::WaitForStart() : Command("wait") {}
+WaitForStart::WaitForStart(RobotContext *context) : Command("wait") {}
 
 void WaitForStart::initialize() {
   printf("Waiting. Press enter...\n");
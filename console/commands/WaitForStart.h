@@ -1,9 +1,10 @@
 #pragma once
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 
 class WaitForStart : public Command {
 public:
-  WaitForStart();
+  WaitForStart(RobotContext *context);
 
   void initialize();
 
@@ -57,17 +57,18 @@ int main(int argc, char *argv[]) {
     std::cout << "start pos: (" << row << "," << col << ")" << std::endl;
 
     AbstractMaze maze(fs);
-    ConsoleMouse::inst()->seedMaze(&maze);
+    ConsoleMouse mouse;
+    mouse.seedMaze(&maze);
 
     unsigned int i = 0;
-    while (ConsoleMouse::inst()->inBounds() && i < path.length()) {
-      ConsoleMouse::inst()->print_maze_mouse();
-      ConsoleMouse::inst()->internalTurnToFace(char_to_dir(path.at(i++)));
-      ConsoleMouse::inst()->internalForward();
+    while (mouse.inBounds() && i < path.length()) {
+      mouse.print_maze_mouse();
+      mouse.internalTurnToFace(char_to_dir(path.at(i++)));
+      mouse.internalForward();
       std::cin.get();
     }
 
-    ConsoleMouse::inst()->print_maze_mouse();
+    mouse.print_maze_mouse();
     fs.close();
     return EXIT_SUCCESS;
   } else {
@@ -5,58 +5,66 @@
 #include <common/commands/SolveCommand.h>
 #include <console/ConsoleMouse.h>
 #include <console/ConsoleTimer.h>
-#include <common/core/Flood.h>
+#include <common/core/Solver.h>
 #include <cstring>
 #include <common/core/util.h>
 
 int main(int argc, char *argv[]) {
 
   std::string maze_file;
-  bool rand = false;
-  if (argc <= 1) {
-    rand = true;
-    printf("Using random maze\n");
-  }
-  else if (argc == 2) {
-    if (strncmp(argv[1], "-q", 2) == 0) {
+  Solver::Type solver_type = Solver::Type::FLOOD;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "-q", 2) == 0) {
       GlobalProgramSettings.quiet = true;
-      rand = true;
+    }
+    else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+      if (!Solver::parseType(argv[++i], &solver_type)) {
+        printf("unknown solver [%s]\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    }
+    else if (argv[i][0] == '-' || !maze_file.empty()) {
+      printf("USAGE: ConsoleSolve [-q] [-a flood|astar|wallfollow] [maze.mz]\n");
+      return EXIT_FAILURE;
     }
     else {
-      maze_file= std::string(argv[1]);
+      maze_file = std::string(argv[i]);
     }
   }
-  else if (argc == 3) {
-    maze_file = std::string(argv[2]);
-    GlobalProgramSettings.quiet = true;
+
+  bool rand = maze_file.empty();
+  if (rand && !GlobalProgramSettings.quiet) {
+    printf("Using random maze\n");
   }
 
   std::ifstream fs;
   fs.open(maze_file, std::ifstream::in);
 
+  AbstractMaze *maze;
   if (rand) {
-    AbstractMaze maze = AbstractMaze::gen_random_legal_maze();
-    ConsoleMouse::inst()->seedMaze(&maze);
+    maze = new AbstractMaze(AbstractMaze::gen_random_legal_maze());
   } else {
     if (fs.good()) {
-      AbstractMaze m(fs);
-      ConsoleMouse::inst()->seedMaze(&m);
+      maze = new AbstractMaze(fs);
     } else {
         printf("error opening maze file!\n");
       fs.close();
       return EXIT_FAILURE;
     }
   }
+  ConsoleMouse mouse;
+  mouse.seedMaze(maze);
+
   ConsoleTimer timer;
-  Command::setTimerImplementation(&timer);
+  RobotContext context{&mouse, &timer};
 
   Scheduler *scheduler;
-  Flood *flood = new Flood(ConsoleMouse::inst());
-  scheduler = new Scheduler(new SolveCommand(flood));
+  Solver *solver = Solver::make(solver_type, &mouse);
+  scheduler = new Scheduler(new SolveCommand(&context, solver), context.timer);
 
   while (!scheduler->run());
 
-  if (flood->isSolvable()) {
+  if (solver->isSolvable()) {
     return EXIT_SUCCESS;
   } else {
     return EXIT_FAILURE;
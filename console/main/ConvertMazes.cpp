@@ -0,0 +1,129 @@
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include <common/core/AbstractMaze.h>
+#include <common/core/MazeFile.h>
+
+/**
+ * Converts between .mz text mazes and binary maze files (see MazeFile.h), which hold many mazes in one file and load
+ * without parsing. SolveBenchmark takes either.
+ */
+
+namespace {
+
+void usage() {
+  printf("USAGE: ConvertMazes -o mazes.mzb maze.mz ...      pack text mazes into a maze file\n");
+  printf("       ConvertMazes -o mazes.mzb -r n [-s seed]   pack n random mazes into a maze file\n");
+  printf("       ConvertMazes -x mazes.mzb directory        unpack a maze file into directory/name.mz\n");
+  printf("       ConvertMazes -l mazes.mzb                  list the mazes in a maze file\n");
+}
+
+/// \brief the file name without its directory or extension
+std::string base_name(const std::string &path) {
+  size_t start = path.find_last_of("/\\");
+  start = start == std::string::npos ? 0 : start + 1;
+  size_t end = path.find_last_of('.');
+  if (end == std::string::npos || end < start) {
+    end = path.size();
+  }
+  return path.substr(start, end - start);
+}
+
+int pack(const std::string &out_file, int argc, char *argv[], int first) {
+  unsigned int random_count = 0;
+  unsigned int seed = (unsigned int) time(0);
+  MazeFileWriter writer;
+  if (!writer.open(out_file)) {
+    printf("error opening file: [%s]\n", out_file.c_str());
+    return EXIT_FAILURE;
+  }
+
+  for (int i = first; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg == "-r" && i + 1 < argc) {
+      random_count = (unsigned int) atoi(argv[++i]);
+    } else if (arg == "-s" && i + 1 < argc) {
+      seed = (unsigned int) atoi(argv[++i]);
+    } else {
+      std::ifstream fs;
+      fs.open(arg, std::ifstream::in);
+      if (!fs.good()) {
+        printf("error opening maze file: [%s]\n", arg.c_str());
+        return EXIT_FAILURE;
+      }
+      AbstractMaze maze(fs);
+      writer.add(MazeRecord::from_maze(&maze, base_name(arg)));
+    }
+  }
+
+  if (random_count > 0) {
+    for (unsigned int i = 0; i < random_count; i++) {
+      AbstractMaze maze = AbstractMaze::gen_random_legal_maze(seed, i);
+      writer.add(MazeRecord::from_maze(&maze, "random_" + std::to_string(seed) + "_" + std::to_string(i)));
+    }
+  }
+
+  if (!writer.close()) {
+    printf("error writing file: [%s]\n", out_file.c_str());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+int unpack(const std::string &in_file, const std::string &directory) {
+  MazeFile file;
+  if (!file.open(in_file)) {
+    printf("error opening maze file: [%s]\n", in_file.c_str());
+    return EXIT_FAILURE;
+  }
+
+  AbstractMaze maze;
+  std::string buff;
+  buff.resize(smartmouse::maze::BUFF_SIZE);
+  for (unsigned int i = 0; i < file.count(); i++) {
+    std::string out_file = directory + "/" + file[i].get_name() + ".mz";
+    std::ofstream fs;
+    fs.open(out_file, std::ofstream::out);
+    if (!fs.good()) {
+      printf("error opening file: [%s]\n", out_file.c_str());
+      return EXIT_FAILURE;
+    }
+    file[i].to_abstract_maze(&maze);
+    maze.print_maze_str(&buff[0]);
+    fs << buff.c_str() << std::endl;
+  }
+  return EXIT_SUCCESS;
+}
+
+int list(const std::string &in_file) {
+  MazeFile file;
+  if (!file.open(in_file)) {
+    printf("error opening maze file: [%s]\n", in_file.c_str());
+    return EXIT_FAILURE;
+  }
+
+  printf("%-32s %6s\n", "name", "route");
+  for (unsigned int i = 0; i < file.count(); i++) {
+    if (file[i].route_length == MazeRecord::NO_ROUTE) {
+      printf("%-32s %6s\n", file[i].get_name().c_str(), "none");
+    } else {
+      printf("%-32s %6u\n", file[i].get_name().c_str(), file[i].route_length);
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  if (argc >= 3 && strcmp(argv[1], "-o") == 0) {
+    return pack(argv[2], argc, argv, 3);
+  } else if (argc == 4 && strcmp(argv[1], "-x") == 0) {
+    return unpack(argv[2], argv[3]);
+  } else if (argc == 3 && strcmp(argv[1], "-l") == 0) {
+    return list(argv[2]);
+  }
+  usage();
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,81 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <common/core/Telemetry.h>
+
+/**
+ * Decodes the binary telemetry the robot sends over Serial1 when it's built with PROFILE.
+ * The loop phase timings are written to stdout as "Sensors, 82" lines, which is what
+ * docs/profiling_and_analysis/analyze_profile_csv.py reads. With -s, the range, pose, and PID records are written to
+ * another csv with their timestamps.
+ */
+
+int main(int argc, char *argv[]) {
+  std::string in_file, state_file;
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg == "-s" && i + 1 < argc) {
+      state_file = argv[++i];
+    } else if (arg[0] == '-' || !in_file.empty()) {
+      in_file.clear();
+      break;
+    } else {
+      in_file = arg;
+    }
+  }
+  if (in_file.empty()) {
+    fprintf(stderr, "USAGE: DecodeTelemetry [-s state.csv] telemetry.bin > profile.csv\n");
+    return EXIT_FAILURE;
+  }
+
+  std::ifstream in(in_file, std::ifstream::in | std::ifstream::binary);
+  if (!in.good()) {
+    fprintf(stderr, "error opening telemetry file [%s]\n", in_file.c_str());
+    return EXIT_FAILURE;
+  }
+
+  FILE *state_out = nullptr;
+  if (!state_file.empty()) {
+    state_out = fopen(state_file.c_str(), "w");
+    if (!state_out) {
+      fprintf(stderr, "error opening state file [%s]\n", state_file.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+
+  TelemetryDecoder decoder;
+  unsigned long records = 0, dropped = 0;
+  for (std::istreambuf_iterator<char> it(in), end; it != end; ++it) {
+    if (!decoder.feed((uint8_t) *it)) {
+      continue;
+    }
+    records++;
+
+    const TelemetryRecord &record = decoder.record;
+    switch (record.kind) {
+      case TelemetryKind::PHASE:
+        printf("%s, %0.0f\n", loop_phase_name((LoopPhase) record.id), record.values[0]);
+        break;
+      case TelemetryKind::DROPPED:
+        dropped += (unsigned long) record.values[0];
+        break;
+      default:
+        if (state_out) {
+          fprintf(state_out, "%s, %u, %u", telemetry_kind_name(record.kind), record.id, record.t_us);
+          for (unsigned int i = 0; i < record.count; i++) {
+            fprintf(state_out, ", %0.6f", record.values[i]);
+          }
+          fprintf(state_out, "\n");
+        }
+        break;
+    }
+  }
+
+  if (state_out) {
+    fclose(state_out);
+  }
+  fprintf(stderr, "%lu records, %lu dropped on the robot, %lu bad frames\n", records, dropped, decoder.bad_frames);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <common/core/AbstractMaze.h>
+#include <common/core/WallGrid.h>
+
+/**
+ * Compares the recursive and breadth first flood fill on each maze file given.
+ * Reports how many node visits and how much time each method needs to flood fill from the origin to the center.
+ * The same fill on the bit packed WallGrid is timed too.
+ */
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printf("USAGE: FloodFillBenchmark [-n iterations] maze.mz [maze.mz ...]\n");
+    return EXIT_FAILURE;
+  }
+
+  int first_maze_arg = 1;
+  unsigned int iterations = 1000;
+  if (argc > 3 && std::string(argv[1]) == "-n") {
+    iterations = (unsigned int) atoi(argv[2]);
+    first_maze_arg = 3;
+  }
+
+  std::vector<AbstractMaze *> mazes;
+  std::vector<const char *> names;
+  for (int i = first_maze_arg; i < argc; i++) {
+    std::ifstream fs;
+    fs.open(argv[i], std::ifstream::in);
+    if (!fs.good()) {
+      printf("error opening maze file [%s]\n", argv[i]);
+      return EXIT_FAILURE;
+    }
+
+    // a maze of another size can't be benchmarked, but shouldn't stop the others from being run
+    try {
+      mazes.push_back(new AbstractMaze(fs));
+      names.push_back(argv[i]);
+    } catch (const std::invalid_argument &e) {
+      printf("skipping [%s]: %s\n", argv[i], e.what());
+    }
+    fs.close();
+  }
+
+  printf("%-24s %12s %12s %14s %14s %14s %8s\n", "maze", "rec visits", "bfs visits", "rec us/fill", "bfs us/fill",
+         "grid us/fill", "match");
+
+  bool all_match = true;
+  for (unsigned int i = 0; i < mazes.size(); i++) {
+    AbstractMaze &maze = *mazes[i];
+
+    const AbstractMaze::FloodFillMethod methods[2] = {AbstractMaze::FloodFillMethod::RECURSIVE,
+                                                      AbstractMaze::FloodFillMethod::BFS};
+    route_t routes[2];
+    unsigned int visits[2];
+    double us_per_fill[2];
+    for (unsigned int m = 0; m < 2; m++) {
+      maze.flood_fill_method = methods[m];
+      auto t0 = std::chrono::steady_clock::now();
+      for (unsigned int it = 0; it < iterations; it++) {
+        maze.flood_fill_from_origin_to_center(&routes[m]);
+      }
+      auto t1 = std::chrono::steady_clock::now();
+      visits[m] = maze.flood_fill_visits;
+      us_per_fill[m] = std::chrono::duration<double, std::micro>(t1 - t0).count() / iterations;
+    }
+
+    WallGrid grid(&maze);
+    route_t grid_route;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned int it = 0; it < iterations; it++) {
+      grid.flood_fill_from_origin_to_center(&grid_route);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double grid_us_per_fill = std::chrono::duration<double, std::micro>(t1 - t0).count() / iterations;
+
+    bool match = route_to_string(routes[0]) == route_to_string(routes[1]);
+    all_match &= match;
+    printf("%-24s %12u %12u %14.2f %14.2f %14.2f %8s\n", names[i], visits[0], visits[1],
+           us_per_fill[0], us_per_fill[1], grid_us_per_fill, match ? "yes" : "NO");
+  }
+
+  return all_match ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,16 +1,108 @@
 #include <console/ConsoleMouse.h>
+#include <common/core/MazeFile.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <thread>
+#include <vector>
 
-int main(int argc, char *argv[]) {
+/**
+ * Prints a random maze and optionally saves it as a .mz file, or with -n generates a whole batch in parallel into a
+ * binary maze file. Maze i of a batch is always stream i of the seed, so a batch is the same no matter how many
+ * threads made it, and any single maze in it can be made again with gen_random_legal_maze(seed, i).
+ */
+
+namespace {
+
+/// \brief mazes generated before they're written out, so a batch of millions doesn't have to fit in memory
+constexpr unsigned int CHUNK_SIZE = 1 << 16;
+
+void usage() {
+  printf("USAGE: GenerateMaze [-s seed] [maze.mz]\n");
+  printf("       GenerateMaze -n count [-j threads] [-s seed] -o mazes.mzb\n");
+}
+
+int generate_batch(unsigned int count, unsigned int threads, unsigned int seed, const std::string &out_file) {
+  MazeFileWriter writer;
+  if (!writer.open(out_file)) {
+    std::cout << "error opening file: [" << out_file << "]" << std::endl;
+    return EXIT_FAILURE;
+  }
 
-  srand(time(0));
+  auto t0 = std::chrono::steady_clock::now();
+  std::vector<MazeRecord> chunk(std::min(count, CHUNK_SIZE));
+  for (unsigned int chunk_start = 0; chunk_start < count; chunk_start += CHUNK_SIZE) {
+    unsigned int chunk_count = std::min(CHUNK_SIZE, count - chunk_start);
+    std::atomic<unsigned int> next{0};
+    std::vector<std::thread> workers;
+    for (unsigned int w = 0; w < threads; w++) {
+      workers.emplace_back([&]() {
+        unsigned int i;
+        while ((i = next++) < chunk_count) {
+          unsigned int stream = chunk_start + i;
+          AbstractMaze maze = AbstractMaze::gen_random_legal_maze(seed, stream);
+          chunk[i] = MazeRecord::from_maze(&maze, std::to_string(seed) + "_" + std::to_string(stream));
+        }
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+
+    for (unsigned int i = 0; i < chunk_count; i++) {
+      writer.add(chunk[i]);
+    }
+  }
+
+  if (!writer.close()) {
+    std::cout << "error writing file: [" << out_file << "]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  printf("generated %u mazes with seed %u on %u threads in %.2fs (%.0f mazes/s)\n", count, seed, threads, seconds,
+         count / seconds);
+  return EXIT_SUCCESS;
+}
 
+}
+
+int main(int argc, char *argv[]) {
+  unsigned int seed = (unsigned int) time(0);
+  unsigned int count = 0;
+  unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
   std::string maze_file;
+  std::string batch_file;
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg == "-s" && i + 1 < argc) {
+      seed = (unsigned int) atoi(argv[++i]);
+    } else if (arg == "-n" && i + 1 < argc) {
+      count = (unsigned int) atoi(argv[++i]);
+    } else if (arg == "-j" && i + 1 < argc) {
+      threads = std::max(1, atoi(argv[++i]));
+    } else if (arg == "-o" && i + 1 < argc) {
+      batch_file = argv[++i];
+    } else if (arg[0] == '-' || !maze_file.empty()) {
+      usage();
+      return EXIT_FAILURE;
+    } else {
+      maze_file = arg;
+    }
+  }
+
+  if (count > 0) {
+    if (batch_file.empty() || !maze_file.empty()) {
+      usage();
+      return EXIT_FAILURE;
+    }
+    return generate_batch(count, threads, seed, batch_file);
+  }
+
   std::ofstream fs;
   bool save = false;
-  if (argc == 2) {
-    maze_file = argv[1];
-
+  if (!maze_file.empty()) {
     fs.open(maze_file, std::ofstream::out);
 
     if (fs.good()) {
@@ -24,7 +116,7 @@ int main(int argc, char *argv[]) {
   }
 
   //generate maze
-  AbstractMaze maze = AbstractMaze::gen_random_legal_maze();
+  AbstractMaze maze = AbstractMaze::gen_random_legal_maze(seed);
 
   maze.print_maze();
 
@@ -32,8 +124,7 @@ int main(int argc, char *argv[]) {
     std::string buff;
     buff.resize(smartmouse::maze::BUFF_SIZE);
     maze.print_maze_str(&buff[0]);
-    fs << buff << std::endl;
+    fs << buff.c_str() << std::endl;
     fs.close();
   }
 }
-
@@ -15,7 +15,6 @@ int main(int argc, char *argv[]) {
 
   if (fs.good()) {
     AbstractMaze maze(fs);
-    ConsoleMouse::inst()->seedMaze(&maze);
     maze.print_maze();
     fs.close();
     return EXIT_SUCCESS;
@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <common/core/AbstractMaze.h>
+#include <common/core/DiagonalPlanner.h>
+#include <common/core/MazeFile.h>
+#include <common/core/RunPlanner.h>
+#include <common/core/Solver.h>
+#include <common/KinematicController/RobotConfig.h>
+#include <console/ConsoleMouse.h>
+
+/**
+ * Solves a batch of mazes with each solver and reports how fast and how well they do.
+ * Mazes are either loaded from the files given or generated with gen_random_legal_maze. Files ending in .mzb are
+ * binary maze files (see MazeFile.h and ConvertMazes), which are mapped instead of parsed, so big corpora load
+ * instantly. The mazes are split over all cores with a work stealing pool, and every worker has its own ConsoleMouse,
+ * solver, and true maze that each record is unpacked into, so nothing is shared between threads except the records,
+ * which are only read.
+ * For Flood and AStar, it also estimates how long a speed run would take along the route it found, along the quickest
+ * route that SpeedRun plans through the same explored maze, and along the quickest route that cuts diagonals through
+ * it. The estimates come from DiagonalPlanner's cost model, nothing is driven, and no command drives a diagonal route
+ * yet, so "diag est" is what cutting diagonals could reach rather than a speed run result.
+ * Every planNextStep is timed, and exp/step is how many cells it expanded on average.
+ */
+
+namespace {
+
+/// \brief a mouse that drives more than this has gone around in a circle, which is how wall following fails
+constexpr unsigned int MAX_STEPS = 4 * smartmouse::maze::SIZE * smartmouse::maze::SIZE;
+
+/// \brief what one worker measured. Workers never touch each other's stats, they're merged at the end
+struct SolveStats {
+  unsigned int solved = 0;
+  unsigned long cells_explored = 0;
+  unsigned long steps = 0;
+  unsigned long route_length = 0;
+  unsigned long expansions = 0;
+  // speed run times estimated with DiagonalPlanner's cost model
+  double run_s = 0;
+  double timed_run_s = 0;
+  double diagonal_run_s = 0;
+  std::vector<double> plan_us;
+};
+
+/**
+ * \brief every worker has its own deque of maze indices. Workers take from the back of their own deque, and when
+ * it's empty they steal from the front of someone else's. No work is added after start, so a worker is done when
+ * every deque is empty.
+ */
+class WorkStealingQueues {
+public:
+  WorkStealingQueues(unsigned int workers, unsigned int jobs) : queues(workers) {
+    // deal out contiguous blocks so each worker mostly stays in its own part of the maze list
+    for (unsigned int i = 0; i < jobs; i++) {
+      queues[i * workers / jobs].items.push_back(i);
+    }
+  }
+
+  bool next(unsigned int worker, unsigned int *job) {
+    if (queues[worker].pop_back(job)) {
+      return true;
+    }
+    for (unsigned int i = 1; i < queues.size(); i++) {
+      if (queues[(worker + i) % queues.size()].pop_front(job)) {
+        steals++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::atomic<unsigned int> steals{0};
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<unsigned int> items;
+
+    bool pop_back(unsigned int *job) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (items.empty()) {
+        return false;
+      }
+      *job = items.back();
+      items.pop_back();
+      return true;
+    }
+
+    bool pop_front(unsigned int *job) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (items.empty()) {
+        return false;
+      }
+      *job = items.front();
+      items.pop_front();
+      return true;
+    }
+  };
+
+  std::vector<Queue> queues;
+};
+
+unsigned int route_length(const route_t &route) {
+  unsigned int length = 0;
+  for (motion_primitive_t prim : route) {
+    length += prim.n;
+  }
+  return length;
+}
+
+/// \brief the same loop as Solver::solve, but with every planNextStep timed
+void solve_one(Solver *solver, ConsoleMouse *mouse, Solver::Type type, RunPlanner *run_planner,
+               DiagonalPlanner *planner, SolveStats *stats) {
+  // the mouse and solver are reused for every maze this worker gets, so start over from a blank maze
+  mouse->maze->disconnect_all_neighbors_in_maze();
+  mouse->maze->fastest_route.clear();
+  solver->solvable = true;
+  solver->setup();
+
+  bool explored[smartmouse::maze::SIZE][smartmouse::maze::SIZE] = {};
+  explored[mouse->getRow()][mouse->getCol()] = true;
+  unsigned int cells_explored = 1;
+
+  route_t traveled;
+  unsigned int steps = 0;
+  while (!solver->isFinished()) {
+    if (steps == MAX_STEPS) {
+      solver->solvable = false;
+      break;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    motion_primitive_t prim = solver->planNextStep();
+    auto t1 = std::chrono::steady_clock::now();
+    stats->plan_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+    stats->expansions += solver->expansions;
+
+    if (prim.d == Direction::INVALID) {
+      break;
+    }
+    mouse->internalTurnToFace(prim.d);
+    mouse->internalForward();
+    insert_motion_primitive_back(&traveled, {1, prim.d});
+    steps++;
+
+    if (!explored[mouse->getRow()][mouse->getCol()]) {
+      explored[mouse->getRow()][mouse->getCol()] = true;
+      cells_explored++;
+    }
+  }
+  solver->teardown();
+
+  if (!solver->isSolvable()) {
+    return;
+  }
+
+  stats->solved++;
+  stats->cells_explored += cells_explored;
+  stats->steps += steps;
+  // wall following has no better route than the way it went, the others know the shortest route through what they saw
+  if (type != Solver::Type::WALL_FOLLOW) {
+    stats->route_length += route_length(mouse->maze->fastest_route);
+
+    route_t timed_route;
+    run_planner->plan(&timed_route, 0, 0, Direction::E, smartmouse::maze::CENTER, smartmouse::maze::CENTER);
+    diagonal_route_t diagonal_route;
+    planner->plan(&diagonal_route, 0, 0, Direction::E, smartmouse::maze::CENTER, smartmouse::maze::CENTER);
+    stats->run_s += planner->route_time(DiagonalPlanner::from_route(mouse->maze->fastest_route), Direction::E);
+    stats->timed_run_s += planner->route_time(DiagonalPlanner::from_route(timed_route), Direction::E);
+    stats->diagonal_run_s += planner->route_time(diagonal_route, Direction::E);
+  } else {
+    stats->route_length += route_length(traveled);
+  }
+}
+
+double percentile(std::vector<double> &samples, double p) {
+  if (samples.empty()) {
+    return 0;
+  }
+  auto nth = samples.begin() + (long) (p * (samples.size() - 1));
+  std::nth_element(samples.begin(), nth, samples.end());
+  return *nth;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  unsigned int maze_count = 1000;
+  unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+  unsigned int seed = (unsigned int) time(0);
+  std::vector<std::string> maze_files;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg == "-n" && i + 1 < argc) {
+      maze_count = (unsigned int) atoi(argv[++i]);
+    } else if (arg == "-j" && i + 1 < argc) {
+      threads = std::max(1, atoi(argv[++i]));
+    } else if (arg == "-s" && i + 1 < argc) {
+      seed = (unsigned int) atoi(argv[++i]);
+    } else if (arg[0] == '-') {
+      printf("USAGE: SolveBenchmark [-n mazes] [-j threads] [-s seed] [maze.mz | mazes.mzb ...]\n");
+      printf("with no maze files, n random mazes are generated from the seed\n");
+      return EXIT_FAILURE;
+    } else {
+      maze_files.push_back(arg);
+    }
+  }
+
+  // text and random mazes are packed into records too, so the workers only ever see records
+  std::vector<MazeRecord> packed;
+  std::vector<std::unique_ptr<MazeFile>> maze_file_maps;
+  std::vector<const MazeRecord *> mazes;
+  if (maze_files.empty()) {
+    for (unsigned int i = 0; i < maze_count; i++) {
+      AbstractMaze maze = AbstractMaze::gen_random_legal_maze(seed, i);
+      packed.push_back(MazeRecord::from_maze(&maze, ""));
+    }
+    printf("generated %u mazes with seed %u\n", maze_count, seed);
+  } else {
+    for (auto maze_file : maze_files) {
+      if (maze_file.size() > 4 && maze_file.compare(maze_file.size() - 4, 4, ".mzb") == 0) {
+        maze_file_maps.emplace_back(new MazeFile());
+        if (!maze_file_maps.back()->open(maze_file)) {
+          printf("error opening maze file [%s]\n", maze_file.c_str());
+          return EXIT_FAILURE;
+        }
+        for (unsigned int i = 0; i < maze_file_maps.back()->count(); i++) {
+          mazes.push_back(&(*maze_file_maps.back())[i]);
+        }
+        continue;
+      }
+
+      std::ifstream fs;
+      fs.open(maze_file, std::ifstream::in);
+      if (!fs.good()) {
+        printf("error opening maze file [%s]\n", maze_file.c_str());
+        return EXIT_FAILURE;
+      }
+      try {
+        AbstractMaze maze(fs);
+        packed.push_back(MazeRecord::from_maze(&maze, maze_file));
+      } catch (const std::invalid_argument &e) {
+        printf("skipping [%s]: %s\n", maze_file.c_str(), e.what());
+      }
+      fs.close();
+    }
+  }
+  for (const MazeRecord &record : packed) {
+    mazes.push_back(&record);
+  }
+
+  printf("%-12s %8s %8s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %8s\n", "solver", "mazes",
+         "solved", "solves/s", "explored", "steps", "route", "run est", "timed est", "diag est", "exp/step", "p50 us", "p90 us",
+         "p99 us", "max us", "steals");
+
+  RunLimits limits = {smartmouse::kc::MAX_SPEED_CUPS,
+                      smartmouse::kc::MAX_SPEED_CUPS * smartmouse::kc::DIAGONAL_SPEED_SCALE,
+                      smartmouse::kc::MAX_ACCEL_CUPSS, smartmouse::kc::TURN_SPEED_CUPS, smartmouse::kc::TURN_RADIUS_CU};
+
+  for (Solver::Type type : Solver::TYPES) {
+    WorkStealingQueues queues(threads, (unsigned int) mazes.size());
+    std::vector<SolveStats> stats(threads);
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned int w = 0; w < threads; w++) {
+      workers.emplace_back([&, w]() {
+        ConsoleMouse mouse;
+        std::unique_ptr<Solver> solver(Solver::make(type, &mouse));
+        RunPlanner run_planner(mouse.maze, limits);
+        DiagonalPlanner planner(mouse.maze, limits);
+        AbstractMaze true_maze;
+        mouse.seedMaze(&true_maze);
+        unsigned int job;
+        while (queues.next(w, &job)) {
+          mazes[job]->to_abstract_maze(&true_maze);
+          solve_one(solver.get(), &mouse, type, &run_planner, &planner, &stats[w]);
+        }
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(t1 - t0).count();
+
+    SolveStats total;
+    for (auto &s : stats) {
+      total.solved += s.solved;
+      total.cells_explored += s.cells_explored;
+      total.steps += s.steps;
+      total.route_length += s.route_length;
+      total.expansions += s.expansions;
+      total.run_s += s.run_s;
+      total.timed_run_s += s.timed_run_s;
+      total.diagonal_run_s += s.diagonal_run_s;
+      total.plan_us.insert(total.plan_us.end(), s.plan_us.begin(), s.plan_us.end());
+    }
+    double solved = std::max(1u, total.solved);
+
+    double plans = std::max<size_t>(1, total.plan_us.size());
+
+    printf("%-12s %8zu %8u %10.1f %10.1f %10.1f %10.1f %10.2f %10.2f %10.2f %10.1f %10.2f %10.2f %10.2f %10.2f %8u\n",
+           Solver::name(type), mazes.size(), total.solved, mazes.size() / seconds, total.cells_explored / solved,
+           total.steps / solved, total.route_length / solved, total.run_s / solved, total.timed_run_s / solved,
+           total.diagonal_run_s / solved, total.expansions / plans,
+           percentile(total.plan_us, 0.5), percentile(total.plan_us, 0.9),
+           percentile(total.plan_us, 0.99), percentile(total.plan_us, 1.0), queues.steals.load());
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+#include <common/KinematicController/TrajectoryPlanner.h>
+
+/**
+ * Times TrajectoryPlanner on random turns, with two waypoints (one segment) and with a third in the middle (two
+ * segments). For comparison, the same systems are also solved the way the planner used to, with a full Jacobi SVD of a
+ * dynamically sized matrix, and it checks how far the trajectories miss their waypoints.
+ */
+
+namespace {
+
+constexpr unsigned int TURNS = 64;
+
+double random_between(double lo, double hi) {
+  return lo + (hi - lo) * rand() / RAND_MAX;
+}
+
+Waypoint random_waypoint(double time) {
+  return {time, GlobalState(GlobalPose(random_between(0, 2), random_between(0, 2), random_between(-M_PI, M_PI)),
+                            random_between(0.5, 3))};
+}
+
+/// \brief the old way, which doesn't care what shape the system is. The targets are whatever the segment hits
+Trajectory::Coefficients svd_solve(const Trajectory::Segment &segment) {
+  Eigen::MatrixXd A = TrajectoryPlanner::segmentConstraints();
+  Eigen::MatrixXd b = A * segment.coefficients;
+  return A.jacobiSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(b);
+}
+
+/// \brief the farthest the trajectory is from any of the waypoints, at the waypoint's time
+double waypoint_miss(const Trajectory &trajectory, const Waypoint *waypoints, unsigned int count) {
+  double miss = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    GlobalPose pose = trajectory.sample(waypoints[i].time).pose;
+    miss = std::max(miss, hypot(pose.col - waypoints[i].state.pose.col, pose.row - waypoints[i].state.pose.row));
+  }
+  return miss;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  unsigned int iterations = 10000;
+  if (argc > 2 && std::string(argv[1]) == "-n") {
+    iterations = (unsigned int) atoi(argv[2]);
+  } else if (argc > 1) {
+    printf("USAGE: TrajectoryBenchmark [-n iterations]\n");
+    return EXIT_FAILURE;
+  }
+
+  srand(0);
+  Waypoint turns[TURNS][3];
+  for (auto &turn : turns) {
+    turn[0] = random_waypoint(0);
+    turn[1] = random_waypoint(0.15);
+    turn[2] = random_waypoint(0.3);
+  }
+
+  printf("%-10s %12s %12s %12s %12s\n", "waypoints", "us/plan", "svd us/plan", "max diff", "max miss");
+  for (unsigned int count : {2u, 3u}) {
+    // the two waypoint plans skip the middle one
+    Waypoint plans[TURNS][3];
+    for (unsigned int i = 0; i < TURNS; i++) {
+      unsigned int n = 0;
+      plans[i][n++] = turns[i][0];
+      if (count == 3) {
+        plans[i][n++] = turns[i][1];
+      }
+      plans[i][n++] = turns[i][2];
+    }
+
+    Trajectory trajectory;
+    double checksum = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < iterations; i++) {
+      const Waypoint *plan = plans[i % TURNS];
+      TrajectoryPlanner planner;
+      for (unsigned int j = 0; j < count; j++) {
+        planner.addWaypoint(plan[j]);
+      }
+      planner.plan(&trajectory);
+      checksum += trajectory.segments[0].coefficients(5, 0);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < iterations; i++) {
+      for (unsigned int j = 0; j < trajectory.segment_count; j++) {
+        checksum -= svd_solve(trajectory.segments[j])(5, 0);
+      }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    // make sure both ways get the same answer, and that it goes through the waypoints
+    double max_diff = 0;
+    double max_miss = 0;
+    for (auto &plan : plans) {
+      TrajectoryPlanner planner;
+      for (unsigned int j = 0; j < count; j++) {
+        planner.addWaypoint(plan[j]);
+      }
+      planner.plan(&trajectory);
+      for (unsigned int j = 0; j < trajectory.segment_count; j++) {
+        Trajectory::Coefficients svd = svd_solve(trajectory.segments[j]);
+        max_diff = std::max(max_diff, (svd - trajectory.segments[j].coefficients).cwiseAbs().maxCoeff());
+      }
+      max_miss = std::max(max_miss, waypoint_miss(trajectory, plan, count));
+    }
+
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / iterations;
+    double svd_us = std::chrono::duration<double, std::micro>(t2 - t1).count() / iterations;
+    printf("%-10u %12.3f %12.3f %12.2e %12.2e\n", count, us, svd_us, max_diff, max_miss);
+    if (checksum == 12345) {
+      // only here so the optimizer can't throw the plans away
+      printf("\n");
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -1,11 +1,26 @@
 #include <common/core/AbstractMaze.h>
 #include <common/core/Direction.h>
 #include <console/ConsoleMouse.h>
+#include <console/ConsoleTimer.h>
 #include <common/core/Mouse.h>
 #include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include <common/core/WallFollow.h>
 #include <common/core/Flood.h>
+#include <common/core/AStar.h>
 #include <common/core/Node.h>
+#include <common/core/DistanceField.h>
+#include <common/core/DistanceCache.h>
+#include <common/core/DiagonalPlanner.h>
+#include <common/core/RunPlanner.h>
+#include <common/core/WallGrid.h>
+#include <common/core/MazeFile.h>
+#include <common/core/Telemetry.h>
+#include <common/commanduino/CommanDuino.h>
+#include <console/commands/Forward.h>
 #include "gtest/gtest.h"
 
 const char *FLOOD_SLN = "1E3S2E2S1W3S2E2N1E1N1E2S2E1S";
@@ -204,6 +219,394 @@ TEST(FloodFillTest, StripedMaze){
   }
 }
 
+TEST(MazeParseTest, RejectsSmallerMaze) {
+  // jank.mz is 12x12, so its rows are too short and there are too few of them
+  std::ifstream fs;
+  fs.open("../../mazes/jank.mz", std::ifstream::in);
+  ASSERT_TRUE(fs.good());
+  EXPECT_THROW(AbstractMaze maze(fs), std::invalid_argument);
+
+  std::istringstream few_rows(std::string(2 * smartmouse::maze::SIZE, '_') + "\n");
+  EXPECT_THROW(AbstractMaze maze(few_rows), std::invalid_argument);
+}
+
+TEST(MazeCopyTest, CopyIsDeep) {
+  AbstractMaze original = AbstractMaze::gen_random_legal_maze(42, 0);
+  AbstractMaze copy(original);
+  EXPECT_TRUE(copy == original);
+  for (unsigned int i = 0; i < smartmouse::maze::SIZE; i++) {
+    for (unsigned int j = 0; j < smartmouse::maze::SIZE; j++) {
+      EXPECT_NE(copy.nodes[i][j], original.nodes[i][j]);
+      for (Node *neighbor : copy.nodes[i][j]->neighbors) {
+        if (neighbor) {
+          EXPECT_EQ(neighbor, copy.nodes[neighbor->row()][neighbor->col()]);
+        }
+      }
+    }
+  }
+
+  // changing the copy leaves the original alone
+  copy.connect_all_neighbors_in_maze();
+  EXPECT_FALSE(copy == original);
+  EXPECT_TRUE(original == AbstractMaze::gen_random_legal_maze(42, 0));
+
+  // assigning replaces the nodes, and moving hands them over
+  copy = original;
+  EXPECT_TRUE(copy == original);
+  Node *first = copy.nodes[0][0];
+  AbstractMaze moved(std::move(copy));
+  EXPECT_EQ(moved.nodes[0][0], first);
+  EXPECT_EQ(copy.nodes[0][0], nullptr);
+}
+
+// every 16x16 maze in mazes/ (jank.mz is 12x12)
+const char *ALL_MAZE_FILES[] = {"16x16.mz", "16x16_2.mz", "16x16_3.mz", "competition_16.mz", "competition_17.mz",
+                                "death.mz", "easy.mz", "empty.mz", "hard.mz", "impossible.mz", "out.mz", "r1.mz",
+                                "stripes.mz", "temp.mz", "usa.mz"};
+
+TEST(FloodFillTest, BFSMatchesRecursive) {
+  for (auto maze_name : ALL_MAZE_FILES) {
+    std::string maze_file = std::string("../../mazes/") + maze_name;
+    std::ifstream fs;
+    fs.open(maze_file, std::ifstream::in);
+    ASSERT_TRUE(fs.good()) << maze_file;
+    AbstractMaze maze(fs);
+    fs.close();
+
+    maze.flood_fill_method = AbstractMaze::FloodFillMethod::RECURSIVE;
+    route_t recursive_route;
+    bool recursive_solvable = maze.flood_fill_from_origin_to_center(&recursive_route);
+    int recursive_weights[smartmouse::maze::SIZE][smartmouse::maze::SIZE];
+    for (unsigned int i = 0; i < smartmouse::maze::SIZE; i++) {
+      for (unsigned int j = 0; j < smartmouse::maze::SIZE; j++) {
+        recursive_weights[i][j] = maze.nodes[i][j]->weight;
+      }
+    }
+
+    maze.flood_fill_method = AbstractMaze::FloodFillMethod::BFS;
+    route_t bfs_route;
+    bool bfs_solvable = maze.flood_fill_from_origin_to_center(&bfs_route);
+
+    EXPECT_EQ(recursive_solvable, bfs_solvable) << maze_file;
+    EXPECT_EQ(route_to_string(recursive_route), route_to_string(bfs_route)) << maze_file;
+
+    // every reachable node is visited exactly once
+    unsigned int reachable = 0;
+    for (unsigned int i = 0; i < smartmouse::maze::SIZE; i++) {
+      for (unsigned int j = 0; j < smartmouse::maze::SIZE; j++) {
+        EXPECT_EQ(recursive_weights[i][j], maze.nodes[i][j]->weight) << maze_file;
+        if (maze.nodes[i][j]->known) {
+          reachable++;
+        }
+      }
+    }
+    EXPECT_EQ(reachable, maze.flood_fill_visits) << maze_file;
+  }
+}
+
+TEST(WallGridTest, Size) {
+  EXPECT_LE(sizeof(WallGrid), smartmouse::maze::SIZE * smartmouse::maze::SIZE * 2 / 8);
+}
+
+TEST(WallGridTest, ConnectAndDisconnect) {
+  WallGrid grid;
+  EXPECT_TRUE(grid.is_wall(0, 0, Direction::S));
+  grid.connect_neighbor(0, 0, Direction::S);
+  EXPECT_FALSE(grid.is_wall(0, 0, Direction::S));
+  EXPECT_FALSE(grid.is_wall(1, 0, Direction::N));
+  grid.disconnect_neighbor(1, 0, Direction::N);
+  EXPECT_TRUE(grid.is_wall(0, 0, Direction::S));
+
+  // the outside of the maze is always a wall
+  grid.connect_all_neighbors_in_maze();
+  for (unsigned int i = 0; i < smartmouse::maze::SIZE; i++) {
+    EXPECT_TRUE(grid.is_wall(0, i, Direction::N));
+    EXPECT_TRUE(grid.is_wall(i, 0, Direction::W));
+    EXPECT_TRUE(grid.is_wall(smartmouse::maze::SIZE - 1, i, Direction::S));
+    EXPECT_TRUE(grid.is_wall(i, smartmouse::maze::SIZE - 1, Direction::E));
+  }
+  EXPECT_FALSE(grid.is_wall(5, 5, Direction::W));
+}
+
+TEST(WallGridTest, MatchesAbstractMaze) {
+  for (auto maze_name : ALL_MAZE_FILES) {
+    std::string maze_file = std::string("../../mazes/") + maze_name;
+    std::ifstream fs;
+    fs.open(maze_file, std::ifstream::in);
+    ASSERT_TRUE(fs.good()) << maze_file;
+    AbstractMaze maze(fs);
+    fs.close();
+
+    WallGrid grid(&maze);
+    AbstractMaze round_trip;
+    grid.to_abstract_maze(&round_trip);
+    EXPECT_TRUE(maze == round_trip) << maze_file;
+
+    for (unsigned int i = 0; i < smartmouse::maze::SIZE; i++) {
+      for (unsigned int j = 0; j < smartmouse::maze::SIZE; j++) {
+        for (Direction d = Direction::First; d < Direction::Last; d++) {
+          EXPECT_EQ(maze.nodes[i][j]->wall(d), grid.is_wall(i, j, d)) << maze_file;
+        }
+      }
+    }
+
+    route_t maze_route;
+    route_t grid_route;
+    bool maze_solvable = maze.flood_fill_from_origin_to_center(&maze_route);
+    bool grid_solvable = grid.flood_fill_from_origin_to_center(&grid_route);
+    EXPECT_EQ(maze_solvable, grid_solvable) << maze_file;
+    if (maze_solvable) {
+      EXPECT_EQ(route_to_string(maze_route), route_to_string(grid_route)) << maze_file;
+    }
+  }
+}
+
+TEST(MazeFileTest, RoundTripTest) {
+  std::string path = "maze_file_test.mzb";
+  std::vector<AbstractMaze *> mazes;
+  MazeFileWriter writer;
+  ASSERT_TRUE(writer.open(path));
+  for (auto maze_name : ALL_MAZE_FILES) {
+    std::ifstream fs;
+    fs.open(std::string("../../mazes/") + maze_name, std::ifstream::in);
+    ASSERT_TRUE(fs.good()) << maze_name;
+    mazes.push_back(new AbstractMaze(fs));
+    writer.add(MazeRecord::from_maze(mazes.back(), maze_name));
+  }
+  ASSERT_TRUE(writer.close());
+
+  MazeFile file;
+  ASSERT_TRUE(file.open(path));
+  ASSERT_EQ(file.count(), mazes.size());
+  for (unsigned int i = 0; i < file.count(); i++) {
+    EXPECT_EQ(file[i].get_name(), ALL_MAZE_FILES[i]);
+    EXPECT_TRUE(file[i].to_wall_grid() == WallGrid(mazes[i])) << ALL_MAZE_FILES[i];
+
+    AbstractMaze round_trip;
+    file[i].to_abstract_maze(&round_trip);
+    EXPECT_TRUE(*mazes[i] == round_trip) << ALL_MAZE_FILES[i];
+
+    route_t route;
+    if (mazes[i]->flood_fill_from_origin_to_center(&route)) {
+      unsigned int length = 0;
+      for (motion_primitive_t prim : route) {
+        length += prim.n;
+      }
+      EXPECT_EQ(file[i].route_length, length) << ALL_MAZE_FILES[i];
+    } else {
+      EXPECT_EQ(file[i].route_length, MazeRecord::NO_ROUTE) << ALL_MAZE_FILES[i];
+    }
+  }
+
+  for (auto maze : mazes) {
+    delete maze;
+  }
+  file.close();
+  std::remove(path.c_str());
+}
+
+TEST(MazeFileTest, RejectTest) {
+  MazeFile file;
+  EXPECT_FALSE(file.open("does_not_exist.mzb"));
+  EXPECT_FALSE(file.open("../../mazes/16x16.mz"));
+
+  // a maze file that says it has more mazes than it does
+  std::string path = "maze_file_reject_test.mzb";
+  MazeFileWriter writer;
+  ASSERT_TRUE(writer.open(path));
+  AbstractMaze maze;
+  writer.add(MazeRecord::from_maze(&maze, "walls"));
+  ASSERT_TRUE(writer.close());
+  ASSERT_TRUE(file.open(path));
+  EXPECT_EQ(file.count(), 1u);
+  EXPECT_EQ(file[0].route_length, MazeRecord::NO_ROUTE);
+  file.close();
+
+  std::fstream fs(path, std::fstream::in | std::fstream::out | std::fstream::binary);
+  uint32_t count = 2;
+  fs.seekp(offsetof(MazeFileHeader, count));
+  fs.write((const char *) &count, sizeof(count));
+  fs.close();
+  EXPECT_FALSE(file.open(path));
+  std::remove(path.c_str());
+}
+
+TEST(DistanceFieldTest, RepairMatchesFloodFill) {
+  std::string maze_file = "../../mazes/16x16.mz";
+  std::ifstream fs;
+  fs.open(maze_file, std::ifstream::in);
+  ASSERT_TRUE(fs.good());
+  AbstractMaze true_maze(fs);
+
+  // discover the true maze one cell at a time, starting from no walls and from all walls
+  AbstractMaze no_wall_maze;
+  no_wall_maze.connect_all_neighbors_in_maze();
+  AbstractMaze all_wall_maze;
+  DistanceField no_wall_field(&no_wall_maze);
+  DistanceField all_wall_field(&all_wall_maze);
+  no_wall_field.set_root(smartmouse::maze::CENTER, smartmouse::maze::CENTER);
+  all_wall_field.set_root(smartmouse::maze::CENTER, smartmouse::maze::CENTER);
+  EXPECT_EQ(no_wall_field.repair(), smartmouse::maze::SIZE * smartmouse::maze::SIZE);
+  EXPECT_EQ(all_wall_field.repair(), 1u);
+
+  for (unsigned int r = 0; r < smartmouse::maze::SIZE; r++) {
+    for (unsigned int c = 0; c < smartmouse::maze::SIZE; c++) {
+      SensorReading sr(r, c);
+      for (Direction d = Direction::First; d < Direction::Last; d++) {
+        sr.walls[static_cast<int>(d)] = true_maze.nodes[r][c]->wall(d);
+      }
+
+      no_wall_maze.update(sr);
+      no_wall_field.walls_changed(r, c);
+      no_wall_field.repair();
+      all_wall_maze.update(sr);
+      all_wall_field.walls_changed(r, c);
+      all_wall_field.repair();
+
+      for (auto maze_and_field : {std::make_pair(&no_wall_maze, &no_wall_field),
+                                  std::make_pair(&all_wall_maze, &all_wall_field)}) {
+        route_t path;
+        maze_and_field.first->flood_fill(&path, smartmouse::maze::CENTER, smartmouse::maze::CENTER, 0, 0);
+        for (unsigned int i = 0; i < smartmouse::maze::SIZE; i++) {
+          for (unsigned int j = 0; j < smartmouse::maze::SIZE; j++) {
+            int expected = maze_and_field.first->nodes[i][j]->weight;
+            uint16_t actual = maze_and_field.second->distance(i, j);
+            if (expected < 0) {
+              ASSERT_EQ(DistanceField::INF, actual) << i << "," << j;
+            } else {
+              ASSERT_EQ(expected, actual) << i << "," << j;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // once everything is known both mazes are the true maze
+  route_t from_origin;
+  true_maze.flood_fill_from_origin_to_center(&from_origin);
+  DistanceField origin_field(&all_wall_maze);
+  origin_field.set_root(0, 0);
+  origin_field.repair();
+  route_t field_route;
+  ASSERT_TRUE(origin_field.route_from_root(&field_route, smartmouse::maze::CENTER, smartmouse::maze::CENTER));
+  EXPECT_EQ(route_to_string(from_origin), route_to_string(field_route));
+}
+
+template<unsigned int S>
+void check_maze_size() {
+  BasicMaze<S> maze = BasicMaze<S>::gen_random_legal_maze();
+  char buff[smartmouse::maze::Dimensions<S>::BUFF_SIZE];
+  maze.print_maze_str(buff);
+  std::stringstream ss(buff);
+  BasicMaze<S> parsed(ss);
+  EXPECT_TRUE(maze == parsed) << S;
+
+  route_t maze_route;
+  route_t grid_route;
+  ASSERT_TRUE(maze.flood_fill_from_origin_to_center(&maze_route)) << S;
+  BasicWallGrid<S> grid(&maze);
+  ASSERT_TRUE(grid.flood_fill_from_origin_to_center(&grid_route)) << S;
+  EXPECT_EQ(route_to_string(maze_route), route_to_string(grid_route)) << S;
+
+  BasicDistanceField<S> field(&maze);
+  field.set_root(0, 0);
+  EXPECT_EQ(S * S, field.repair()) << S;
+  route_t field_route;
+  ASSERT_TRUE(field.route_from_root(&field_route, S / 2, S / 2)) << S;
+  EXPECT_EQ(route_to_string(maze_route), route_to_string(field_route)) << S;
+}
+
+TEST(DistanceCacheTest, ReusedUntilWallsChange) {
+  std::string maze_file = "../../mazes/16x16.mz";
+  std::ifstream fs;
+  fs.open(maze_file, std::ifstream::in);
+  ASSERT_TRUE(fs.good());
+  AbstractMaze true_maze(fs);
+
+  const unsigned int C = smartmouse::maze::CENTER;
+  AbstractMaze maze;
+  maze.connect_all_neighbors_in_maze();
+  DistanceCache cache(&maze);
+  cache.to_center();
+  cache.to_start();
+  EXPECT_EQ(2u, cache.rebuilds);
+
+  // asking again, or switching between goals, doesn't recompute anything
+  cache.to_center();
+  cache.to_start();
+  EXPECT_EQ(2u, cache.rebuilds);
+
+  // reported walls get repaired, not rebuilt
+  for (unsigned int r = 0; r < smartmouse::maze::SIZE; r++) {
+    for (unsigned int c = 0; c < smartmouse::maze::SIZE; c++) {
+      SensorReading sr(r, c);
+      for (Direction d = Direction::First; d < Direction::Last; d++) {
+        sr.walls[static_cast<int>(d)] = true_maze.nodes[r][c]->wall(d);
+      }
+      maze.update(sr);
+      cache.walls_changed(r, c);
+    }
+  }
+  EXPECT_EQ(2u, cache.rebuilds);
+
+  // the center goal is all four center cells, so check it against the closest of them
+  for (unsigned int i = 0; i < smartmouse::maze::SIZE; i++) {
+    for (unsigned int j = 0; j < smartmouse::maze::SIZE; j++) {
+      uint16_t expected = DistanceField::INF;
+      for (unsigned int r : {C - 1, C}) {
+        for (unsigned int c : {C - 1, C}) {
+          route_t path;
+          if (true_maze.flood_fill(&path, r, c, i, j)) {
+            uint16_t d = 0;
+            for (motion_primitive_t prim : path) {
+              d += prim.n;
+            }
+            expected = std::min(expected, d);
+          }
+        }
+      }
+      ASSERT_EQ(expected, cache.to_center().distance(i, j)) << i << "," << j;
+    }
+  }
+
+  // following next_step from the center gets back to the start on a shortest route
+  route_t from_origin;
+  ASSERT_TRUE(true_maze.flood_fill_from_origin_to_center(&from_origin));
+  unsigned int length = 0;
+  for (motion_primitive_t prim : from_origin) {
+    length += prim.n;
+  }
+  unsigned int row = C, col = C, steps = 0;
+  for (Direction d; (d = cache.to_start().next_step(row, col)) != Direction::INVALID; steps++) {
+    Node *next = maze.nodes[row][col]->neighbor(d);
+    ASSERT_NE(nullptr, next);
+    row = next->row();
+    col = next->col();
+  }
+  EXPECT_EQ(0u, row);
+  EXPECT_EQ(0u, col);
+  EXPECT_EQ(length, steps);
+  EXPECT_EQ(2u, cache.rebuilds);
+
+  // walls changed behind the cache's back make it rebuild everything it has
+  maze.disconnect_all_neighbors_in_maze();
+  EXPECT_EQ(DistanceField::INF, cache.to_start().distance(C, C));
+  EXPECT_EQ(4u, cache.rebuilds);
+
+  // there's one slot for any other cell
+  cache.to_cell(3, 4);
+  cache.to_cell(3, 4);
+  EXPECT_EQ(5u, cache.rebuilds);
+  EXPECT_EQ(0u, cache.to_cell(5, 6).distance(5, 6));
+  EXPECT_EQ(6u, cache.rebuilds);
+}
+
+TEST(MazeSizeTest, OtherSizes) {
+  check_maze_size<8>();
+  check_maze_size<32>();
+}
+
 TEST(SolveMazeTest, WallFollowSolve) {
   std::string maze_file = "../../mazes/16x16.mz";
   std::ifstream fs;
@@ -212,8 +615,9 @@ TEST(SolveMazeTest, WallFollowSolve) {
   ASSERT_TRUE(fs.good());
 
   AbstractMaze maze(fs);
-  ConsoleMouse::inst()->seedMaze(&maze);
-  WallFollow solver(ConsoleMouse::inst());
+  ConsoleMouse mouse;
+  mouse.seedMaze(&maze);
+  WallFollow solver(&mouse);
   solver.setup();
   route_t solution = solver.solve();
   solver.teardown();
@@ -232,8 +636,9 @@ TEST(SolveMazeTest, FloodSolve) {
   ASSERT_TRUE(fs.good());
 
   AbstractMaze maze(fs);
-  ConsoleMouse::inst()->seedMaze(&maze);
-  Flood solver(ConsoleMouse::inst());
+  ConsoleMouse mouse;
+  mouse.seedMaze(&maze);
+  Flood solver(&mouse);
   solver.setup();
   route_t solution = solver.solve();
   solver.teardown();
@@ -244,12 +649,86 @@ TEST(SolveMazeTest, FloodSolve) {
   fs.close();
 }
 
+TEST(SolveMazeTest, PickSolverTest) {
+  Solver::Type type;
+  ASSERT_TRUE(Solver::parseType("astar", &type));
+  EXPECT_EQ(type, Solver::Type::ASTAR);
+  ASSERT_TRUE(Solver::parseType("WallFollow", &type));
+  EXPECT_EQ(type, Solver::Type::WALL_FOLLOW);
+  EXPECT_FALSE(Solver::parseType("flo", &type));
+  EXPECT_FALSE(Solver::parseType("floods", &type));
+
+  // every solver can be made by name
+  ConsoleMouse mouse;
+  AbstractMaze maze = AbstractMaze::gen_random_legal_maze(42, 0);
+  mouse.seedMaze(&maze);
+  for (Solver::Type t : Solver::TYPES) {
+    Solver::Type parsed;
+    ASSERT_TRUE(Solver::parseType(Solver::name(t), &parsed));
+    EXPECT_EQ(parsed, t);
+    std::unique_ptr<Solver> solver(Solver::make(t, &mouse));
+    ASSERT_NE(solver, nullptr);
+  }
+  std::unique_ptr<Solver> astar(Solver::make(Solver::Type::ASTAR, &mouse));
+  EXPECT_NE(dynamic_cast<AStar *>(astar.get()), nullptr);
+}
+
+TEST(GenerateMazeTest, ReproducibleTest) {
+  AbstractMaze a = AbstractMaze::gen_random_legal_maze(42, 7);
+  AbstractMaze b = AbstractMaze::gen_random_legal_maze(42, 7);
+  AbstractMaze c = AbstractMaze::gen_random_legal_maze(42, 8);
+  AbstractMaze d = AbstractMaze::gen_random_legal_maze(43, 7);
+  EXPECT_TRUE(a == b);
+  EXPECT_FALSE(a == c);
+  EXPECT_FALSE(a == d);
+
+  std::mt19937 engine(42);
+  AbstractMaze e = AbstractMaze::gen_random_legal_maze(engine);
+  engine.seed(42);
+  AbstractMaze f = AbstractMaze::gen_random_legal_maze(engine);
+  EXPECT_TRUE(e == f);
+}
+
+TEST(GenerateMazeTest, ParallelTest) {
+  // every thread makes its own streams at the same time, and they have to match the same streams made one by one
+  constexpr unsigned int THREADS = 4;
+  constexpr unsigned int PER_THREAD = 16;
+  std::vector<WallGrid> parallel(THREADS * PER_THREAD);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < THREADS; t++) {
+    threads.emplace_back([t, &parallel]() {
+      for (unsigned int i = t; i < THREADS * PER_THREAD; i += THREADS) {
+        AbstractMaze maze = AbstractMaze::gen_random_legal_maze(1234, i);
+        parallel[i] = WallGrid(&maze);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (unsigned int i = 0; i < THREADS * PER_THREAD; i++) {
+    AbstractMaze maze = AbstractMaze::gen_random_legal_maze(1234, i);
+    EXPECT_TRUE(parallel[i] == WallGrid(&maze)) << i;
+
+    route_t route;
+    EXPECT_TRUE(maze.flood_fill_from_origin_to_center(&route)) << i;
+    // the four center cells are always one open square
+    const unsigned int C = smartmouse::maze::CENTER;
+    EXPECT_FALSE(maze.nodes[C][C]->wall(Direction::N));
+    EXPECT_FALSE(maze.nodes[C][C]->wall(Direction::W));
+    EXPECT_FALSE(maze.nodes[C - 1][C - 1]->wall(Direction::S));
+    EXPECT_FALSE(maze.nodes[C - 1][C - 1]->wall(Direction::E));
+  }
+}
+
 TEST(SolveMazeTest, RandSolve) {
   for (int i=0; i < 100; i++) {
     AbstractMaze maze = AbstractMaze::gen_random_legal_maze();
-    ConsoleMouse::inst()->seedMaze(&maze);
+    ConsoleMouse mouse;
+    mouse.seedMaze(&maze);
 
-    Flood solver(ConsoleMouse::inst());
+    Flood solver(&mouse);
     solver.setup();
     solver.solve();
     solver.teardown();
@@ -258,6 +737,238 @@ TEST(SolveMazeTest, RandSolve) {
   }
 }
 
+TEST(SolveMazeTest, AStarSolve) {
+  unsigned long astar_expansions = 0;
+  unsigned long steps = 0;
+  for (unsigned int i = 0; i < 50; i++) {
+    AbstractMaze maze = AbstractMaze::gen_random_legal_maze(99, i);
+    ConsoleMouse mouse;
+    mouse.seedMaze(&maze);
+
+    AStar solver(&mouse);
+    solver.setup();
+    while (!solver.isFinished()) {
+      motion_primitive_t prim = solver.planNextStep();
+      ASSERT_NE(Direction::INVALID, prim.d) << i;
+      astar_expansions += solver.expansions;
+      steps++;
+      mouse.internalTurnToFace(prim.d);
+      mouse.internalForward();
+    }
+    solver.teardown();
+    ASSERT_TRUE(solver.isSolvable()) << i;
+
+    // the route it found through what it saw has to be drivable in the real maze, and can't beat the real shortest
+    route_t shortest;
+    ASSERT_TRUE(maze.flood_fill_from_origin_to_center(&shortest));
+    route_t route = mouse.maze->fastest_route;
+    route_t drivable = maze.truncate(0, 0, Direction::E, route);
+    EXPECT_EQ(route_to_string(route), route_to_string(drivable)) << i;
+    unsigned int length = 0, shortest_length = 0;
+    for (motion_primitive_t prim : route) {
+      length += prim.n;
+    }
+    for (motion_primitive_t prim : shortest) {
+      shortest_length += prim.n;
+    }
+    EXPECT_GE(length, shortest_length) << i;
+  }
+
+  // a full flood fill would expand every cell, every step
+  EXPECT_LT(astar_expansions / steps, smartmouse::maze::SIZE * smartmouse::maze::SIZE / 4);
+}
+
+TEST(SolveMazeTest, ParallelSolves) {
+  std::string maze_file = "../../mazes/16x16.mz";
+  std::ifstream fs;
+  fs.open(maze_file, std::ifstream::in);
+
+  ASSERT_TRUE(fs.good());
+
+  AbstractMaze maze(fs);
+  fs.close();
+
+  // every thread has its own mouse and solver, and only reads the true maze
+  constexpr unsigned int threads = 4;
+  std::string solutions[threads];
+  std::vector<std::thread> workers;
+  for (unsigned int t = 0; t < threads; t++) {
+    workers.emplace_back([&maze, &solutions, t]() {
+      ConsoleMouse mouse;
+      mouse.seedMaze(&maze);
+      Flood solver(&mouse);
+      solver.setup();
+      route_t solution = solver.solve();
+      solutions[t] = route_to_string(solution);
+      solver.teardown();
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  for (unsigned int t = 0; t < threads; t++) {
+    EXPECT_STREQ(FLOOD_SLN, solutions[t].c_str());
+  }
+}
+
+TEST(SolveMazeTest, SlicedPlanning) {
+  std::string maze_file = "../../mazes/16x16.mz";
+  std::ifstream fs;
+  fs.open(maze_file, std::ifstream::in);
+
+  ASSERT_TRUE(fs.good());
+
+  AbstractMaze maze(fs);
+  fs.close();
+  ConsoleMouse mouse;
+  mouse.seedMaze(&maze);
+  Flood solver(&mouse);
+  solver.setup();
+
+  // plan a few expansions at a time, like SolveMaze does once per cycle, and get the same route as Flood::solve
+  unsigned int max_slices = 0;
+  while (!solver.isFinished()) {
+    unsigned int slices = 1;
+    while (!solver.planSlice(4)) {
+      slices++;
+    }
+    max_slices = std::max(max_slices, slices);
+    mouse.internalTurnToFace(solver.planNextStep().d);
+    mouse.internalForward();
+  }
+  solver.teardown();
+
+  EXPECT_GT(max_slices, 1u);
+  EXPECT_STREQ(FLOOD_SLN, route_to_string(mouse.maze->fastest_route).c_str());
+}
+
+namespace {
+unsigned long fake_time_us = 0;
+
+unsigned long fake_clock_us() {
+  return fake_time_us;
+}
+
+/// \brief takes a fixed amount of time every cycle, and finishes after a fixed number of cycles
+class SlowCommand : public Command {
+public:
+  SlowCommand(const char *name, unsigned long cycle_us, unsigned int cycles)
+      : Command(name), cycle_us(cycle_us), cycles_left(cycles) {}
+
+  void execute() override {
+    fake_time_us += cycle_us;
+    cycles_left--;
+  }
+
+  bool isFinished() override {
+    return cycles_left == 0;
+  }
+
+  unsigned long cycle_us;
+  unsigned int cycles_left;
+};
+
+class SlowGroup : public CommandGroup {
+public:
+  SlowGroup() : CommandGroup("group") {
+    addSequential(new SlowCommand("fast", 100, 3));
+    SlowCommand *slow = new SlowCommand("slow", 800, 2);
+    slow->setBudgetUs(500);
+    addSequential(slow);
+  }
+};
+}
+
+TEST(SchedulerTest, BudgetTest) {
+  Command::setCycleClock(fake_clock_us);
+
+  ConsoleTimer timer;
+  Scheduler scheduler(new SlowGroup(), &timer);
+  scheduler.setBudgetUs(700);
+  while (!scheduler.run());
+
+  Command::setCycleClock(nullptr);
+
+  // only the two cycles of the slow command go over, both its own budget and the scheduler's
+  const BudgetReport &report = scheduler.getReport();
+  EXPECT_EQ(report.command_overruns, 2ul);
+  EXPECT_STREQ(report.worst_overrun_name, "slow");
+  EXPECT_EQ(report.worst_overrun_us, 300ul);
+  EXPECT_EQ(report.tick_overruns, 2ul);
+  EXPECT_EQ(report.worst_tick_us, 800ul);
+}
+
+namespace {
+class PooledStop : public Command, public PooledCommand<PooledStop, 2> {
+public:
+  PooledStop() : Command("stop") {}
+
+  bool isFinished() override {
+    return true;
+  }
+};
+}
+
+TEST(CommandQueueTest, AddRemoveTest) {
+  CommandQueue queue;
+  PooledStop a, b, c;
+  queue.add(&a);
+  queue.add(&b);
+  queue.add(&c);
+  EXPECT_EQ(queue.size(), 3);
+
+  queue.remove(&a, &b);
+  EXPECT_EQ(queue.front(), &a);
+  EXPECT_EQ(CommandQueue::next(&a), &c);
+
+  // removing the tail and then adding has to link onto the new tail
+  queue.remove(&a, &c);
+  queue.add(&b);
+  EXPECT_EQ(CommandQueue::next(&a), &b);
+  EXPECT_EQ(CommandQueue::next(&b), nullptr);
+
+  queue.remove(nullptr, &a);
+  queue.remove(nullptr, &b);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(CommandPoolTest, ReuseTest) {
+  Command *a = new PooledStop();
+  Command *b = new PooledStop();
+  EXPECT_EQ(PooledStop::pooled(), 2u);
+
+  // the pool is full, so this one comes from the heap
+  Command *c = new PooledStop();
+  EXPECT_EQ(PooledStop::pooled(), 2u);
+  delete c;
+
+  delete a;
+  EXPECT_EQ(PooledStop::pooled(), 1u);
+  Command *d = new PooledStop();
+  EXPECT_EQ(d, a);
+
+  delete b;
+  delete d;
+  EXPECT_EQ(PooledStop::pooled(), 0u);
+}
+
+TEST(CommandPoolTest, LongestStraightTest) {
+  // runs queue a Forward for every cell of a straight, and none of those should come from the heap
+  ConsoleMouse mouse;
+  ConsoleTimer timer;
+  RobotContext context = {&mouse, &timer};
+  std::vector<Command *> forwards;
+  for (unsigned int i = 0; i < smartmouse::maze::SIZE; i++) {
+    forwards.push_back(new Forward(&context));
+  }
+  EXPECT_EQ(Forward::pooled(), smartmouse::maze::SIZE);
+  for (Command *forward : forwards) {
+    delete forward;
+  }
+  EXPECT_EQ(Forward::pooled(), 0u);
+}
+
 TEST(DirectionTest, DirectionLogic) {
   EXPECT_TRUE(Direction::W > Direction::S);
   EXPECT_TRUE(Direction::W > Direction::E);
@@ -314,6 +1025,256 @@ TEST(RouteStringTest, RouteStringText) {
   EXPECT_STREQ(s.c_str(), "1N2W3E1S");
 }
 
+TEST(DirectionTest, HeadingLogic) {
+  EXPECT_EQ(heading_steps(Heading::N, Heading::N), 0u);
+  EXPECT_EQ(heading_steps(Heading::N, Heading::NE), 1u);
+  EXPECT_EQ(heading_steps(Heading::NW, Heading::NE), 2u);
+  EXPECT_EQ(heading_steps(Heading::E, Heading::NW), 3u);
+  EXPECT_EQ(heading_steps(Heading::SW, Heading::NE), 4u);
+  EXPECT_NEAR(heading_to_yaw(Heading::NE), M_PI / 4, 1e-9);
+  EXPECT_NEAR(heading_to_yaw(Heading::SW), -3 * M_PI / 4, 1e-9);
+  for (Direction d = Direction::First; d < Direction::Last; d++) {
+    EXPECT_EQ(heading_to_dir(dir_to_heading(d)), d);
+    EXPECT_EQ(heading_to_yaw(dir_to_heading(d)), dir_to_yaw(d));
+  }
+}
+
+const RunLimits TEST_RUN_LIMITS = {3, 2, 10, 1.5, 0.5};
+
+TEST(DiagonalPlannerTest, StaircaseTest) {
+  // a corridor that zig-zags down and to the right is quickest as one long diagonal
+  AbstractMaze maze;
+  for (unsigned int i = 0; i < 4; i++) {
+    maze.connect_neighbor(i, i, Direction::E);
+    maze.connect_neighbor(i, i + 1, Direction::S);
+  }
+  DiagonalPlanner planner(&maze, TEST_RUN_LIMITS);
+  diagonal_route_t route;
+  ASSERT_TRUE(planner.plan(&route, 0, 0, Direction::E, 4, 4));
+  EXPECT_STREQ(diagonal_route_to_string(route).c_str(), "1E7SE1S");
+  route_t cells = DiagonalPlanner::to_route(route);
+  EXPECT_STREQ(route_to_string(cells).c_str(), "1E1S1E1S1E1S1E1S");
+
+  route_t staircase = {{1, Direction::E}, {1, Direction::S}, {1, Direction::E}, {1, Direction::S},
+                       {1, Direction::E}, {1, Direction::S}, {1, Direction::E}, {1, Direction::S}};
+  EXPECT_LT(planner.route_time(route, Direction::E),
+            planner.route_time(DiagonalPlanner::from_route(staircase), Direction::E));
+}
+
+TEST(DiagonalPlannerTest, ExploredMazeTest) {
+  std::string maze_file = "../../mazes/16x16.mz";
+  std::ifstream fs;
+  fs.open(maze_file, std::ifstream::in);
+  ASSERT_TRUE(fs.good());
+  AbstractMaze maze(fs);
+
+  route_t flood_route;
+  ASSERT_TRUE(maze.flood_fill_from_origin_to_center(&flood_route));
+
+  DiagonalPlanner planner(&maze, TEST_RUN_LIMITS);
+  diagonal_route_t route;
+  ASSERT_TRUE(planner.plan(&route, 0, 0, Direction::E, smartmouse::maze::CENTER, smartmouse::maze::CENTER));
+
+  // it has to stay inside the maze's walls and end up at the center
+  route_t cells = DiagonalPlanner::to_route(route);
+  route_t valid = maze.truncate(0, 0, Direction::E, cells);
+  EXPECT_STREQ(route_to_string(valid).c_str(), route_to_string(cells).c_str());
+  unsigned int row = 0, col = 0;
+  for (motion_primitive_t prim : cells) {
+    for (unsigned int i = 0; i < prim.n; i++) {
+      Node *n = maze.nodes[row][col]->neighbor(prim.d);
+      ASSERT_NE(n, nullptr);
+      row = n->row();
+      col = n->col();
+    }
+  }
+  EXPECT_EQ(row, smartmouse::maze::CENTER);
+  EXPECT_EQ(col, smartmouse::maze::CENTER);
+
+  // and the same costs it plans with say it's quicker than the flood route
+  double t = planner.route_time(route, Direction::E);
+  EXPECT_LT(t, planner.route_time(DiagonalPlanner::from_route(flood_route), Direction::E));
+}
+
+TEST(DiagonalPlannerTest, NoRouteTest) {
+  AbstractMaze maze;
+  DiagonalPlanner planner(&maze, TEST_RUN_LIMITS);
+  diagonal_route_t route;
+  EXPECT_FALSE(planner.plan(&route, 0, 0, Direction::E, 1, 1));
+  EXPECT_TRUE(route.empty());
+  EXPECT_EQ(planner.expansions, 1u);
+}
+
+TEST(RunPlannerTest, StraightsOverStaircaseTest) {
+  // a staircase to 6,6 is 12 cells with 11 turns, going around it is 14 cells with 3
+  const unsigned int K = 6;
+  AbstractMaze maze;
+  for (unsigned int i = 0; i < K; i++) {
+    maze.connect_neighbor(i, i, Direction::S);
+    maze.connect_neighbor(i + 1, i, Direction::E);
+  }
+  for (unsigned int i = 0; i <= K; i++) {
+    maze.connect_neighbor(0, i, Direction::E);
+    maze.connect_neighbor(i, K + 1, Direction::S);
+  }
+  maze.connect_neighbor(K, K + 1, Direction::W);
+
+  route_t flood_route;
+  ASSERT_TRUE(maze.flood_fill(&flood_route, 0, 0, K, K));
+  EXPECT_EQ(12u, flood_route.size());
+
+  RunPlanner planner(&maze, TEST_RUN_LIMITS);
+  route_t route;
+  ASSERT_TRUE(planner.plan(&route, 0, 0, Direction::E, K, K));
+  EXPECT_EQ("7E6S1W", route_to_string(route));
+  EXPECT_LT(planner.route_time(route, Direction::E), planner.route_time(flood_route, Direction::E));
+}
+
+TEST(RunPlannerTest, FasterThanFloodFillTest) {
+  unsigned int faster = 0;
+  for (auto maze_file : ALL_MAZE_FILES) {
+    std::ifstream fs;
+    fs.open(std::string("../../mazes/") + maze_file, std::ifstream::in);
+    ASSERT_TRUE(fs.good()) << maze_file;
+    AbstractMaze maze(fs);
+
+    route_t flood_route;
+    RunPlanner planner(&maze, TEST_RUN_LIMITS);
+    route_t route;
+    bool solvable = maze.flood_fill_from_origin_to_center(&flood_route);
+    ASSERT_EQ(solvable, planner.plan(&route, 0, 0, Direction::E, smartmouse::maze::CENTER, smartmouse::maze::CENTER))
+                  << maze_file;
+    if (!solvable) {
+      continue;
+    }
+
+    // the route has to be drivable and end in the center
+    route_t drivable = maze.truncate(0, 0, Direction::E, route);
+    EXPECT_EQ(route_to_string(route), route_to_string(drivable)) << maze_file;
+    int row = 0, col = 0;
+    for (motion_primitive_t prim : route) {
+      row += (prim.d == Direction::S ? prim.n : 0) - (prim.d == Direction::N ? prim.n : 0);
+      col += (prim.d == Direction::E ? prim.n : 0) - (prim.d == Direction::W ? prim.n : 0);
+    }
+    EXPECT_EQ((int) smartmouse::maze::CENTER, row) << maze_file;
+    EXPECT_EQ((int) smartmouse::maze::CENTER, col) << maze_file;
+
+    double t = planner.route_time(route, Direction::E);
+    double flood_t = planner.route_time(flood_route, Direction::E);
+    EXPECT_LE(t, flood_t + 1e-4) << maze_file;
+    if (t < flood_t - 1e-4) {
+      faster++;
+    }
+  }
+  EXPECT_GT(faster, 0u);
+}
+
+/// \brief drain in awkward sized pieces, like a serial port would, and decode everything that comes out
+std::vector<TelemetryRecord> drain_and_decode(TelemetryRing *ring, TelemetryDecoder *decoder,
+                                              std::vector<uint8_t> *wire = nullptr) {
+  std::vector<TelemetryRecord> records;
+  uint8_t buf[7];
+  unsigned int n;
+  while ((n = ring->drain(buf, sizeof(buf))) > 0) {
+    for (unsigned int i = 0; i < n; i++) {
+      if (wire) {
+        wire->push_back(buf[i]);
+      } else if (decoder->feed(buf[i])) {
+        records.push_back(decoder->record);
+      }
+    }
+  }
+  return records;
+}
+
+TEST(TelemetryTest, RoundTripTest) {
+  TelemetryRing ring;
+  TelemetryDecoder decoder;
+
+  RangeData range_data = {0.01, 0.02, 0.03, 0.04, 0.05, 0.06, 0.07};
+  EXPECT_TRUE(ring.phase(LoopPhase::KC, 1000, 188));
+  EXPECT_TRUE(ring.range(2000, range_data));
+  EXPECT_TRUE(ring.pose(3000, GlobalPose(1.5, 2.5, -0.25)));
+  float pid[] = {1, -2, 3, 4, 5, 6, 255};
+  EXPECT_TRUE(ring.push(TelemetryKind::PID, 1, 4000000000u, pid, 7));
+  EXPECT_EQ(ring.size(), 14u + 38u + 22u + 38u);
+
+  auto records = drain_and_decode(&ring, &decoder);
+  ASSERT_EQ(records.size(), 4u);
+  EXPECT_EQ(ring.size(), 0u);
+  EXPECT_EQ(decoder.bad_frames, 0ul);
+
+  EXPECT_EQ(records[0].kind, TelemetryKind::PHASE);
+  EXPECT_EQ(records[0].id, (uint8_t) LoopPhase::KC);
+  EXPECT_EQ(records[0].t_us, 1000u);
+  EXPECT_EQ(records[0].values[0], 188);
+
+  EXPECT_EQ(records[1].kind, TelemetryKind::RANGE);
+  EXPECT_EQ(records[1].count, 7);
+  EXPECT_EQ(records[1].values[2], (float) range_data.front_left);
+  EXPECT_EQ(records[1].values[6], (float) range_data.front);
+
+  EXPECT_EQ(records[2].kind, TelemetryKind::POSE);
+  EXPECT_EQ(records[2].values[0], 1.5f);
+  EXPECT_EQ(records[2].values[1], 2.5f);
+  EXPECT_EQ(records[2].values[2], -0.25f);
+
+  EXPECT_EQ(records[3].kind, TelemetryKind::PID);
+  EXPECT_EQ(records[3].id, 1);
+  EXPECT_EQ(records[3].t_us, 4000000000u);
+  for (unsigned int i = 0; i < 7; i++) {
+    EXPECT_EQ(records[3].values[i], pid[i]);
+  }
+}
+
+TEST(TelemetryTest, ResyncTest) {
+  TelemetryRing ring;
+  TelemetryDecoder decoder;
+  for (uint32_t i = 0; i < 3; i++) {
+    ring.phase(LoopPhase::SENSORS, i, 80 + i);
+  }
+  std::vector<uint8_t> wire;
+  drain_and_decode(&ring, &decoder, &wire);
+
+  // start partway into the first frame, with some text in front like print() would send, and corrupt the second
+  std::string text = "hello\r\n";
+  std::vector<uint8_t> stream(text.begin(), text.end());
+  stream.insert(stream.end(), wire.begin() + 3, wire.end());
+  stream[text.size() - 3 + 14 + 10] ^= 0xFF;
+
+  std::vector<TelemetryRecord> records;
+  for (uint8_t byte : stream) {
+    if (decoder.feed(byte)) {
+      records.push_back(decoder.record);
+    }
+  }
+  ASSERT_EQ(records.size(), 1u);
+  EXPECT_EQ(records[0].values[0], 82);
+  EXPECT_EQ(decoder.bad_frames, 1ul);
+}
+
+TEST(TelemetryTest, DroppedTest) {
+  TelemetryRing ring;
+  TelemetryDecoder decoder;
+  unsigned int pushed = 0;
+  while (ring.phase(LoopPhase::MOTORS, pushed, 6)) {
+    pushed++;
+  }
+  EXPECT_EQ(pushed, TelemetryRing::CAPACITY_BYTES / 14);
+  EXPECT_FALSE(ring.phase(LoopPhase::MOTORS, 0, 6));
+  EXPECT_EQ(ring.dropped(), 2ul);
+
+  // the next record after some room frees up says how many went missing
+  auto records = drain_and_decode(&ring, &decoder);
+  EXPECT_EQ(records.size(), pushed);
+  EXPECT_TRUE(ring.phase(LoopPhase::MOTORS, 0, 6));
+  records = drain_and_decode(&ring, &decoder);
+  ASSERT_EQ(records.size(), 2u);
+  EXPECT_EQ(records[0].kind, TelemetryKind::DROPPED);
+  EXPECT_EQ(records[0].values[0], 2);
+  EXPECT_EQ(records[1].kind, TelemetryKind::PHASE);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
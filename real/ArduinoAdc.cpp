@@ -0,0 +1,14 @@
+#include "ArduinoAdc.h"
+
+ArduinoAdc::ArduinoAdc() : module(adc.adc0) {}
+
+void ArduinoAdc::start(unsigned int pin) {
+  // the teensy has two ADCs, and not every pin is on both
+  module = adc.adc0->checkPin(pin) ? adc.adc0 : adc.adc1;
+  module->startSingleRead(pin);
+}
+
+int ArduinoAdc::read() {
+  while (!module->isComplete());
+  return module->readSingle();
+}
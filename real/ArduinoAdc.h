@@ -0,0 +1,22 @@
+#pragma once
+
+#include <ADC.h>
+#include <common/KinematicController/RangeSampler.h>
+
+/**
+ * \brief single conversions through the ADC library, which knows which ADC each pin is on and how to start one
+ * without waiting for it
+ */
+class ArduinoAdc : public AdcInterface {
+public:
+  ArduinoAdc();
+
+  virtual void start(unsigned int pin) override;
+
+  virtual int read() override;
+
+private:
+  ADC adc;
+  /// \brief the ADC the last conversion was started on
+  ADC_Module *module;
+};
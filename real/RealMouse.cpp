@@ -1,68 +1,24 @@
+#include <algorithm>
 #include <tuple>
 #include <common/core/Mouse.h>
 #include "RealMouse.h"
 
-RealMouse *RealMouse::instance = nullptr;
-
-IRConverter::IRConverter() : ir_lookup{
-        755, // .01
-        648, // .02
-        492, // .03
-        409, // .04
-        315, // .05
-        268, // .06
-        224, // .07
-        192, // .08
-        165, // .09
-        147, // .10
-        134, // .11
-        115, // .12
-        105, // .13
-        93,  // .14
-        86,  // .15
-        75,  // .16
-        68,  // .17
-        58,  // .18
-} {}
-
-void IRConverter::calibrate(int avg_adc_value_on_center) {
-  double actual_dist = (0.08 - smartmouse::kc::FRONT_SIDE_ANALOG_Y) / sin(smartmouse::kc::FRONT_ANALOG_ANGLE);
-  int centered_idx = 4;
-  double expected_distance = (avg_adc_value_on_center - ir_lookup[centered_idx]) * 0.01 /
-                             (ir_lookup[centered_idx] - ir_lookup[centered_idx - 1]) + (centered_idx + 1) * .01;
-  calibration_offset = actual_dist - expected_distance;
-}
-
-double IRConverter::adcToMeters(int adc) {
-  if (adc > 751) {
-    return 0.01;
-  } else if (adc <= 53) {
-    return 0.18;
-  } else {
-    for (int i = 1; i < 18; i++) {
-      if (adc >= ir_lookup[i]) {
-        // linear map between i and i+1, .01 meters spacing
-        double o = (adc - ir_lookup[i]) * 0.01 / (ir_lookup[i] - ir_lookup[i - 1]) + (i + 1) * .01 + calibration_offset;
-        return o;
-      }
-    }
-    return 0.18;
-  }
-}
-
 double RealMouse::tick_to_rad(int ticks) {
   // if in quadrant I or II, it's positive
   return ticks * RAD_PER_TICK;
 }
 
-RealMouse *RealMouse::inst() {
-  if (instance == NULL) {
-    instance = new RealMouse();
-  }
-  return instance;
-}
-
-RealMouse::RealMouse() : kinematic_controller(this), range_data({0.18, 0.18, 0.18, 0.18, 0.18}) {}
+RealMouse::RealMouse()
+    : kinematic_controller(this),
+      range_sampler(&adc,
+                    {GERALD_LEFT_ANALOG_PIN, GERALD_RIGHT_ANALOG_PIN, FRONT_LEFT_ANALOG_PIN, FRONT_RIGHT_ANALOG_PIN,
+                     BACK_LEFT_ANALOG_PIN, BACK_RIGHT_ANALOG_PIN, FRONT_ANALOG_PIN},
+                    {&gerald_left_ir, &gerald_right_ir, &front_left_ir, &front_right_ir, &back_left_ir, &back_right_ir,
+                     &front_ir},
+                    RANGE_OVERSAMPLING),
+      multi_rate(false),
+      telemetry_cycle(0),
+      range_data({0.18, 0.18, 0.18, 0.18, 0.18}) {}
 
 SensorReading RealMouse::checkWalls() {
   SensorReading sr(row, col);
@@ -95,26 +51,27 @@ void RealMouse::run(double dt_s) {
 #ifdef PROFILE
   unsigned long t0 = micros();
 #endif
-  range_data.gerald_left = ir_converter.adcToMeters(analogRead(GERALD_LEFT_ANALOG_PIN));
-  range_data.gerald_right = ir_converter.adcToMeters(analogRead(GERALD_RIGHT_ANALOG_PIN));
-  range_data.front_left = ir_converter.adcToMeters(analogRead(FRONT_LEFT_ANALOG_PIN));
-  range_data.back_left = ir_converter.adcToMeters(analogRead(BACK_LEFT_ANALOG_PIN));
-  range_data.front_right = ir_converter.adcToMeters(analogRead(FRONT_RIGHT_ANALOG_PIN));
-  range_data.back_right = ir_converter.adcToMeters(analogRead(BACK_RIGHT_ANALOG_PIN));
-  range_data.front = ir_converter.adcToMeters(analogRead(FRONT_ANALOG_PIN));
-#ifdef PROFILE
-  Serial.print("Sensors, ");
-  Serial.println(micros() - t0);
-#endif
-
+  if (multi_rate) {
+    range_data = range_sampler.latest().range_data;
+  } else {
+    range_data.gerald_left = gerald_left_ir.adcToMeters(analogRead(GERALD_LEFT_ANALOG_PIN));
+    range_data.gerald_right = gerald_right_ir.adcToMeters(analogRead(GERALD_RIGHT_ANALOG_PIN));
+    range_data.front_left = front_left_ir.adcToMeters(analogRead(FRONT_LEFT_ANALOG_PIN));
+    range_data.back_left = back_left_ir.adcToMeters(analogRead(BACK_LEFT_ANALOG_PIN));
+    range_data.front_right = front_right_ir.adcToMeters(analogRead(FRONT_RIGHT_ANALOG_PIN));
+    range_data.back_right = back_right_ir.adcToMeters(analogRead(BACK_RIGHT_ANALOG_PIN));
+    range_data.front = front_ir.adcToMeters(analogRead(FRONT_ANALOG_PIN));
+  }
 #ifdef PROFILE
   unsigned long t1 = micros();
+  telemetry.phase(LoopPhase::SENSORS, t0, t1 - t0);
 #endif
+
   std::tie(abstract_left_force, abstract_right_force) = kinematic_controller.run(dt_s, left_angle_rad,
                                                                                  right_angle_rad, range_data);
 #ifdef PROFILE
-  Serial.print("KC, ");
-  Serial.println(micros() - t1);
+  unsigned long t2 = micros();
+  telemetry.phase(LoopPhase::KC, t1, t2 - t1);
 #endif
 
   // THIS IS SUPER IMPORTANT!
@@ -122,9 +79,87 @@ void RealMouse::run(double dt_s) {
   row = kinematic_controller.row;
   col = kinematic_controller.col;
 
+  // with the executive, the fast loop owns the motors
+  if (!multi_rate) {
+    writeMotors(abstract_left_force, abstract_right_force);
+  }
 #ifdef PROFILE
-  unsigned long t2 = micros();
+  unsigned long t3 = micros();
+  telemetry.phase(LoopPhase::MOTORS, t2, t3 - t2);
+
+  telemetry_cycle++;
+  if (telemetry_cycle == TELEMETRY_STATE_DECIMATION) {
+    telemetry_cycle = 0;
+    logState(t3);
+  }
 #endif
+}
+
+void RealMouse::logState(unsigned long t_us) {
+  telemetry.range(t_us, range_data);
+  telemetry.pose(t_us, kinematic_controller.getGlobalPose());
+
+  PidTerms pid[2];
+  if (multi_rate) {
+    WheelState wheels = executive.state();
+    pid[0] = wheels.left_pid;
+    pid[1] = wheels.right_pid;
+  } else {
+    pid[0] = kinematic_controller.left_motor.terms();
+    pid[1] = kinematic_controller.right_motor.terms();
+  }
+  for (uint8_t wheel = 0; wheel < 2; wheel++) {
+    float values[] = {(float) pid[wheel].setpoint_rps, (float) pid[wheel].velocity_rps, (float) pid[wheel].p,
+                      (float) pid[wheel].i, (float) pid[wheel].d, (float) pid[wheel].feed_forward,
+                      (float) pid[wheel].abstract_force};
+    telemetry.push(TelemetryKind::PID, wheel, t_us, values, 7);
+  }
+}
+
+void RealMouse::drainTelemetry() {
+  // never wait on the serial port. Whatever doesn't fit now goes next time around
+  uint8_t buf[64];
+  int room = Serial1.availableForWrite();
+  if (room <= 0) {
+    return;
+  }
+  unsigned int n = telemetry.drain(buf, std::min((unsigned int) room, (unsigned int) sizeof(buf)));
+  if (n > 0) {
+    Serial1.write(buf, n);
+  }
+}
+
+void RealMouse::fastRun() {
+  double abstract_left_force, abstract_right_force;
+  std::tie(abstract_left_force, abstract_right_force) = executive.fastTick(tick_to_rad(left_encoder.read()),
+                                                                           tick_to_rad(right_encoder.read()));
+  writeMotors(abstract_left_force, abstract_right_force);
+
+  range_sampler.sample();
+}
+
+void RealMouse::useExecutive() {
+  multi_rate = true;
+  kinematic_controller.useExecutive(&executive);
+}
+
+int RealMouse::rawRange(RangeSensor sensor) {
+  if (multi_rate) {
+    return range_sampler.latest().adc[static_cast<unsigned int>(sensor)];
+  }
+
+  static const unsigned int pins[RANGE_SENSOR_COUNT] = {GERALD_LEFT_ANALOG_PIN, GERALD_RIGHT_ANALOG_PIN,
+                                                        FRONT_LEFT_ANALOG_PIN, FRONT_RIGHT_ANALOG_PIN,
+                                                        BACK_LEFT_ANALOG_PIN, BACK_RIGHT_ANALOG_PIN, FRONT_ANALOG_PIN};
+  constexpr int SAMPLES = 16;
+  int sum = 0;
+  for (int i = 0; i < SAMPLES; i++) {
+    sum += analogRead(pins[static_cast<unsigned int>(sensor)]);
+  }
+  return sum / SAMPLES;
+}
+
+void RealMouse::writeMotors(double abstract_left_force, double abstract_right_force) {
   if (abstract_left_force < 0) {
     analogWrite(MOTOR_LEFT_A, (int) -abstract_left_force);
     analogWrite(MOTOR_LEFT_B, 0);
@@ -140,10 +175,6 @@ void RealMouse::run(double dt_s) {
     analogWrite(MOTOR_RIGHT_B, (int) abstract_right_force);
     analogWrite(MOTOR_RIGHT_A, 0);
   }
-#ifdef PROFILE
-  Serial.print("Motors, ");
-  Serial.println(micros() - t2);
-#endif
 }
 
 void RealMouse::setup() {
@@ -175,7 +206,7 @@ void RealMouse::setup() {
   left_encoder.init(ENCODER_LEFT_A, ENCODER_LEFT_B);
   right_encoder.init(ENCODER_RIGHT_A, ENCODER_RIGHT_B);
 
-  kinematic_controller.setAccelerationCpss(10);
+  kinematic_controller.setAccelerationCpss(smartmouse::kc::MAX_ACCEL_CUPSS);
 
   resetToStartPose();
 
@@ -4,20 +4,14 @@
 #include <Encoder.h>
 #include <common/core/Mouse.h>
 #include <common/core/Pose.h>
+#include <common/core/Telemetry.h>
+#include <common/KinematicController/IRConverter.h>
 #include <common/KinematicController/KinematicController.h>
+#include <common/KinematicController/MultiRateExecutive.h>
+#include <common/KinematicController/RangeSampler.h>
+#include <real/ArduinoAdc.h>
 
 
-class IRConverter {
-public:
-  IRConverter();
-  double adcToMeters(int adc);
-  void calibrate(int avg_adc_value_on_center);
-private:
-  double calibration_offset;
-  std::array<int, 18> ir_lookup;
-
-};
-
 class RealMouse : public Mouse {
 public:
   static constexpr int TICKS_PER_REV = 900;
@@ -41,6 +35,12 @@ public:
   static const unsigned int MOTOR_RIGHT_A = 8;
   static const unsigned int MOTOR_RIGHT_B = 7;
 
+  /// \brief with the executive, the fast loop does one conversion a tick, so a snapshot takes 7 ms per pass
+  static constexpr unsigned int RANGE_OVERSAMPLING = 1;
+
+  /// \brief range, pose, and PID records are only logged every this many cycles, or they'd swamp Serial1
+  static constexpr unsigned int TELEMETRY_STATE_DECIMATION = 5;
+
   static const unsigned int SYS_LED = 13;
   static const unsigned int LED_1 = 25;
   static const unsigned int LED_2 = 26;
@@ -53,7 +53,7 @@ public:
 
   static const unsigned int BUTTON_PIN = 23;
 
-  static RealMouse *inst();
+  RealMouse();
 
   virtual SensorReading checkWalls() override;
 
@@ -67,23 +67,63 @@ public:
 
   void run(double dt_s);
 
+  /**
+   * \brief the fast loop. Reads the encoders, runs the wheel PIDs and odometry, and drives the motors.
+   * Call this from a timer interrupt every MultiRateExecutive::FAST_PERIOD_US, after useExecutive.
+   */
+  void fastRun();
+
+  /**
+   * \brief move the wheel PIDs, odometry, and range sensor sampling out of run and into fastRun.
+   * From then on run only takes the latest range readings and estimates the pose, and never writes to the motors.
+   */
+  void useExecutive();
+
+  /**
+   * \brief a raw reading from one range sensor.
+   * Once the range sensors are sampled in the fast loop, it's the latest averaged reading from there, since calling
+   * analogRead here could interrupt the fast loop's conversion.
+   */
+  int rawRange(RangeSensor sensor);
+
+  /**
+   * \brief send as much telemetry over Serial1 as it has room for right now, without waiting.
+   * Call this whenever there's nothing better to do.
+   */
+  void drainTelemetry();
+
   void setSpeedCps(double l_mps, double r_mps);
 
   /** runs setup things like pin initializes */
   void setup();
 
   KinematicController kinematic_controller;
+  MultiRateExecutive executive;
   Encoder left_encoder, right_encoder;
-  IRConverter ir_converter;
+  /// \brief one per range sensor, so each has its own curve
+  IRConverter gerald_left_ir;
+  IRConverter gerald_right_ir;
+  IRConverter front_left_ir;
+  IRConverter back_left_ir;
+  IRConverter front_right_ir;
+  IRConverter back_right_ir;
+  IRConverter front_ir;
+  ArduinoAdc adc;
+  RangeSampler range_sampler;
+  /// \brief filled by run when built with PROFILE
+  TelemetryRing telemetry;
   double left_angle_rad;
   double right_angle_rad;
 
 private:
-  RealMouse();
-
   double tick_to_rad(int ticks);
 
-  static RealMouse *instance;
+  void writeMotors(double abstract_left_force, double abstract_right_force);
+
+  void logState(unsigned long t_us);
+
+  bool multi_rate;
+  unsigned int telemetry_cycle;
 
   RangeData range_data;
 };
@@ -1,108 +1,65 @@
-// TODO: finish unit conversion
-#include <common/math/math.h>
+#include <cmath>
+#include <tuple>
+#include <utility>
 
 #include "ArcTurn.h"
 
+namespace {
 
-ArcTurn::ArcTurn(Direction dir) : Command("RealArcTurn"), mouse(RealMouse::inst()), dir(dir) {}
-
-void ArcTurn::initialize() {
-  curPose = mouse->getGlobalPose();
-  curCol = mouse->getCol();
-  curRow = mouse->getRow();
-  curDir = mouse->getDir();
-
-  startPose = curPose;
-  startCol = curCol;
-  startRow = curRow;
-
-  goalYaw = dir_to_yaw(dir);
-
-  // determine vtc of arc
-  vtc_x = curCol * smartmouse::maze::UNIT_DIST_M + smartmouse::maze::HALF_UNIT_DIST;
-  vtc_y = curRow * smartmouse::maze::UNIT_DIST_M + smartmouse::maze::HALF_UNIT_DIST;
-  switch (curDir) {
-    case Direction::N: {
-      vtc_y += smartmouse::maze::HALF_UNIT_DIST;
-      if (dir == Direction::E) {
-        vtc_x += smartmouse::maze::HALF_UNIT_DIST;
-      } else {
-        vtc_x -= smartmouse::maze::HALF_UNIT_DIST;
-      }
-      break;
-    }
-    case Direction::E: {
-      vtc_x -= smartmouse::maze::HALF_UNIT_DIST;
-      if (dir == Direction::S) {
-        vtc_y += smartmouse::maze::HALF_UNIT_DIST;
-      } else {
-        vtc_y -= smartmouse::maze::HALF_UNIT_DIST;
-      }
-      break;
-    }
-    case Direction::S: {
-      vtc_y -= smartmouse::maze::HALF_UNIT_DIST;
-      if (dir == Direction::W) {
-        vtc_x -= smartmouse::maze::HALF_UNIT_DIST;
-      } else {
-        vtc_x += smartmouse::maze::HALF_UNIT_DIST;
-      }
-      break;
-    }
-    case Direction::W: {
-      vtc_x += smartmouse::maze::HALF_UNIT_DIST;
-      if (dir == Direction::N) {
-        vtc_y -= smartmouse::maze::HALF_UNIT_DIST;
-      } else {
-        vtc_y += smartmouse::maze::HALF_UNIT_DIST;
-      }
-      break;
-    }
-    default:
-      exit(0);
+// one cell step in the given direction, as (col, row)
+std::pair<double, double> cell_step(Direction d) {
+  switch (d) {
+    case Direction::N: return {0, -1};
+    case Direction::E: return {1, 0};
+    case Direction::S: return {0, 1};
+    case Direction::W: return {-1, 0};
+    default: return {0, 0};
   }
 }
 
-void ArcTurn::execute() {
-
-  double cur_x = fabs(curPose.row - vtc_x);
-  double cur_y = fabs(curPose.col - vtc_y);
-
-  double dAngle;
-  if ((dir == Direction::N) || (dir == Direction::S)) {
-    dAngle = atanf(fabs(cur_x / cur_y));
-  } else {
-    dAngle = atanf(fabs(cur_y / cur_x));
-  }
+}
 
-  double ang_error = smartmouse::math::yawDiff(dAngle, fabs(smartmouse::math::yawDiff(curPose.yaw, dir_to_yaw(curDir))));
-  double arc_error = (smartmouse::maze::HALF_UNIT_DIST / pose_dist(curPose, vtc_x, vtc_y)) - 1;
-  double corr = (ang_error * ang_weight) + (arc_error * arc_weight);
+ArcTurn::ArcTurn(RobotContext *context, Direction dir) : Command("RealArcTurn"), mouse(context->mouse), dir(dir) {}
 
-  double fast_speed = FAST_ARC_SPEED * ((corr * -kp_turn) + 1);
-  double slow_speed = SLOW_ARC_SPEED * ((corr * kp_turn) + 1);
+void ArcTurn::initialize() {
+  setTimeout(2000);
+
+  // the arc is a quarter circle of radius TURN_RADIUS_CU about the corner of the current cell, from the middle of the
+  // edge we entered through to the middle of the edge facing dir. Headings are in the planner's frame, which is the
+  // same one the odometry integrates in (drow = v * sin(yaw)).
+  const Direction from = mouse->getDir();
+  double in_col, in_row, out_col, out_row;
+  std::tie(in_col, in_row) = cell_step(from);
+  std::tie(out_col, out_row) = cell_step(dir);
+  const double center_col = mouse->getCol() + 0.5, center_row = mouse->getRow() + 0.5;
+  const double r = smartmouse::kc::TURN_RADIUS_CU;
+  const double corner_col = center_col + r * (out_col - in_col);
+  const double corner_row = center_row + r * (out_row - in_row);
+
+  const GlobalPose start = mouse->getGlobalPose();
+  const GlobalPose middle(corner_col + r * (in_col - out_col) / M_SQRT2, corner_row + r * (in_row - out_row) / M_SQRT2,
+                          atan2(in_row + out_row, in_col + out_col));
+  const GlobalPose finish(corner_col + r * in_col, corner_row + r * in_row, atan2(out_row, out_col));
+
+  const double v = smartmouse::kc::TURN_SPEED_CUPS;
+  const double duration = M_PI_2 * r / v;
+  planned = mouse->kinematic_controller.planTraj({
+      {0, GlobalState(GlobalPose(start.col, start.row, atan2(in_row, in_col)), v)},
+      {duration / 2, GlobalState(middle, v)},
+      {duration, GlobalState(finish, v)},
+  });
+}
 
-  if (right_of_dir(curDir) == dir) {
-    mouse->setSpeedCps(fast_speed, slow_speed);
-  } else {
-    mouse->setSpeedCps(slow_speed, fast_speed);
-  }
+void ArcTurn::execute() {
+  double l, r;
+  std::tie(l, r) = mouse->kinematic_controller.trajectoryWheelVelocities();
+  mouse->setSpeedCps(l, r);
 }
 
 bool ArcTurn::isFinished() {
-  curPose = mouse->getGlobalPose();
-  curCol = mouse->getCol();
-  curRow = mouse->getRow();
-  curDir = mouse->getDir();
-
-  dYaw = smartmouse::math::yawDiff(curPose.yaw, goalYaw);
-  return (curCol != startCol) || (curRow != startRow);
+  return !planned || mouse->kinematic_controller.trajectoryFinished();
 }
 
 void ArcTurn::end() {
   mouse->internalTurnToFace(dir);
 }
-
-double ArcTurn::pose_dist(GlobalPose pose, double x, double y) {
-  return sqrtf(powf(pose.col - x, 2) + powf(pose.row - y, 2));
-}
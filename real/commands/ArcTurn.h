@@ -1,8 +1,6 @@
-// TODO: finish unit conversion
-
 #pragma once
-
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Direction.h>
 
 #include <real/RealMouse.h>
@@ -10,9 +8,10 @@
 #include <common/KinematicController/RobotConfig.h>
 #include <common/core/AbstractMaze.h>
 
-class ArcTurn : public Command {
+/** Follows a trajectory planned through the quarter arc that turns the mouse from its heading to dir */
+class ArcTurn : public Command, public PooledCommand<ArcTurn, 4> {
  public:
-  ArcTurn(Direction dir);
+  ArcTurn(RobotContext *context, Direction dir);
 
   void initialize();
 
@@ -21,38 +20,8 @@ class ArcTurn : public Command {
   bool isFinished();
 
   void end();
-
  private:
   RealMouse *mouse;
   Direction dir;
-
-  GlobalPose curPose;
-  unsigned int curCol;
-  unsigned int curRow;
-  Direction curDir;
-
-  GlobalPose startPose;
-  unsigned int startCol;
-  unsigned int startRow;
-
-  double dYaw;
-  double goalYaw;
-
-  double vtc_x;
-  double vtc_y;
-
-  constexpr static double speed_scale = 0.75;
-  double SLOW_ARC_SPEED =
-      speed_scale * (smartmouse::kc::MAX_SPEED_CUPS / (smartmouse::maze::HALF_UNIT_DIST + (smartmouse::kc::TRACK_WIDTH_M / 2)))
-          *
-              (smartmouse::maze::HALF_UNIT_DIST - (smartmouse::kc::TRACK_WIDTH_M / 2));
-  double FAST_ARC_SPEED = speed_scale * (smartmouse::kc::MAX_SPEED_CUPS);
-
-  constexpr static double kp_turn = 3.00;
-  constexpr static double ang_weight = 1.00;
-  constexpr static double arc_weight = 1.00;
-
-  // 3.00,1.00,0.75
-
-  double pose_dist(GlobalPose pose, double x, double y);
+  bool planned = false;
 };
@@ -1,11 +1,22 @@
 #include <common/core/Mouse.h>
 #include "Calibrate.h"
 
-Calibrate::Calibrate() : Command("calibrate"), mouse(RealMouse::inst()) {}
+Calibrate::Calibrate(RobotContext *context) : Command("calibrate"), mouse(context->mouse) {}
 
 void Calibrate::initialize() {
-  int avg_right_adc_ticks = (analogRead(RealMouse::FRONT_RIGHT_ANALOG_PIN) + analogRead(RealMouse::BACK_RIGHT_ANALOG_PIN))/2;
-  mouse->ir_converter.calibrate(avg_right_adc_ticks);
+  // the mouse starts centered in a cell with walls on both sides, so the side sensors know what they should read.
+  // The front and gerald sensors can't see a wall they know the distance to from here, so they keep the measured curve
+  double front_side_dist = (SIDE_WALL_DIST_M - smartmouse::kc::FRONT_SIDE_ANALOG_Y) /
+                           sin(smartmouse::kc::FRONT_ANALOG_ANGLE);
+  double back_side_dist = (SIDE_WALL_DIST_M - smartmouse::kc::BACK_SIDE_ANALOG_Y) /
+                          sin(smartmouse::kc::BACK_ANALOG_ANGLE);
+  // the sampler converts with these tables from the timer interrupt, so it mustn't see one half rebuilt
+  mouse->range_sampler.pause();
+  mouse->front_left_ir.calibrate(mouse->rawRange(RangeSensor::FRONT_LEFT), front_side_dist);
+  mouse->front_right_ir.calibrate(mouse->rawRange(RangeSensor::FRONT_RIGHT), front_side_dist);
+  mouse->back_left_ir.calibrate(mouse->rawRange(RangeSensor::BACK_LEFT), back_side_dist);
+  mouse->back_right_ir.calibrate(mouse->rawRange(RangeSensor::BACK_RIGHT), back_side_dist);
+  mouse->range_sampler.resume();
 }
 
 void Calibrate::execute() {}
@@ -1,16 +1,20 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <real/RealMouse.h>
 
 class Calibrate : public Command {
 public:
-  Calibrate();
+  Calibrate(RobotContext *context);
   void initialize();
   void execute();
   bool isFinished();
   void end();
 
+  /// \brief from the center of the robot to a side wall, when the robot is centered in a cell
+  static constexpr double SIDE_WALL_DIST_M = 0.08;
+
 private:
   RealMouse *mouse;
 };
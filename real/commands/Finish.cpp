@@ -1,6 +1,6 @@
 #include "Finish.h"
 
-Finish::Finish(AbstractMaze *maze) : Command("finish"), maze(maze), mouse(RealMouse::inst()) {
+Finish::Finish(RobotContext *context, AbstractMaze *maze) : Command("finish"), maze(maze), mouse(context->mouse) {
 }
 
 void Finish::initialize() {
@@ -1,12 +1,13 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/AbstractMaze.h>
 #include <real/RealMouse.h>
 
 class Finish : public Command {
 public:
-  Finish(AbstractMaze *maze);
+  Finish(RobotContext *context, AbstractMaze *maze);
 
   void initialize();
   void execute();
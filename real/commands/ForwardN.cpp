@@ -1,7 +1,7 @@
 #include <real/RealMouse.h>
 #include "ForwardN.h"
 
-ForwardN::ForwardN(unsigned int n) : Command("Forward"), mouse(RealMouse::inst()), n(n) {}
+ForwardN::ForwardN(RobotContext *context, unsigned int n) : Command("Forward"), mouse(context->mouse), n(n) {}
 
 
 void ForwardN::initialize() {
@@ -1,14 +1,15 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Mouse.h>
 #include <common/core/Pose.h>
 
 #include <real/RealMouse.h>
 
-class ForwardN : public Command {
+class ForwardN : public Command, public PooledCommand<ForwardN, 4> {
 public:
-  ForwardN(unsigned int n);
+  ForwardN(RobotContext *context, unsigned int n);
 
   void initialize();
 
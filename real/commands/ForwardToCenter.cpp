@@ -1,7 +1,7 @@
 #include <real/RealMouse.h>
 #include "ForwardToCenter.h"
 
-ForwardToCenter::ForwardToCenter() : Command("FwdToCenter"), mouse(RealMouse::inst()) {}
+ForwardToCenter::ForwardToCenter(RobotContext *context) : Command("FwdToCenter"), mouse(context->mouse) {}
 
 void ForwardToCenter::initialize() {
 //  setTimeout(2000);
@@ -1,13 +1,14 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Mouse.h>
 
 #include "RealMouse.h"
 
-class ForwardToCenter : public Command {
+class ForwardToCenter : public Command, public PooledCommand<ForwardToCenter, 4> {
 public:
-  ForwardToCenter();
+  ForwardToCenter(RobotContext *context);
 
   void initialize();
 
@@ -4,8 +4,10 @@
 #include <commands/ForwardToCenter.h>
 #include <commands/TurnInPlace.h>
 
-SolveMaze::SolveMaze(Solver *solver, Solver::Goal goal) : CommandGroup("solve"), solver(solver), movements(0),
-                                                          goal(goal) {}
+SolveMaze::SolveMaze(RobotContext *context, Solver *solver, Solver::Goal goal)
+    : CommandGroup("solve"), context(context), solver(solver), movements(0), goal(goal) {
+  setBudgetUs(BUDGET_US);
+}
 
 void SolveMaze::initialize() {
   solved = false;
@@ -20,6 +22,11 @@ bool SolveMaze::isFinished() {
     bool mazeSolved = solver->isFinished();
 
     if (!mazeSolved) {
+      // keep the robot waiting here until planning is done, instead of planning all at once
+      if (!solver->planSlice(PLAN_EXPANSIONS_PER_CYCLE)) {
+        return false;
+      }
+
       motion_primitive_t prim = solver->planNextStep();
 //      print("%i:%c\r\n", prim.n, dir_to_char(prim.d));
 
@@ -29,16 +36,16 @@ bool SolveMaze::isFinished() {
       }
 
       if (prim.d == solver->mouse->getDir()) {
-        addSequential(new ForwardN(prim.n));
+        addSequential(new ForwardN(context, prim.n));
       } else {
-        addSequential(new Turn(prim.d));
+        addSequential(new Turn(context, prim.d));
       }
 
       movements++;
     } else if (!atCenter){
-      addSequential(new ForwardToCenter());
+      addSequential(new ForwardToCenter(context));
       if (goal == Solver::Goal::START) {
-        addSequential(new TurnInPlace(Direction::E));
+        addSequential(new TurnInPlace(context, Direction::E));
       }
       atCenter = true;
       solved = true;
@@ -1,12 +1,13 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Solver.h>
 #include <common/core/Mouse.h>
 
 class SolveMaze : public CommandGroup {
 public:
-  SolveMaze(Solver *solver, Solver::Goal goal);
+  SolveMaze(RobotContext *context, Solver *solver, Solver::Goal goal);
 
   void initialize();
 
@@ -14,7 +15,14 @@ public:
 
   void end();
 
+  /// \brief planning is spread over cycles, this many distance field expansions at a time
+  static constexpr unsigned int PLAN_EXPANSIONS_PER_CYCLE = 64;
+
+  /// \brief a cycle should leave most of the control period for the kinematic controller
+  static constexpr unsigned long BUDGET_US = 2000;
+
 private:
+  RobotContext *context;
   Solver *solver;
   int movements;
   Solver::Goal goal;
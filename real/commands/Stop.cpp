@@ -1,13 +1,14 @@
 #include <real/RealMouse.h>
 #include "Stop.h"
 
-Stop::Stop() : Command("end") {}
+Stop::Stop(RobotContext *context) : Command("end"), mouse(context->mouse) {}
 
-Stop::Stop(unsigned long stop_time) : Command("end"), stop_time(stop_time) {}
+Stop::Stop(RobotContext *context, unsigned long stop_time)
+    : Command("end"), mouse(context->mouse), stop_time(stop_time) {}
 
 void Stop::initialize() {
   setTimeout(stop_time);
-  RealMouse::inst()->setSpeedCps(0, 0);
+  mouse->setSpeedCps(0, 0);
   digitalWrite(RealMouse::LED_7, 1);
 }
 
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
+#include <real/RealMouse.h>
 
 class Stop : public Command {
 public:
-  Stop();
+  Stop(RobotContext *context);
 
-  Stop(unsigned long stop_time);
+  Stop(RobotContext *context, unsigned long stop_time);
 
   void initialize();
 
@@ -15,5 +17,6 @@ public:
   void end();
 
 private:
+  RealMouse *mouse;
   unsigned long stop_time;
 };
@@ -4,22 +4,22 @@
 #include "ArcTurn.h"
 #include "ForwardToCenter.h"
 
-Turn::Turn(Direction dir) : CommandGroup("RealTurnGroup"), mouse(RealMouse::inst()), dir(dir) {}
+Turn::Turn(RobotContext *context, Direction dir) : CommandGroup("RealTurnGroup"), context(context), mouse(context->mouse), dir(dir) {}
 
 void Turn::initialize() {
   // if we want a logical 180 turn, we do full stop then turn.
   if (opposite_direction(mouse->getDir()) == dir) {
-    addSequential(new ForwardToCenter()); // slowly stop
-    addSequential(new TurnInPlace(dir));
-    addSequential(new Forward());
+    addSequential(new ForwardToCenter(context)); // slowly stop
+    addSequential(new TurnInPlace(context, dir));
+    addSequential(new Forward(context));
   } else if (mouse->getDir() != dir) {
     if (smartmouse::kc::ARC_TURN) {
-      addSequential(new ArcTurn(dir)) ;
+      addSequential(new ArcTurn(context, dir)) ;
     }
     else {
-      addSequential(new ForwardToCenter());
-      addSequential(new TurnInPlace(dir));
-      addSequential(new Forward());
+      addSequential(new ForwardToCenter(context));
+      addSequential(new TurnInPlace(context, dir));
+      addSequential(new Forward(context));
     }
   }
 }
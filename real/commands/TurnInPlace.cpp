@@ -3,7 +3,7 @@
 
 #include "TurnInPlace.h"
 
-TurnInPlace::TurnInPlace(Direction dir) : Command("RealTurnInPlace"), mouse(RealMouse::inst()), dir(dir) {}
+TurnInPlace::TurnInPlace(RobotContext *context, Direction dir) : Command("RealTurnInPlace"), mouse(context->mouse), dir(dir) {}
 
 void TurnInPlace::initialize() {
   setTimeout(2000);
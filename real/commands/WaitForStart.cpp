@@ -4,10 +4,10 @@
 
 bool WaitForStart::calibrated = false;
 
-WaitForStart::WaitForStart() : CommandGroup("wait_calibrate"), mouse(RealMouse::inst()), speed(0) {
+WaitForStart::WaitForStart(RobotContext *context) : CommandGroup("wait_calibrate"), mouse(context->mouse), speed(0) {
   mouse->kinematic_controller.enabled = false;
   if (!calibrated) {
-    addSequential(new Calibrate());
+    addSequential(new Calibrate(context));
     calibrated = true;
   }
 }
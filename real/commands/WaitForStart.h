@@ -1,11 +1,12 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include "RealMouse.h"
 
 class WaitForStart : public CommandGroup {
 public:
-  WaitForStart();
+  WaitForStart(RobotContext *context);
   void initialize();
   void execute();
   bool isFinished();
@@ -3,43 +3,69 @@
 #include <real/ArduinoTimer.h>
 #include <real/RealMouse.h>
 #include <common/core/util.h>
-#include <common/core/Flood.h>
+#include <common/core/Solver.h>
 #include <common/commands/SolveCommand.h>
 
 ArduinoTimer timer;
+IntervalTimer fast_loop_timer;
 AbstractMaze maze;
 Scheduler *scheduler;
 RealMouse *mouse;
+RobotContext context;
 unsigned long last_t, last_blink;
 bool done = false;
 bool on = true;
 bool paused = false;
 
+/// \brief there's no command line on the robot, so pick the solver here
+constexpr Solver::Type SOLVER = Solver::Type::FLOOD;
+
+/// \brief wheel PIDs and odometry at 1 kHz. Sensors, commands, and solving stay in loop() at 100 Hz
+void fast_loop() {
+  mouse->fastRun();
+}
+
 void setup() {
   delay(1000);
-  Command::setTimerImplementation(&timer);
-  mouse = RealMouse::inst();
+  mouse = new RealMouse();
   mouse->setup();
+  context = {mouse, &timer};
 
   GlobalProgramSettings.quiet = false;
 
-//  scheduler = new Scheduler(new NavTestCommand());
-  scheduler = new Scheduler(new SolveCommand(new Flood(mouse)));
+//  scheduler = new Scheduler(new NavTestCommand(&context), context.timer);
+  scheduler = new Scheduler(new SolveCommand(&context, Solver::make(SOLVER, mouse)), context.timer);
+  // the other half of the 10ms period is for reading the sensors and the kinematic controller
+  scheduler->setBudgetUs(5000);
+
+  mouse->useExecutive();
+  fast_loop_timer.begin(fast_loop, MultiRateExecutive::FAST_PERIOD_US);
 
   last_t = timer.programTimeMs();
   last_blink = timer.programTimeMs();
 }
 
 void loop() {
+#ifdef PROFILE
+  // loop() spins between control cycles, so this is the low priority task that sends the telemetry
+  mouse->drainTelemetry();
+#endif
+
   if (Serial1.available()) {
     int c = Serial1.read();
     if (c == (int) 'p') {
       Serial1.clear();
+      paused = !paused;
+      // the fast loop drives the motors, so stop it before turning them off
+      if (paused) {
+        fast_loop_timer.end();
+      } else {
+        fast_loop_timer.begin(fast_loop, MultiRateExecutive::FAST_PERIOD_US);
+      }
       analogWrite(RealMouse::MOTOR_LEFT_A, 0);
       analogWrite(RealMouse::MOTOR_RIGHT_A, 0);
       analogWrite(RealMouse::MOTOR_LEFT_B, 0);
       analogWrite(RealMouse::MOTOR_RIGHT_B, 0);
-      paused = !paused;
     }
   }
 
@@ -70,9 +96,11 @@ void loop() {
 #endif
     done = scheduler->run();
 #ifdef PROFILE
-    Serial.print("Schedule, ");
-    Serial.println(micros() - t0);
+    mouse->telemetry.phase(LoopPhase::SCHEDULE, t0, micros() - t0);
 #endif
+    if (done) {
+      scheduler->printReport();
+    }
   } else {
     mouse->setSpeedCps(0, 0);
     digitalWrite(RealMouse::SYS_LED, 1);
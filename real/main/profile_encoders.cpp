@@ -24,7 +24,7 @@ unsigned long measure() {
 #pragma GCC pop_options
 
 void setup() {
-  mouse = RealMouse::inst();
+  mouse = new RealMouse();
   mouse->setup();
   mouse->kinematic_controller.enabled = false;
 
@@ -1,129 +1,65 @@
-//TODO: finish unit conversion
+#include <cmath>
+#include <tuple>
+#include <utility>
 
-#include <common/math/math.h>
 #include "ArcTurn.h"
 
-ArcTurn::ArcTurn(Direction dir) : Command("SimArcTurn"), mouse(SimMouse::inst()), dir(dir) {}
+namespace {
 
-void ArcTurn::initialize() {
-  mouse->kinematic_controller.enable_sensor_pose_estimate = true;
-  setTimeout(2000);
-  goalYaw = dir_to_yaw(dir);
-  startPose = mouse->getGlobalPose();
-
-  // determine vtc point of arc
-  // inital center of sqaure
-
-  startCol = mouse->getCol();
-  startRow = mouse->getRow();
-  vtc_x = mouse->getCol()*smartmouse::maze::UNIT_DIST_M + smartmouse::maze::HALF_UNIT_DIST;
-  vtc_y = mouse->getRow()*smartmouse::maze::UNIT_DIST_M + smartmouse::maze::HALF_UNIT_DIST;
-
-  end_x = vtc_x;
-  end_y = vtc_y;
-
-  // move to corner
-  switch (mouse->getDir()) {
-    case Direction::N: {
-      vtc_y += smartmouse::maze::HALF_UNIT_DIST;
-      if (dir == Direction::E){
-        vtc_x += smartmouse::maze::HALF_UNIT_DIST;
-      } else {
-        vtc_x -= smartmouse::maze::HALF_UNIT_DIST;
-      }
-      end_x = vtc_x;
-      break;
-    }
-    case Direction::E: {
-      vtc_x -= smartmouse::maze::HALF_UNIT_DIST;
-      if (dir == Direction::S) {
-        vtc_y += smartmouse::maze::HALF_UNIT_DIST;
-      } else {
-        vtc_y -= smartmouse::maze::HALF_UNIT_DIST;
-      }
-      end_y = vtc_y;
-      break;
-    }
-    case Direction::S: {
-      vtc_y -= smartmouse::maze::HALF_UNIT_DIST;
-      if (dir == Direction::W){
-        vtc_x -= smartmouse::maze::HALF_UNIT_DIST;
-      } else {
-        vtc_x += smartmouse::maze::HALF_UNIT_DIST;
-      }
-      end_x = vtc_x;
-      break;
-    }
-    case Direction::W: {
-      vtc_x += smartmouse::maze::HALF_UNIT_DIST;
-      if (dir == Direction::N){
-        vtc_y -= smartmouse::maze::HALF_UNIT_DIST;
-      } else {
-        vtc_y += smartmouse::maze::HALF_UNIT_DIST;
-      }
-      end_y = vtc_y;
-      break;
-    }
-    default:
-      exit(0);
+// one cell step in the given direction, as (col, row)
+std::pair<double, double> cell_step(Direction d) {
+  switch (d) {
+    case Direction::N: return {0, -1};
+    case Direction::E: return {1, 0};
+    case Direction::S: return {0, 1};
+    case Direction::W: return {-1, 0};
+    default: return {0, 0};
   }
-
-  //print("%f,%f\n\r", vtc_x, vtc_y);
-
-  mouse->kinematic_controller.enable_sensor_pose_estimate = true;
-  // when we get close to aligned, there might be a wall we can use to better estimate our angle
-
 }
 
-void ArcTurn::execute() {
-
-  GlobalPose curPose = mouse->getGlobalPose();
-  double cur_x = fabs(curPose.col - vtc_x);
-  double cur_y = fabs(curPose.row - vtc_y);
-
-  double dAngle;
-  if ((dir == Direction::N)||(dir == Direction::S)) {
-    dAngle = atanf(fabs(cur_x/cur_y));
-  } else {
-    dAngle = atanf(fabs(cur_y/cur_x));
-  }
+}
 
-  double ang_error = fabs(smartmouse::math::yawDiff(curPose.yaw, dir_to_yaw(mouse->getDir())))-dAngle;
-  double arc_error = (smartmouse::maze::HALF_UNIT_DIST/pose_dist(mouse->getGlobalPose(), vtc_x, vtc_y))-1;
+ArcTurn::ArcTurn(RobotContext *context, Direction dir) : Command("SimArcTurn"), mouse(context->mouse), dir(dir) {}
 
-  double corr = (ang_error*1.0)+(arc_error*0.5);
-//  print("%f\t%f\n\r", dAngle, smartmouse::math::yawDiff(curPose.yaw, dir_to_yaw(mouse->getDir())));
+void ArcTurn::initialize() {
+  setTimeout(2000);
 
-  double fast_speed = FAST_ARC_SPEED*((corr*-5)+1);
-  double slow_speed = SLOW_ARC_SPEED*((corr*5)+1);
+  // the arc is a quarter circle of radius TURN_RADIUS_CU about the corner of the current cell, from the middle of the
+  // edge we entered through to the middle of the edge facing dir. Headings are in the planner's frame, which is the
+  // same one the odometry integrates in (drow = v * sin(yaw)).
+  const Direction from = mouse->getDir();
+  double in_col, in_row, out_col, out_row;
+  std::tie(in_col, in_row) = cell_step(from);
+  std::tie(out_col, out_row) = cell_step(dir);
+  const double center_col = mouse->getCol() + 0.5, center_row = mouse->getRow() + 0.5;
+  const double r = smartmouse::kc::TURN_RADIUS_CU;
+  const double corner_col = center_col + r * (out_col - in_col);
+  const double corner_row = center_row + r * (out_row - in_row);
+
+  const GlobalPose start = mouse->getGlobalPose();
+  const GlobalPose middle(corner_col + r * (in_col - out_col) / M_SQRT2, corner_row + r * (in_row - out_row) / M_SQRT2,
+                          atan2(in_row + out_row, in_col + out_col));
+  const GlobalPose finish(corner_col + r * in_col, corner_row + r * in_row, atan2(out_row, out_col));
+
+  const double v = smartmouse::kc::TURN_SPEED_CUPS;
+  const double duration = M_PI_2 * r / v;
+  planned = mouse->kinematic_controller.planTraj({
+      {0, GlobalState(GlobalPose(start.col, start.row, atan2(in_row, in_col)), v)},
+      {duration / 2, GlobalState(middle, v)},
+      {duration, GlobalState(finish, v)},
+  });
+}
 
-  if (right_of_dir(mouse->getDir()) == dir ){
-    mouse->setSpeedCps(fast_speed, slow_speed);
-  } else {
-    mouse->setSpeedCps(slow_speed, fast_speed);
-  }
-  // this allows us to use that
-  if (fabs(dYaw) < 0.1 && mouse->kinematic_controller.enable_sensor_pose_estimate) {
-    //digitalWrite(RealMouse::LED_2, 1);
-    // FIXME: this is kind of a hack. It's needed because WallFollower checks dir in order to compute
-    // FIXME: the correct yaw. it adds dir_to_yaw(getDir()), so we must assume we're close enough
-    //mouse->kinematic_controller.enable_sensor_pose_estimate = false;
-    //mouse->internalTurnToFace(dir);
-  }
+void ArcTurn::execute() {
+  double l, r;
+  std::tie(l, r) = mouse->kinematic_controller.trajectoryWheelVelocities();
+  mouse->setSpeedCps(l, r);
 }
 
 bool ArcTurn::isFinished() {
-  double currentYaw = mouse->getGlobalPose().yaw;
-  dYaw = smartmouse::math::yawDiff(currentYaw, goalYaw);
-  return ((fabs(dYaw) < smartmouse::kc::ROT_TOLERANCE) && ((mouse->getCol() != startCol) || (mouse->getRow() != startRow)));
+  return !planned || mouse->kinematic_controller.trajectoryFinished();
 }
 
 void ArcTurn::end() {
-  //digitalWrite(RealMouse::LED_3, 1);
   mouse->internalTurnToFace(dir);
-  mouse->kinematic_controller.enable_sensor_pose_estimate = false;
-}
-
-double ArcTurn::pose_dist(GlobalPose pose, double x, double y) {
-  return sqrtf(powf(pose.col-x,2) + powf(pose.row-y,2));
 }
@@ -1,7 +1,6 @@
-//TODO: finish unit conversion
-
 #pragma once
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Direction.h>
 
 #include <sim/lib/SimMouse.h>
@@ -9,9 +8,10 @@
 #include <common/KinematicController/RobotConfig.h>
 #include <common/core/AbstractMaze.h>
 
-class ArcTurn : public Command {
+/** Follows a trajectory planned through the quarter arc that turns the mouse from its heading to dir */
+class ArcTurn : public Command, public PooledCommand<ArcTurn, 4> {
  public:
-  ArcTurn(Direction dir);
+  ArcTurn(RobotContext *context, Direction dir);
 
   void initialize();
 
@@ -21,25 +21,7 @@ class ArcTurn : public Command {
 
   void end();
  private:
-  double dYaw;
-  double dDisp;
-  double goalYaw;
-  GlobalPose startPose;
-  unsigned int startCol;
-  unsigned int startRow;
-
-  double vtc_x;
-  double vtc_y;
-
-  double end_x;
-  double end_y;
-
   SimMouse *mouse;
   Direction dir;
-  double SLOW_ARC_SPEED =
-      0.75 * (smartmouse::kc::MAX_SPEED_CUPS / (smartmouse::maze::HALF_UNIT_DIST + (smartmouse::kc::TRACK_WIDTH_M / 2)))
-          * (smartmouse::maze::HALF_UNIT_DIST - (smartmouse::kc::TRACK_WIDTH_M / 2));
-  double FAST_ARC_SPEED = 0.75 * smartmouse::kc::MAX_SPEED_CUPS;
-
-  double pose_dist(GlobalPose pose, double x, double y);
+  bool planned = false;
 };
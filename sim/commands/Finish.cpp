@@ -1,10 +1,10 @@
 #include <sim/lib/SimMouse.h>
 #include "Finish.h"
 
-Finish::Finish(AbstractMaze *maze) : Command("end"), maze(maze) {}
+Finish::Finish(RobotContext *context, AbstractMaze *maze) : Command("end"), maze(maze), mouse(context->mouse) {}
 
 void Finish::initialize() {
-  SimMouse::inst()->setSpeedCps(0, 0);
+  mouse->setSpeedCps(0, 0);
   print("end. Solution = %s\n", maze->fastest_route);
 }
 
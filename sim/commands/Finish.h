@@ -1,10 +1,12 @@
 #pragma once
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/AbstractMaze.h>
+#include <sim/lib/SimMouse.h>
 
 class Finish : public Command {
 public:
-  Finish(AbstractMaze *maze);
+  Finish(RobotContext *context, AbstractMaze *maze);
 
   void initialize();
 
@@ -12,5 +14,6 @@ public:
 
 private:
   AbstractMaze *maze;
+  SimMouse *mouse;
 };
 
@@ -1,13 +1,21 @@
 #include <sim/lib/SimMouse.h>
 #include "Forward.h"
 
-Forward::Forward() : Command("Forward"), mouse(SimMouse::inst()) {}
+Forward::Forward(RobotContext *context, double v_final)
+    : Command("Forward"), v_final(v_final), route_profile(nullptr), s(0), mouse(context->mouse) {}
+
+Forward::Forward(RobotContext *context, const VelocityProfile *route_profile, double s)
+    : Command("Forward"), v_final(0), route_profile(route_profile), s(s), mouse(context->mouse) {}
 
 
 void Forward::initialize() {
   start = mouse->getGlobalPose();
   mouse->kinematic_controller.enable_sensor_pose_estimate = true;
-  mouse->kinematic_controller.start(start, KinematicController::dispToNextEdge(mouse));
+  if (route_profile) {
+    mouse->kinematic_controller.startAlong(start, KinematicController::dispToNextEdge(mouse), route_profile, s);
+  } else {
+    mouse->kinematic_controller.start(start, KinematicController::dispToNextEdge(mouse), v_final);
+  }
 }
 
 void Forward::execute() {
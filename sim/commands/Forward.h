@@ -1,14 +1,21 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Mouse.h>
 #include <common/core/Pose.h>
+#include <common/KinematicController/RobotConfig.h>
+#include <common/KinematicController/VelocityProfile.h>
 
 #include <sim/lib/SimMouse.h>
 
-class Forward : public Command {
+class Forward : public Command, public PooledCommand<Forward, smartmouse::maze::SIZE> {
 public:
-  Forward();
+  /** \brief drive to the next cell edge, getting there at v_final */
+  Forward(RobotContext *context, double v_final = smartmouse::kc::TURN_SPEED_CUPS);
+
+  /** \brief drive to the next cell edge, following route_profile from s cells along it */
+  Forward(RobotContext *context, const VelocityProfile *route_profile, double s);
 
   void initialize();
 
@@ -20,6 +27,9 @@ public:
 
 private:
 
+  double v_final;
+  const VelocityProfile *route_profile;
+  double s;
   GlobalPose start;
   SimMouse *mouse;
 
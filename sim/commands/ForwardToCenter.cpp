@@ -1,7 +1,7 @@
 #include <sim/lib/SimMouse.h>
 #include "ForwardToCenter.h"
 
-ForwardToCenter::ForwardToCenter() : Command("FwdToCenter"), mouse(SimMouse::inst()) {}
+ForwardToCenter::ForwardToCenter(RobotContext *context) : Command("FwdToCenter"), mouse(context->mouse) {}
 
 void ForwardToCenter::initialize() {
   start = mouse->getGlobalPose();
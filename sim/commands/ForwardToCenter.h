@@ -1,12 +1,13 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 
 #include <sim/lib/SimMouse.h>
 
-class ForwardToCenter : public Command {
+class ForwardToCenter : public Command, public PooledCommand<ForwardToCenter, 4> {
 public:
-  ForwardToCenter();
+  ForwardToCenter(RobotContext *context);
 
   void initialize();
 
@@ -4,8 +4,10 @@
 #include "Turn.h"
 #include "TurnInPlace.h"
 
-SolveMaze::SolveMaze(Solver *solver, Solver::Goal goal) : CommandGroup("solve"), solver(solver), movements(0),
-                                                          goal(goal) {}
+SolveMaze::SolveMaze(RobotContext *context, Solver *solver, Solver::Goal goal)
+    : CommandGroup("solve"), context(context), solver(solver), movements(0), goal(goal) {
+  setBudgetUs(BUDGET_US);
+}
 
 void SolveMaze::initialize() {
   solved = false;
@@ -20,6 +22,11 @@ bool SolveMaze::isFinished() {
     bool mazeSolved = solver->isFinished();
 
     if (!mazeSolved) {
+      // keep the robot waiting here until planning is done, instead of planning all at once
+      if (!solver->planSlice(PLAN_EXPANSIONS_PER_CYCLE)) {
+        return false;
+      }
+
       motion_primitive_t prim = solver->planNextStep();
 
       if (!solver->isSolvable()) {
@@ -29,17 +36,17 @@ bool SolveMaze::isFinished() {
 
       if (prim.d == solver->mouse->getDir()) {
         for (size_t i = 0; i < prim.n; i++) {
-          addSequential(new Forward());
+          addSequential(new Forward(context));
         }
       } else {
-        addSequential(new Turn(prim.d));
+        addSequential(new Turn(context, prim.d));
       }
 
       movements++;
     } else if (!atCenter){
-      addSequential(new ForwardToCenter());
+      addSequential(new ForwardToCenter(context));
       if (goal == Solver::Goal::START) {
-        addSequential(new TurnInPlace(Direction::E));
+        addSequential(new TurnInPlace(context, Direction::E));
       }
       atCenter = true;
       solved = true;
@@ -1,8 +1,8 @@
 #include "Stop.h"
 
-Stop::Stop() : Command("STOP"), mouse(SimMouse::inst()), stop_time_ms(0) {}
+Stop::Stop(RobotContext *context) : Command("STOP"), mouse(context->mouse), stop_time_ms(0) {}
 
-Stop::Stop(unsigned long stop_time) : mouse(SimMouse::inst()), stop_time_ms(stop_time) {}
+Stop::Stop(RobotContext *context, unsigned long stop_time) : mouse(context->mouse), stop_time_ms(stop_time) {}
 
 void Stop::initialize() {
   setTimeout(stop_time_ms);
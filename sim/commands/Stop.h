@@ -2,13 +2,14 @@
 
 #include <ignition/math.hh>
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <sim/lib/SimMouse.h>
 
 class Stop : public Command {
 public:
-  Stop();
+  Stop(RobotContext *context);
 
-  Stop(unsigned long stop_time);
+  Stop(RobotContext *context, unsigned long stop_time);
 
   void initialize();
 
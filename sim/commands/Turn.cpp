@@ -4,16 +4,16 @@
 #include "ForwardToCenter.h"
 #include "ArcTurn.h"
 
-Turn::Turn(Direction dir) : CommandGroup("SimTurnGroup"), mouse(SimMouse::inst()), dir(dir) {}
+Turn::Turn(RobotContext *context, Direction dir) : CommandGroup("SimTurnGroup"), context(context), mouse(context->mouse), dir(dir) {}
 
 void Turn::initialize() {
   // if we want a logical 180 turn, we do full stop then turn.
   if (opposite_direction(mouse->getDir()) == dir) {
-    addSequential(new ForwardToCenter()); // slowly stop
-    addSequential(new TurnInPlace(dir));
-    addSequential(new Forward());
+    addSequential(new ForwardToCenter(context)); // slowly stop
+    addSequential(new TurnInPlace(context, dir));
+    addSequential(new Forward(context));
   } else if (mouse->getDir() != dir) {
-    addSequential(new ArcTurn(dir));
+    addSequential(new ArcTurn(context, dir));
   }
 }
 
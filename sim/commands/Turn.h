@@ -1,15 +1,17 @@
 #pragma once
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <sim/lib/SimMouse.h>
 #include <common/core/Direction.h>
 
-class Turn : public CommandGroup {
+class Turn : public CommandGroup, public PooledCommand<Turn, 4> {
 public:
-  Turn(Direction dir);
+  Turn(RobotContext *context, Direction dir);
 
   void initialize();
 
 private:
+  RobotContext *context;
   SimMouse *mouse;
   Direction dir;
 };
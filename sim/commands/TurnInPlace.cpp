@@ -1,7 +1,7 @@
 #include <common/math/math.h>
 #include "TurnInPlace.h"
 
-TurnInPlace::TurnInPlace(Direction dir) : Command("SimTurnInPlace"), mouse(SimMouse::inst()), dir(dir) {}
+TurnInPlace::TurnInPlace(RobotContext *context, Direction dir) : Command("SimTurnInPlace"), mouse(context->mouse), dir(dir) {}
 
 void TurnInPlace::initialize() {
   goalYaw = dir_to_yaw(dir);
@@ -1,12 +1,13 @@
 #pragma once
 #include <ignition/math.hh>
 #include <common/commanduino/CommanDuino.h>
+#include <common/commands/RobotContext.h>
 #include <common/core/Direction.h>
 #include <sim/lib/SimMouse.h>
 
-class TurnInPlace : public Command {
+class TurnInPlace : public Command, public PooledCommand<TurnInPlace, 4> {
 public:
-  TurnInPlace(Direction dir);
+  TurnInPlace(RobotContext *context, Direction dir);
 
   void initialize();
 
@@ -2,7 +2,7 @@
 #include <sim/lib/SimMouse.h>
 #include "WaitForStart.h"
 
-WaitForStart::WaitForStart() : Command("wait") {}
+WaitForStart::WaitForStart(RobotContext *context) : Command("wait") {}
 
 void WaitForStart::initialize() {
   print("Reset mouse pose, then press enter to begin...\n");
@@ -16,6 +16,6 @@ bool WaitForStart::isFinished() {
 }
 
 void WaitForStart::end() {
-//  SimMouse::inst()->resetToStartPose();
+//  mouse->resetToStartPose();
 }
 
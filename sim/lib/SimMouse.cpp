@@ -6,23 +6,23 @@
 #include <sim/simulator/msgs/debug_state.pb.h>
 #include <sim/simulator/msgs/robot_command.pb.h>
 
-SimMouse *SimMouse::instance = nullptr;
-
-SimMouse::SimMouse() : kinematic_controller(this), range_data({}) {
+SimMouse::SimMouse()
+    : timer(nullptr),
+      kinematic_controller(this),
+      abstract_left_force(0),
+      abstract_right_force(0),
+      left_wheel_angle_rad(0),
+      right_wheel_angle_rad(0),
+      range_data({}),
+      lock_step(false) {
   dir = Direction::N;
 }
 
-SimMouse *SimMouse::inst() {
-  if (instance == NULL) {
-    instance = new SimMouse();
-  }
-
-  return instance;
-}
-
 SensorReading SimMouse::checkWalls() {
   std::unique_lock<std::mutex> lk(dataMutex);
-  dataCond.wait(lk);
+  if (!lock_step) {
+    dataCond.wait(lk);
+  }
   SensorReading sr(row, col);
 
   sr.walls[static_cast<int>(dir)] = range_data.front < smartmouse::kc::FRONT_WALL_THRESHOLD;
@@ -89,7 +89,9 @@ void SimMouse::speedCallback(const ignition::msgs::Vector2d &msg){
 
 void SimMouse::run() {
   std::unique_lock<std::mutex> lk(dataMutex);
-  dataCond.wait(lk);
+  if (!lock_step) {
+    dataCond.wait(lk);
+  }
 
   // compute dt_s from sensor stamps
   double dt_s = (state_stamp - last_state_stamp).Double();
@@ -105,6 +107,11 @@ void SimMouse::run() {
   row = kinematic_controller.row;
   col = kinematic_controller.col;
 
+  // in lock-step the forces are read back directly, and there's no one listening for debug state
+  if (lock_step) {
+    return;
+  }
+
   smartmouse::msgs::RobotCommand cmd;
   cmd.mutable_left()->set_abstract_force((int) abstract_left_force);
   cmd.mutable_right()->set_abstract_force((int) abstract_right_force);
@@ -113,7 +120,7 @@ void SimMouse::run() {
   smartmouse::msgs::DebugState state;
 
   auto stamp = state.mutable_stamp();
-  unsigned long t_ms = Command::getTimerImplementation()->programTimeMs();
+  unsigned long t_ms = timer->programTimeMs();
   *stamp = smartmouse::msgs::Convert((int) t_ms);
   state.set_left_cps_setpoint(smartmouse::kc::radToCU(kinematic_controller.left_motor.setpoint_rps));
   state.set_left_cps_actual(smartmouse::kc::radToCU(kinematic_controller.left_motor.velocity_rps));
@@ -138,7 +145,6 @@ bool SimMouse::simInit() {
   resetToStartPose();
 
   timer = new SimTimer();
-  Command::setTimerImplementation(timer);
 
   bool success = node.Subscribe(TopicNames::kWorldStatistics, &SimTimer::worldStatsCallback, timer);
   if (!success) {
@@ -175,11 +181,25 @@ bool SimMouse::simInit() {
   debug_state_pub = node.Advertise<smartmouse::msgs::DebugState>(TopicNames::kDebugState);
 
   // wait for time messages to come
-  while (!timer->isTimeReady());
+  timer->waitUntilMs(0);
 
   return EXIT_SUCCESS;
 }
 
+void SimMouse::lockStepInit() {
+  kinematic_controller.setAccelerationCpss(20);
+
+  // we start in the middle of the first square
+  resetToStartPose();
+
+  timer = new SimTimer();
+  lock_step = true;
+}
+
+std::pair<int, int> SimMouse::getAbstractForces() {
+  return {(int) abstract_left_force, (int) abstract_right_force};
+}
+
 void SimMouse::resetToStartPose() {
   reset(); // resets row, col, and dir
   kinematic_controller.reset_col_to(0.5);
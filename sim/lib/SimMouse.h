@@ -16,7 +16,7 @@
 class SimMouse : public Mouse {
 public:
 
-  static SimMouse *inst();
+  SimMouse();
 
   virtual SensorReading checkWalls() override;
 
@@ -42,6 +42,17 @@ public:
 
   bool simInit();
 
+  /**
+   * \brief set up for lock-step with an in-process Server instead of subscribing to transport topics.
+   * In lock-step nothing waits for new data or publishes anything. Whoever steps the server must hand us each new
+   * state with robotSimStateCallback and the time with timer->setSimTimeMs, then call run().
+   * See LockStep in the simulator library, which does exactly that.
+   */
+  void lockStepInit();
+
+  /** \brief the abstract forces computed by the last call to run(), left then right */
+  std::pair<int, int> getAbstractForces();
+
   SimTimer *timer;
   ignition::transport::Node::Publisher cmd_pub;
   ignition::transport::Node::Publisher debug_state_pub;
@@ -53,10 +64,6 @@ public:
 
 private:
 
-  SimMouse();
-
-  static SimMouse *instance;
-
   double abstract_left_force;
   double abstract_right_force;
   double left_wheel_angle_rad;
@@ -64,6 +71,8 @@ private:
 
   RangeData range_data;
 
+  bool lock_step;
+
   std::condition_variable dataCond;
   std::mutex dataMutex;
 
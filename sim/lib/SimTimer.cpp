@@ -2,7 +2,7 @@
 #include <simulator/msgs/msgs.h>
 #include "SimTimer.h"
 
-SimTimer::SimTimer() : ready(false), sim_time_ms(1) {
+SimTimer::SimTimer() : ready(false), sim_time_ms(1), resets(0), waiters(0) {
   timeReadyMutex.lock();
 }
 
@@ -15,11 +15,37 @@ unsigned long SimTimer::programTimeMs() {
 }
 
 void SimTimer::worldStatsCallback(const smartmouse::msgs::WorldStatistics &msg) {
-  sim_time_ms = smartmouse::msgs::ConvertMSec(msg.sim_time());
+  setSimTimeMs(smartmouse::msgs::ConvertMSec(msg.sim_time()));
+}
 
-  if (!ready) {
+void SimTimer::setSimTimeMs(unsigned long sim_time_ms) {
+  bool first;
+  {
+    std::lock_guard<std::mutex> lk(timeMutex);
+    if (ready && sim_time_ms < this->sim_time_ms) {
+      resets++;
+    }
+    this->sim_time_ms = sim_time_ms;
+    first = !ready;
     ready = true;
+  }
+  timeCond.notify_all();
+
+  if (first) {
     timeReadyMutex.unlock();
   }
 }
 
+unsigned long SimTimer::waitUntilMs(unsigned long t_ms) {
+  std::unique_lock<std::mutex> lk(timeMutex);
+  unsigned long resets_before = resets;
+  waiters++;
+  timeCond.wait(lk, [&]() { return ready && (sim_time_ms >= t_ms || resets != resets_before); });
+  waiters--;
+  return sim_time_ms;
+}
+
+bool SimTimer::hasWaiters() {
+  std::lock_guard<std::mutex> lk(timeMutex);
+  return waiters > 0;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <common/commanduino/CommanDuino.h>
+#include <condition_variable>
 #include <mutex>
 #include <sim/simulator/msgs/world_statistics.pb.h>
 
@@ -14,9 +15,29 @@ public:
 
   void worldStatsCallback(const smartmouse::msgs::WorldStatistics &msg);
 
+  /** \brief set the time directly, for when the server is stepped in-process instead of over transport */
+  void setSimTimeMs(unsigned long sim_time_ms);
+
+  /**
+   * \brief sleep until the first time message has come and sim time has reached t_ms.
+   * Control loops use this to wake up once per period instead of spinning on programTimeMs().
+   * Sim time going backwards, like when the server's time is reset, wakes the waiter too, since t_ms is then far off.
+   * \return the sim time when we woke up. That's past t_ms if the server publishes less often than that, and before it
+   * if the time was reset
+   */
+  unsigned long waitUntilMs(unsigned long t_ms);
+
+  /** \brief whether any thread is in waitUntilMs() */
+  bool hasWaiters();
+
 private:
   bool ready;
   unsigned long sim_time_ms;
+  /// \brief how many times sim time has gone backwards
+  unsigned long resets;
+  unsigned int waiters;
   std::mutex timeReadyMutex;
+  std::mutex timeMutex;
+  std::condition_variable timeCond;
 
 };
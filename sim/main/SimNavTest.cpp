@@ -3,42 +3,46 @@
 
 class Stop : public Command {
  public:
+  Stop(RobotContext *context) : mouse(context->mouse) {}
+
   void initialize() {
-    SimMouse::inst()->setSpeedCps(0, 0);
+    mouse->setSpeedCps(0, 0);
   }
   bool isFinished() {
     return false;
   }
+
+ private:
+  SimMouse *mouse;
 };
 
 class NavTestCommand : public CommandGroup {
  public:
-  NavTestCommand() : CommandGroup("NavTestGroup") {
-    addSequential(new Forward());
-    addSequential(new Stop());
+  NavTestCommand(RobotContext *context) : CommandGroup("NavTestGroup") {
+    addSequential(new Forward(context));
+    addSequential(new Stop(context));
   }
 };
 
+constexpr unsigned long CONTROL_PERIOD_MS = 10;
+
 int main(int argc, char *argv[]) {
-  SimMouse *mouse = SimMouse::inst();
+  SimMouse *mouse = new SimMouse();
   mouse->simInit();
 
-  Scheduler scheduler(new NavTestCommand());
+  RobotContext context{mouse, mouse->timer};
+  Scheduler scheduler(new NavTestCommand(&context), context.timer);
 
   bool done = false;
-  unsigned long last_t = mouse->timer->programTimeMs();
+  unsigned long next_t = mouse->timer->programTimeMs();
   while (!done) {
-    unsigned long now = mouse->timer->programTimeMs();
-    double dt_s = (now - last_t) / 1000.0;
-
-    if (dt_s < 0.010) {
-      continue;
-    }
+    next_t += CONTROL_PERIOD_MS;
+    // if we fell behind, run once and start counting again from now instead of running several times to catch up.
+    // If the server's time was reset, we wake up early and start counting again from the new time too
+    next_t = mouse->timer->waitUntilMs(next_t);
 
     mouse->run();
     done = scheduler.run();
-
-    last_t = now;
   }
 }
 
@@ -1,31 +1,48 @@
+#include <cstring>
+
 #include <common/commanduino/CommanDuino.h>
 #include <common/commands/SolveCommand.h>
-#include <common/core/Flood.h>
+#include <common/core/Solver.h>
 
 #include <sim/lib/SimTimer.h>
 #include <sim/lib/SimMouse.h>
 
+// minimum period of main loop
+constexpr unsigned long CONTROL_PERIOD_MS = 10;
+
 int main(int argc, char *argv[]) {
-  SimMouse *mouse = SimMouse::inst();
+  Solver::Type solver_type = Solver::Type::FLOOD;
+  if (argc == 3 && strcmp(argv[1], "-a") == 0) {
+    if (!Solver::parseType(argv[2], &solver_type)) {
+      printf("unknown solver [%s]\n", argv[2]);
+      return EXIT_FAILURE;
+    }
+  } else if (argc != 1) {
+    printf("USAGE: SimSolve [-a flood|astar|wallfollow]\n");
+    return EXIT_FAILURE;
+  }
+
+  SimMouse *mouse = new SimMouse();
 
   mouse->simInit();
 
-  Scheduler scheduler(new SolveCommand(new Flood(mouse)));
+  RobotContext context{mouse, mouse->timer};
+  Scheduler scheduler(new SolveCommand(&context, Solver::make(solver_type, mouse)), context.timer);
+  scheduler.setBudgetUs(CONTROL_PERIOD_MS * 1000 / 2);
 
+  // sleep between control periods, woken by the server's time messages, so we don't hog a core
   bool done = false;
-  unsigned long last_t = mouse->timer->programTimeMs();
+  unsigned long next_t = mouse->timer->programTimeMs();
   while (!done) {
-    unsigned long now = mouse->timer->programTimeMs();
-    double dt_s = (now - last_t) / 1000.0;
-
-    // minimum period of main loop
-    if (dt_s < 0.010) {
-      continue;
-    }
+    next_t += CONTROL_PERIOD_MS;
+    // if we fell behind, run once and start counting again from now instead of running several times to catch up.
+    // If the server's time was reset, we wake up early and start counting again from the new time too
+    next_t = mouse->timer->waitUntilMs(next_t);
 
     mouse->run();
     done = scheduler.run();
-    last_t = now;
   }
+
+  scheduler.printReport();
 }
 
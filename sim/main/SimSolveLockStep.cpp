@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#include <common/commanduino/CommanDuino.h>
+#include <common/commands/SolveCommand.h>
+#include <common/core/Solver.h>
+#include <common/core/util.h>
+
+#include <sim/lib/SimMouse.h>
+#include <sim/simulator/lib/LockStep.h>
+#include <sim/simulator/msgs/msgs.h>
+
+/**
+ * Solves a maze with the simulator running in this process, instead of talking to SmartmouseSim over transport.
+ * Physics and the mouse take turns on one thread, so the run is as fast as the CPU allows and the same every time.
+ */
+int main(int argc, char *argv[]) {
+  Solver::Type solver_type = Solver::Type::FLOOD;
+  if (argc == 5 && strcmp(argv[1], "-a") == 0) {
+    if (!Solver::parseType(argv[2], &solver_type)) {
+      printf("unknown solver [%s]\n", argv[2]);
+      return EXIT_FAILURE;
+    }
+    argv += 2;
+    argc -= 2;
+  }
+  if (argc != 3) {
+    printf("USAGE: SimSolveLockStep [-a flood|astar|wallfollow] maze.mz mouse.ms\n");
+    return EXIT_FAILURE;
+  }
+
+  std::ifstream maze_fs;
+  maze_fs.open(argv[1], std::ifstream::in);
+  if (!maze_fs.good()) {
+    printf("error opening maze file [%s]\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  AbstractMaze maze(maze_fs);
+
+  std::ifstream mouse_fs;
+  mouse_fs.open(argv[2], std::ifstream::in);
+  if (!mouse_fs.good()) {
+    printf("error opening mouse file [%s]\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  Server server;
+  server.OnMaze(smartmouse::msgs::Convert(&maze));
+  server.OnRobotDescription(smartmouse::msgs::Convert(mouse_fs));
+
+  SimMouse *mouse = new SimMouse();
+  mouse->lockStepInit();
+  LockStep lock_step(&server, mouse);
+
+  // there's no one to press enter
+  GlobalProgramSettings.quiet = true;
+
+  RobotContext context{mouse, mouse->timer};
+  Scheduler scheduler(new SolveCommand(&context, Solver::make(solver_type, mouse)), context.timer);
+
+  auto t0 = std::chrono::steady_clock::now();
+  bool done = false;
+  while (!done) {
+    lock_step.Step();
+    done = scheduler.run();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  printf("simulated %.3f s in %.3f s of wall time\n", server.GetSimTime().Double(),
+         std::chrono::duration<double>(t1 - t0).count());
+  scheduler.printReport();
+  return EXIT_SUCCESS;
+}
@@ -1,21 +1,20 @@
 #include <sim/lib/SimMouse.h>
 
+constexpr unsigned long CONTROL_PERIOD_MS = 10;
+
 int main(int argc, const char **argv) {
-  SimMouse *mouse = SimMouse::inst();
+  SimMouse *mouse = new SimMouse();
   mouse->simInit();
 
-  unsigned long last_t_ms;
+  unsigned long next_t_ms = mouse->timer->programTimeMs();
   bool done = false;
   while (!done) {
-    unsigned long now_ms = mouse->timer->programTimeMs();
-    double dt_s = (now_ms - last_t_ms) / 1000.0;
-
-    if (dt_s < 0.01) {
-      continue;
-    }
+    next_t_ms += CONTROL_PERIOD_MS;
+    // if we fell behind, run once and start counting again from now instead of running several times to catch up.
+    // If the server's time was reset, we wake up early and start counting again from the new time too
+    next_t_ms = mouse->timer->waitUntilMs(next_t_ms);
 
     mouse->run();
-    last_t_ms = now_ms;
   }
 }
 
@@ -0,0 +1,174 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <common/KinematicController/RobotConfig.h>
+#include <common/core/AbstractMaze.h>
+#include <sim/simulator/lib/common/RayCastGrid.h>
+#include <sim/simulator/lib/common/RayTracing.h>
+#include <sim/simulator/msgs/msgs.h>
+
+/**
+ * Times the three ways of simulating the robot's seven range sensors, on random poses in each maze given.
+ *  - segment: RayTracing::distance_to_wall on every edge of every wall within a window of cells, one ray at a time
+ *  - grid: RayCastGrid::Cast, walking cells along each ray
+ *  - batch: RayCastGrid::CastBatch, all seven rays against the cells they start in at once, then a walk per ray
+ */
+
+namespace {
+
+constexpr int SENSORS = 7;
+
+struct Poses {
+  std::vector<RayCastGrid::RayBatch> origin_col, origin_row, dir_col, dir_row;
+};
+
+/// \brief seven sensors in a rough circle around the robot, at random poses that aren't inside a wall
+Poses random_poses(unsigned int n) {
+  const double sensor_theta[SENSORS] = {0, 0.8, -0.8, 1.57, -1.57, 2.4, -2.4};
+  const double sensor_offset = 0.2;
+
+  Poses poses;
+  for (unsigned int i = 0; i < n; i++) {
+    double col = 0.5 + (smartmouse::maze::SIZE - 1) * (double) rand() / RAND_MAX;
+    double row = 0.5 + (smartmouse::maze::SIZE - 1) * (double) rand() / RAND_MAX;
+    double yaw = 2 * M_PI * (double) rand() / RAND_MAX;
+    RayCastGrid::RayBatch oc, orow, dc, dr;
+    for (int k = 0; k < RayCastGrid::BATCH; k++) {
+      double theta = yaw + sensor_theta[k % SENSORS];
+      oc[k] = col + sensor_offset * cos(theta);
+      orow[k] = row + sensor_offset * sin(theta);
+      dc[k] = cos(theta);
+      dr[k] = sin(theta);
+    }
+    poses.origin_col.push_back(oc);
+    poses.origin_row.push_back(orow);
+    poses.dir_col.push_back(dc);
+    poses.dir_row.push_back(dr);
+  }
+  return poses;
+}
+
+/// \brief the way Server did it before RayCastGrid
+double segment_cast(smartmouse::msgs::maze_walls_t &maze_walls, double col, double row, double dir_col,
+                    double dir_row, unsigned int cells_to_check) {
+  double min_range = smartmouse::kc::ANALOG_MAX_DIST_CU;
+  ignition::math::Vector2d s_origin(col, row);
+  ignition::math::Vector2d s_direction(dir_col, dir_row);
+  unsigned int min_r = (unsigned int) std::max(0, (int) row - (int) cells_to_check);
+  unsigned int max_r = std::min(smartmouse::maze::SIZE, (unsigned int) row + cells_to_check);
+  unsigned int min_c = (unsigned int) std::max(0, (int) col - (int) cells_to_check);
+  unsigned int max_c = std::min(smartmouse::maze::SIZE, (unsigned int) col + cells_to_check);
+  for (unsigned int r = min_r; r < max_r; r++) {
+    for (unsigned int c = min_c; c < max_c; c++) {
+      for (auto wall : maze_walls[r][c]) {
+        std::vector<ignition::math::Line2d> wall_lines_;
+        wall_lines_.push_back(ignition::math::Line2d(wall.c1(), wall.r1(), wall.c1(), wall.r2()));
+        wall_lines_.push_back(ignition::math::Line2d(wall.c1(), wall.r2(), wall.c2(), wall.r2()));
+        wall_lines_.push_back(ignition::math::Line2d(wall.c2(), wall.r2(), wall.c2(), wall.r1()));
+        wall_lines_.push_back(ignition::math::Line2d(wall.c2(), wall.r1(), wall.c1(), wall.r1()));
+        for (auto line : wall_lines_) {
+          std::experimental::optional<double> range = RayTracing::distance_to_wall(line, s_origin, s_direction);
+          if (range && *range < min_range) {
+            min_range = *range;
+          }
+        }
+      }
+    }
+  }
+  return min_range;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printf("USAGE: RayCastBenchmark [-n poses] maze.mz [maze.mz ...]\n");
+    return EXIT_FAILURE;
+  }
+
+  int first_maze_arg = 1;
+  unsigned int n = 100000;
+  if (argc > 3 && std::string(argv[1]) == "-n") {
+    n = (unsigned int) atoi(argv[2]);
+    first_maze_arg = 3;
+  }
+
+  const double max_range = smartmouse::kc::ANALOG_MAX_DIST_CU;
+  // wide enough around each sensor that the window never misses a wall, so all three should agree
+  const unsigned int cells_to_check = 3;
+
+  printf("%-24s %14s %14s %14s %10s\n", "maze", "segment ns", "grid ns", "batch ns", "match");
+
+  bool all_match = true;
+  for (int arg = first_maze_arg; arg < argc; arg++) {
+    std::ifstream fs;
+    fs.open(argv[arg], std::ifstream::in);
+    if (!fs.good()) {
+      printf("error opening maze file [%s]\n", argv[arg]);
+      return EXIT_FAILURE;
+    }
+    AbstractMaze maze(fs);
+    fs.close();
+
+    static smartmouse::msgs::maze_walls_t maze_walls;
+    smartmouse::msgs::Convert(smartmouse::msgs::Convert(&maze), maze_walls);
+    std::vector<RayCastGrid::WallRect> walls;
+    for (unsigned int r = 0; r < smartmouse::maze::SIZE; r++) {
+      for (unsigned int c = 0; c < smartmouse::maze::SIZE; c++) {
+        for (auto wall : maze_walls[r][c]) {
+          walls.push_back({wall.c1(), wall.r1(), wall.c2(), wall.r2()});
+        }
+      }
+    }
+    RayCastGrid grid;
+    grid.Build(walls);
+
+    Poses poses = random_poses(n);
+    std::vector<double> segment_ranges(n * SENSORS), grid_ranges(n * SENSORS), batch_ranges(n * SENSORS);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < n; i++) {
+      for (int k = 0; k < SENSORS; k++) {
+        segment_ranges[i * SENSORS + k] = segment_cast(maze_walls, poses.origin_col[i][k], poses.origin_row[i][k],
+                                                       poses.dir_col[i][k], poses.dir_row[i][k], cells_to_check);
+      }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < n; i++) {
+      for (int k = 0; k < SENSORS; k++) {
+        grid_ranges[i * SENSORS + k] = grid.Cast(poses.origin_col[i][k], poses.origin_row[i][k], poses.dir_col[i][k],
+                                                 poses.dir_row[i][k], max_range);
+      }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < n; i++) {
+      RayCastGrid::RayBatch ranges = grid.CastBatch(poses.origin_col[i], poses.origin_row[i], poses.dir_col[i],
+                                                    poses.dir_row[i], max_range);
+      for (int k = 0; k < SENSORS; k++) {
+        batch_ranges[i * SENSORS + k] = ranges[k];
+      }
+    }
+    auto t3 = std::chrono::steady_clock::now();
+
+    bool match = true;
+    for (unsigned int i = 0; i < n * SENSORS; i++) {
+      match &= std::fabs(segment_ranges[i] - grid_ranges[i]) < 1e-6;
+      match &= std::fabs(grid_ranges[i] - batch_ranges[i]) < 1e-9;
+    }
+    all_match &= match;
+
+    // per pose, so per step of the simulator
+    auto ns = [n](std::chrono::steady_clock::duration d) {
+      return std::chrono::duration<double, std::nano>(d).count() / n;
+    };
+    printf("%-24s %14.1f %14.1f %14.1f %10s\n", argv[arg], ns(t1 - t0), ns(t2 - t1), ns(t3 - t2),
+           match ? "yes" : "NO");
+  }
+
+  return all_match ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,6 +1,7 @@
 #include <getopt.h>
 #include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <lib/Server.h>
 #include <QtWidgets/QApplication>
 #include <lib/Client.h>
@@ -10,13 +11,68 @@ void PrintVersionInfo() {
   printf("SmartmouseSim v 0.0.0\n");
 }
 
+/**
+ * Runs the server with no GUI, stepping as fast as possible, until someone publishes a quit message.
+ * The maze and mouse come from files instead of the GUI, and state is only published publish_rate_hz times per
+ * second of sim time, so robot programs and tools can still listen on the usual topics.
+ */
+int RunHeadless(std::string maze_file, std::string mouse_file, double publish_rate_hz) {
+  std::ifstream maze_fs;
+  maze_fs.open(maze_file, std::ifstream::in);
+  if (!maze_fs.good()) {
+    std::cout << "error opening maze file [" << maze_file << "]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  AbstractMaze maze(maze_fs);
+
+  std::ifstream mouse_fs;
+  mouse_fs.open(mouse_file, std::ifstream::in);
+  if (!mouse_fs.good()) {
+    std::cout << "error opening mouse file [" << mouse_file << "]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Server server;
+  server.Connect();
+
+  smartmouse::msgs::PhysicsConfig physics_msg;
+  physics_msg.set_as_fast_as_possible(true);
+  physics_msg.set_publish_rate_hz(publish_rate_hz);
+  server.OnPhysics(physics_msg);
+  server.OnMaze(smartmouse::msgs::Convert(&maze));
+  server.OnRobotDescription(smartmouse::msgs::Convert(mouse_fs));
+
+  smartmouse::msgs::ServerControl unpause_msg;
+  unpause_msg.set_pause(false);
+  server.OnServerControl(unpause_msg);
+
+  bool done = false;
+  while (!done) {
+    done = server.Run();
+  }
+
+  return EXIT_SUCCESS;
+}
+
 int main(int argc, char *argv[]) {
 
   // TODO: add proper argument parsing, and a way to pass them to the Client
   int c;
+  bool headless = false;
+  std::string maze_file;
+  std::string mouse_file;
+  double publish_rate_hz = 0;
+
+  static struct option long_options[] = {
+      {"headless", no_argument, nullptr, 'H'},
+      {"maze", required_argument, nullptr, 'm'},
+      {"mouse", required_argument, nullptr, 'r'},
+      {"publish-rate", required_argument, nullptr, 'p'},
+      {nullptr, 0, nullptr, 0}
+  };
 
   while (1) {
-    c = getopt_long(argc, argv, "-v", nullptr, nullptr);
+    c = getopt_long(argc, argv, "-v", long_options, nullptr);
 
     /* Detect the end of the options. */
     if (c == -1)
@@ -27,6 +83,22 @@ int main(int argc, char *argv[]) {
         PrintVersionInfo();
         return EXIT_SUCCESS;
       }
+      case 'H': {
+        headless = true;
+        break;
+      }
+      case 'm': {
+        maze_file = optarg;
+        break;
+      }
+      case 'r': {
+        mouse_file = optarg;
+        break;
+      }
+      case 'p': {
+        publish_rate_hz = atof(optarg);
+        break;
+      }
       case '?': { break; }
       default: {
         std::cout << "Invalid Arugments" << std::endl;
@@ -35,6 +107,14 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  if (headless) {
+    if (maze_file.empty() || mouse_file.empty()) {
+      std::cout << "--headless needs --maze and --mouse" << std::endl;
+      return EXIT_FAILURE;
+    }
+    return RunHeadless(maze_file, mouse_file, publish_rate_hz);
+  }
+
   ignition::transport::Node node;
   auto server_pub = node.Advertise<smartmouse::msgs::ServerControl>(TopicNames::kServerControl);
 
@@ -0,0 +1,20 @@
+#include <cmath>
+
+#include <sim/simulator/lib/LockStep.h>
+
+LockStep::LockStep(Server *server, SimMouse *mouse, unsigned int steps_per_control_period)
+    : server_(server), mouse_(mouse), steps_per_control_period_(steps_per_control_period) {
+  // the mouse reads sensors before it has ever been stepped, so give it the starting state
+  UpdateMouse(server_->GetRobotState());
+}
+
+void LockStep::Step() {
+  std::pair<int, int> forces = mouse_->getAbstractForces();
+  UpdateMouse(server_->StepWithCommand(forces.first, forces.second, steps_per_control_period_));
+  mouse_->run();
+}
+
+void LockStep::UpdateMouse(const smartmouse::msgs::RobotSimState &state) {
+  mouse_->timer->setSimTimeMs((unsigned long) std::lround(server_->GetSimTime().Double() * 1000));
+  mouse_->robotSimStateCallback(state);
+}
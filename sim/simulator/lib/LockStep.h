@@ -0,0 +1,27 @@
+#pragma once
+
+#include <sim/lib/SimMouse.h>
+#include <sim/simulator/lib/Server.h>
+
+/**
+ * \brief runs a SimMouse and an in-process Server in lock-step on one thread.
+ * Each Step() runs the physics for one control period with the mouse's last command, gives the mouse the new state
+ * and time, and then runs the mouse's controller once. There's no transport, no waiting on other threads, and nothing
+ * is serialized, so a step is cheap and a run is reproducible down to the bit.
+ *
+ * The server needs a maze and robot description before the mouse will go anywhere, and the mouse must be set up
+ * with lockStepInit() instead of simInit().
+ */
+class LockStep {
+ public:
+  LockStep(Server *server, SimMouse *mouse, unsigned int steps_per_control_period = 10);
+
+  void Step();
+
+ private:
+  void UpdateMouse(const smartmouse::msgs::RobotSimState &state);
+
+  Server *server_;
+  SimMouse *mouse_;
+  unsigned int steps_per_control_period_;
+};
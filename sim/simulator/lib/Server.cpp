@@ -1,9 +1,11 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
 #include <limits>
 
 #include <common/KinematicController/RobotConfig.h>
 #include <common/math/math.h>
 #include <common/KinematicController/KinematicController.h>
-#include <sim/simulator/lib/common/RayTracing.h>
 #include <sim/simulator/lib/Server.h>
 #include <sim/simulator/lib/common/TopicNames.h>
 #include <sim/simulator/msgs/world_statistics.pb.h>
@@ -18,8 +20,12 @@ Server::Server()
       ns_of_sim_per_step_(1000000u),
       pause_at_steps_(0),
       real_time_factor_(1),
+      as_fast_as_possible_(false),
+      publish_period_(Time::Zero),
+      last_publish_time_(Time::Zero),
       mouse_set_(false),
-      max_cells_to_check_(0) {
+      ray_cast_total_us_(0),
+      ray_cast_steps_(0) {
   ResetRobot(0.5, 0.5, 0);
 }
 
@@ -60,9 +66,13 @@ bool Server::Run() {
     return false;
   }
 
+  bool as_fast_as_possible;
+  bool publish;
+
   // Begin Critical Section
   {
     std::lock_guard<std::mutex> guard(physics_mutex_);
+    as_fast_as_possible = as_fast_as_possible_;
     if (quit_) {
       return true;
     }
@@ -80,11 +90,14 @@ bool Server::Run() {
     }
 
     Step();
+    publish = PublishDue();
   }
   // End Critical Section
 
   Time end_step_time = Time::GetWallTime();
-  if (end_step_time > desired_end_time) {
+  if (as_fast_as_possible) {
+    // headless runs don't wait for the wall clock at all
+  } else if (end_step_time > desired_end_time) {
     // FIXME: do proper logging control
     // std::cout << "step took too long. Skipping sleep." << std::endl;
   } else {
@@ -96,15 +109,65 @@ bool Server::Run() {
   Time actual_end_step_time = Time::GetWallTime();
   double rtf = update_rate.Double() / (actual_end_step_time - start_step_time).Double();
 
-  // This will send a message the GUI so it can update
-  PublishInternalState();
+  if (publish) {
+    // This will send a message the GUI so it can update
+    PublishInternalState();
+
+    // announce completion of this step
+    PublishWorldStats(rtf);
+  }
+
+  return false;
+}
+
+void Server::RunSteps(unsigned long n) {
+  Time update_rate = Time(0, ns_of_sim_per_step_);
+  for (unsigned long i = 0; i < n; i++) {
+    Time start_step_time = Time::GetWallTime();
+    bool publish;
+    {
+      std::lock_guard<std::mutex> guard(physics_mutex_);
+      Step();
+      publish = PublishDue();
+    }
+
+    if (publish) {
+      double rtf = update_rate.Double() / (Time::GetWallTime() - start_step_time).Double();
+      PublishInternalState();
+      PublishWorldStats(rtf);
+    }
+  }
+}
 
-  // announce completion of this step
-  PublishWorldStats(rtf);
+const smartmouse::msgs::RobotSimState &Server::StepWithCommand(int left_abstract_force, int right_abstract_force,
+                                                               unsigned int n) {
+  std::lock_guard<std::mutex> guard(physics_mutex_);
+  cmd_.mutable_left()->set_abstract_force(left_abstract_force);
+  cmd_.mutable_right()->set_abstract_force(right_abstract_force);
+  for (unsigned int i = 0; i < n; i++) {
+    Step();
+  }
+  return robot_state_;
+}
 
+bool Server::PublishDue() {
+  if (publish_period_ == Time::Zero || sim_time_ - last_publish_time_ >= publish_period_) {
+    last_publish_time_ = sim_time_;
+    return true;
+  }
   return false;
 }
 
+smartmouse::msgs::RobotSimState Server::GetRobotState() {
+  std::lock_guard<std::mutex> guard(physics_mutex_);
+  return robot_state_;
+}
+
+Time Server::GetSimTime() {
+  std::lock_guard<std::mutex> guard(physics_mutex_);
+  return sim_time_;
+}
+
 void Server::Step() {
   // update sim time
   auto dt = Time(0, ns_of_sim_per_step_);
@@ -192,19 +255,25 @@ void Server::UpdateRobotState(double dt) {
   // handle wrap-around of theta
   smartmouse::math::wrapAngleRadInPlace(&new_yaw);
 
-  // Ray trace to find distance to walls
-  // iterate over every line segment in the maze (all edges of all walls)
-  // find the intersection of that wall with each sensor
-  // if the intersection exists, and the distance is the shortest range for that sensor, replace the current range
+  // Ray trace to find distance to walls, from where the robot was at the start of the step
   auto stamp = robot_state_.mutable_stamp();
   *stamp = sim_time_.toIgnMsg();
-  robot_state_.set_front(ComputeSensorDistToWall(mouse_.sensors().front()));
-  robot_state_.set_front_left(ComputeSensorDistToWall(mouse_.sensors().front_left()));
-  robot_state_.set_front_right(ComputeSensorDistToWall(mouse_.sensors().front_right()));
-  robot_state_.set_gerald_left(ComputeSensorDistToWall(mouse_.sensors().gerald_left()));
-  robot_state_.set_gerald_right(ComputeSensorDistToWall(mouse_.sensors().gerald_right()));
-  robot_state_.set_back_left(ComputeSensorDistToWall(mouse_.sensors().back_left()));
-  robot_state_.set_back_right(ComputeSensorDistToWall(mouse_.sensors().back_right()));
+  auto ray_cast_start = std::chrono::steady_clock::now();
+  const smartmouse::msgs::SensorDescription *sensors[SENSOR_COUNT] = {
+      &mouse_.sensors().front(), &mouse_.sensors().front_left(), &mouse_.sensors().front_right(),
+      &mouse_.sensors().gerald_left(), &mouse_.sensors().gerald_right(), &mouse_.sensors().back_left(),
+      &mouse_.sensors().back_right()};
+  RayCastGrid::RayBatch ranges = ComputeSensorDistsToWalls(sensors);
+  robot_state_.set_front(ranges[0]);
+  robot_state_.set_front_left(ranges[1]);
+  robot_state_.set_front_right(ranges[2]);
+  robot_state_.set_gerald_left(ranges[3]);
+  robot_state_.set_gerald_right(ranges[4]);
+  robot_state_.set_back_left(ranges[5]);
+  robot_state_.set_back_right(ranges[6]);
+  auto ray_cast_end = std::chrono::steady_clock::now();
+  ray_cast_total_us_ += std::chrono::duration<double, std::micro>(ray_cast_end - ray_cast_start).count();
+  ++ray_cast_steps_;
 
   if (!static_) {
     robot_state_.mutable_p()->set_col(new_col);
@@ -229,6 +298,7 @@ void Server::UpdateRobotState(double dt) {
 
 void Server::ResetTime() {
   sim_time_ = Time::Zero;
+  last_publish_time_ = Time::Zero;
   steps_ = 0UL;
   pause_at_steps_ = 0ul;
 
@@ -259,15 +329,26 @@ void Server::ResetRobot(double reset_col, double reset_row, double reset_yaw) {
 }
 
 void Server::PublishInternalState() {
+  if (!connected_) {
+    return;
+  }
   sim_state_pub_.Publish(robot_state_);
 }
 
 void Server::PublishWorldStats(double rtf) {
+  if (!connected_) {
+    return;
+  }
   smartmouse::msgs::WorldStatistics world_stats_msg;
   world_stats_msg.set_steps(steps_);
   ignition::msgs::Time *sim_time_msg = world_stats_msg.mutable_sim_time();
   *sim_time_msg = sim_time_.toIgnMsg();
   world_stats_msg.set_real_time_factor(rtf);
+  if (ray_cast_steps_ > 0) {
+    world_stats_msg.set_ray_cast_us(ray_cast_total_us_ / ray_cast_steps_);
+    ray_cast_total_us_ = 0;
+    ray_cast_steps_ = 0;
+  }
   world_stats_pub_.Publish(world_stats_msg);
 }
 
@@ -318,10 +399,20 @@ void Server::OnPhysics(const smartmouse::msgs::PhysicsConfig &msg) {
       ns_of_sim_per_step_ = msg.ns_of_sim_per_step();
     }
     if (msg.has_real_time_factor()) {
-      if (msg.real_time_factor() >= 1e-3 && msg.real_time_factor() <= 10) {
+      if (msg.real_time_factor() >= 1e-3) {
         real_time_factor_ = msg.real_time_factor();
       }
     }
+    if (msg.has_as_fast_as_possible()) {
+      as_fast_as_possible_ = msg.as_fast_as_possible();
+    }
+    if (msg.has_publish_rate_hz()) {
+      if (msg.publish_rate_hz() > 0) {
+        publish_period_ = Time(1.0 / msg.publish_rate_hz());
+      } else {
+        publish_period_ = Time::Zero;
+      }
+    }
   }
   // End critical section
 }
@@ -330,7 +421,22 @@ void Server::OnMaze(const smartmouse::msgs::Maze &msg) {
   // Enter critical section
   {
     std::lock_guard<std::mutex> guard(physics_mutex_);
-    smartmouse::msgs::Convert(msg, maze_walls_);
+    if (!smartmouse::msgs::Convert(msg, maze_walls_)) {
+      // keep simulating the maze we have rather than reading walls outside of it
+      std::cout << "ignoring a maze of size " << msg.size() << ", this server was built for "
+                << smartmouse::maze::SIZE << std::endl;
+      return;
+    }
+
+    std::vector<RayCastGrid::WallRect> walls;
+    for (unsigned int r = 0; r < smartmouse::maze::SIZE; r++) {
+      for (unsigned int c = 0; c < smartmouse::maze::SIZE; c++) {
+        for (auto wall : maze_walls_[r][c]) {
+          walls.push_back({wall.c1(), wall.r1(), wall.c2(), wall.r2()});
+        }
+      }
+    }
+    ray_cast_grid_.Build(walls);
   }
   // End critical section
 }
@@ -349,7 +455,6 @@ void Server::OnRobotDescription(const smartmouse::msgs::RobotDescription &msg) {
   {
     std::lock_guard<std::mutex> guard(physics_mutex_);
     mouse_ = msg;
-    ComputeMaxSensorRange();
     mouse_set_ = true;
   }
   // End critical section
@@ -367,70 +472,32 @@ unsigned int Server::getNsOfSimPerStep() const {
   return ns_of_sim_per_step_;
 }
 
-double Server::ComputeSensorDistToWall(smartmouse::msgs::SensorDescription sensor) {
-  double min_range = smartmouse::kc::ANALOG_MAX_DIST_CU;
-  double sensor_col = smartmouse::maze::toCellUnits(sensor.p().x());
-  double sensor_row = smartmouse::maze::toCellUnits(sensor.p().y());
+RayCastGrid::RayBatch Server::ComputeSensorDistsToWalls(
+    const smartmouse::msgs::SensorDescription *const sensors[SENSOR_COUNT]) {
   double robot_theta = robot_state_.p().yaw();
-  ignition::math::Vector3d s_origin_3d(sensor_col, sensor_row, 1);
   ignition::math::Matrix3d tf(cos(robot_theta), -sin(robot_theta), robot_state_.p().col(),
                               sin(robot_theta), cos(robot_theta), robot_state_.p().row(),
                               0, 0, 1);
-  s_origin_3d = tf * s_origin_3d;
-  ignition::math::Vector2d s_origin(s_origin_3d.X(), s_origin_3d.Y());
-  ignition::math::Vector2d s_direction(cos(robot_theta + sensor.p().theta()), sin(robot_theta + sensor.p().theta()));
-
-  // iterate over the lines of walls that are nearby
-  int row = (int) robot_state_.p().row();
-  int col = (int) robot_state_.p().col();
-  unsigned int min_r = (unsigned int) std::max(0, row - (int) max_cells_to_check_);
-  unsigned int max_r = std::min(smartmouse::maze::SIZE, row + max_cells_to_check_);
-  unsigned int min_c = (unsigned int) std::max(0, col - (int) max_cells_to_check_);
-  unsigned int max_c = std::min(smartmouse::maze::SIZE, col + max_cells_to_check_);
-  for (unsigned int r = min_r; r < max_r; r++) {
-    for (unsigned int c = min_c; c < max_c; c++) {
-      // get the walls at r/c
-      for (auto wall : maze_walls_[r][c]) {
-        std::vector<ignition::math::Line2d> wall_lines_;
-        wall_lines_.push_back(ignition::math::Line2d(wall.c1(), wall.r1(), wall.c1(), wall.r2()));
-        wall_lines_.push_back(ignition::math::Line2d(wall.c1(), wall.r2(), wall.c2(), wall.r2()));
-        wall_lines_.push_back(ignition::math::Line2d(wall.c2(), wall.r2(), wall.c2(), wall.r1()));
-        wall_lines_.push_back(ignition::math::Line2d(wall.c2(), wall.r1(), wall.c1(), wall.r1()));
-        for (auto line : wall_lines_) {
-          std::experimental::optional<double> range = RayTracing::distance_to_wall(line, s_origin, s_direction);
-          if (range && *range < min_range) {
-            min_range = *range;
-          }
-        }
-      }
-    }
-  }
 
-  if (min_range < smartmouse::kc::ANALOG_MIN_DIST_CU) {
-    min_range = smartmouse::kc::ANALOG_MIN_DIST_CU;
+  // the lanes past the last sensor repeat the first one
+  RayCastGrid::RayBatch origin_col, origin_row, dir_col, dir_row;
+  for (int k = 0; k < RayCastGrid::BATCH; k++) {
+    const smartmouse::msgs::SensorDescription &sensor = *sensors[k % SENSOR_COUNT];
+    double sensor_col = smartmouse::maze::toCellUnits(sensor.p().x());
+    double sensor_row = smartmouse::maze::toCellUnits(sensor.p().y());
+    ignition::math::Vector3d s_origin_3d = tf * ignition::math::Vector3d(sensor_col, sensor_row, 1);
+    double sensor_theta = robot_theta + sensor.p().theta();
+    origin_col[k] = s_origin_3d.X();
+    origin_row[k] = s_origin_3d.Y();
+    dir_col[k] = cos(sensor_theta);
+    dir_row[k] = sin(sensor_theta);
   }
 
-  return smartmouse::maze::toMeters(min_range);
-}
-
-void Server::ComputeMaxSensorRange() {
-  double max_range = 0;
-
-  max_range = std::max(max_range, ComputeSensorRange(mouse_.sensors().front()));
-  max_range = std::max(max_range, ComputeSensorRange(mouse_.sensors().front_left()));
-  max_range = std::max(max_range, ComputeSensorRange(mouse_.sensors().front_right()));
-  max_range = std::max(max_range, ComputeSensorRange(mouse_.sensors().gerald_left()));
-  max_range = std::max(max_range, ComputeSensorRange(mouse_.sensors().gerald_right()));
-  max_range = std::max(max_range, ComputeSensorRange(mouse_.sensors().back_left()));
-  max_range = std::max(max_range, ComputeSensorRange(mouse_.sensors().back_right()));
-
-  max_cells_to_check_ = (unsigned int) std::ceil(smartmouse::maze::toCellUnits(max_range));
-}
-
-const double Server::ComputeSensorRange(const smartmouse::msgs::SensorDescription sensor) {
-  double sensor_x = sensor.p().x();
-  double sensor_y = sensor.p().x();
-  double range_x = sensor_x + cos(sensor.p().theta()) * smartmouse::kc::ANALOG_MAX_DIST_M;
-  double range_y = sensor_y + sin(sensor.p().theta()) * smartmouse::kc::ANALOG_MAX_DIST_M;
-  return std::hypot(range_x, range_y);
+  RayCastGrid::RayBatch ranges = ray_cast_grid_.CastBatch(origin_col, origin_row, dir_col, dir_row,
+                                                          smartmouse::kc::ANALOG_MAX_DIST_CU);
+  for (int k = 0; k < RayCastGrid::BATCH; k++) {
+    double min_range = std::max(ranges[k], smartmouse::kc::ANALOG_MIN_DIST_CU);
+    ranges[k] = smartmouse::maze::toMeters(min_range);
+  }
+  return ranges;
 }
@@ -6,6 +6,7 @@
 
 #include <common/core/AbstractMaze.h>
 #include <sim/lib/Time.h>
+#include <sim/simulator/lib/common/RayCastGrid.h>
 #include <sim/simulator/msgs/server_control.pb.h>
 #include <sim/simulator/msgs/physics_config.pb.h>
 #include <sim/simulator/msgs/maze.pb.h>
@@ -28,23 +29,46 @@ class Server {
   bool IsConnected();
   unsigned int getNsOfSimPerStep() const;
 
-  std::thread *thread_;
- private:
+  /**
+   * \brief step n times back to back on the calling thread, never sleeping and ignoring pause.
+   * State is published at the configured publish rate, if we're connected.
+   */
+  void RunSteps(unsigned long n);
+
+  /**
+   * \brief the lock-step interface. Applies the command, then steps n times on the calling thread.
+   * Nothing is published, and the state is handed back by reference instead of being copied. The reference is only
+   * safe to read until the server is stepped again, so this is meant for one thread driving both robot and physics.
+   */
+  const smartmouse::msgs::RobotSimState &StepWithCommand(int left_abstract_force, int right_abstract_force,
+                                                         unsigned int n);
+
+  smartmouse::msgs::RobotSimState GetRobotState();
+  Time GetSimTime();
+
+  // These are called by transport when we're connected, but they can also be called directly.
+  // That way the server can be used in-process as a library, without Connect() or a thread of its own.
   void OnServerControl(const smartmouse::msgs::ServerControl &msg);
   void OnPhysics(const smartmouse::msgs::PhysicsConfig &msg);
   void OnMaze(const smartmouse::msgs::Maze &msg);
   void OnRobotCommand(const smartmouse::msgs::RobotCommand &msg);
   void OnRobotDescription(const smartmouse::msgs::RobotDescription &msg);
 
+  std::thread *thread_;
+ private:
   void UpdateRobotState(double dt);
   void ResetRobot(double reset_col, double reset_row, double reset_yaw);
   void ResetTime();
+  bool PublishDue();
   void PublishInternalState();
   void PublishWorldStats(double rtf);
-  void ComputeMaxSensorRange();
-  const double ComputeSensorRange(const smartmouse::msgs::SensorDescription sensor);
 
-  double ComputeSensorDistToWall(smartmouse::msgs::SensorDescription sensor);
+  static constexpr int SENSOR_COUNT = 7;
+  static_assert(SENSOR_COUNT <= RayCastGrid::BATCH, "every sensor needs its own lane");
+
+  /** \brief the distance in meters from each sensor to the nearest wall, all cast in one batch */
+  RayCastGrid::RayBatch ComputeSensorDistsToWalls(
+      const smartmouse::msgs::SensorDescription *const sensors[SENSOR_COUNT]);
 
   ignition::transport::Node *node_ptr_;
   ignition::transport::Node::Publisher world_stats_pub_;
@@ -59,10 +83,15 @@ class Server {
   unsigned int ns_of_sim_per_step_ = 1000000u;
   unsigned long pause_at_steps_ = 0ul;
   double real_time_factor_ = 1.0;
+  bool as_fast_as_possible_ = false;
+  Time publish_period_;
+  Time last_publish_time_;
   smartmouse::msgs::maze_walls_t maze_walls_;
   smartmouse::msgs::RobotCommand cmd_;
   smartmouse::msgs::RobotDescription mouse_;
   smartmouse::msgs::RobotSimState robot_state_;
   bool mouse_set_;
-  unsigned int max_cells_to_check_;
+  RayCastGrid ray_cast_grid_;
+  double ray_cast_total_us_;
+  unsigned long ray_cast_steps_;
 };
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <set>
+#include <tuple>
+
+#include <sim/simulator/lib/common/RayCastGrid.h>
+
+namespace {
+
+/// \brief the first and last padded cell index whose closed range [i, i + 1] overlaps [a, b]
+std::pair<int, int> overlapping_cells(double a, double b, int w) {
+  int first = (int) std::ceil(a + 1) - 1;
+  int last = (int) std::floor(b + 1);
+  return {std::max(0, first), std::min(w - 1, last)};
+}
+
+}
+
+RayCastGrid::RayCastGrid() {
+  Build({});
+}
+
+void RayCastGrid::Build(const std::vector<WallRect> &walls) {
+  // the same wall can come from both of the cells it separates
+  std::set<std::tuple<double, double, double, double>> seen;
+  std::vector<WallRect> unique_walls;
+  for (auto wall : walls) {
+    if (seen.insert(std::make_tuple(wall.c1, wall.r1, wall.c2, wall.r2)).second) {
+      unique_walls.push_back(wall);
+    }
+  }
+
+  BuildTable(&vertical_, unique_walls, true);
+  BuildTable(&horizontal_, unique_walls, false);
+}
+
+void RayCastGrid::BuildTable(EdgeTable *table, const std::vector<WallRect> &walls, bool vertical) {
+  // each rectangle has two vertical edges, at c1 and c2, and two horizontal edges, at r1 and r2
+  struct Edge {
+    double at, lo, hi;
+  };
+  std::vector<Edge> edges;
+  for (auto wall : walls) {
+    if (vertical) {
+      edges.push_back({wall.c1, std::min(wall.r1, wall.r2), std::max(wall.r1, wall.r2)});
+      edges.push_back({wall.c2, std::min(wall.r1, wall.r2), std::max(wall.r1, wall.r2)});
+    } else {
+      edges.push_back({wall.r1, std::min(wall.c1, wall.c2), std::max(wall.c1, wall.c2)});
+      edges.push_back({wall.r2, std::min(wall.c1, wall.c2), std::max(wall.c1, wall.c2)});
+    }
+  }
+
+  // count how many edges touch each cell, then fill them in, so each cell's edges end up next to each other
+  auto for_each_cell = [](const Edge &edge, bool vertical, std::function<void(unsigned int)> f) {
+    auto along = overlapping_cells(edge.at, edge.at, W);
+    auto across = overlapping_cells(edge.lo, edge.hi, W);
+    for (int i = along.first; i <= along.second; i++) {
+      for (int j = across.first; j <= across.second; j++) {
+        // vertical edges sit at a col and span rows, horizontal edges the other way around
+        unsigned int row = (unsigned int) (vertical ? j : i);
+        unsigned int col = (unsigned int) (vertical ? i : j);
+        f(row * W + col);
+      }
+    }
+  };
+
+  std::vector<unsigned int> counts(W * W, 0);
+  for (auto &edge : edges) {
+    for_each_cell(edge, vertical, [&](unsigned int cell) { counts[cell]++; });
+  }
+
+  table->cell_start.assign(W * W + 1, 0);
+  for (unsigned int cell = 0; cell < W * W; cell++) {
+    table->cell_start[cell + 1] = table->cell_start[cell] + counts[cell];
+  }
+
+  unsigned int total = table->cell_start[W * W];
+  table->at.assign(total, 0);
+  table->lo.assign(total, 0);
+  table->hi.assign(total, 0);
+  std::vector<unsigned int> next(table->cell_start.begin(), table->cell_start.end() - 1);
+  for (auto &edge : edges) {
+    for_each_cell(edge, vertical, [&](unsigned int cell) {
+      unsigned int i = next[cell]++;
+      table->at[i] = edge.at;
+      table->lo[i] = edge.lo;
+      table->hi[i] = edge.hi;
+    });
+  }
+}
+
+double RayCastGrid::Cast(double origin_col, double origin_row, double dir_col, double dir_row,
+                         double max_range) const {
+  // skip no cells
+  return Walk(origin_col, origin_row, dir_col, dir_row, max_range, 0, -1, 0, -1);
+}
+
+RayCastGrid::RayBatch RayCastGrid::CastBatch(const RayBatch &origin_col, const RayBatch &origin_row,
+                                             const RayBatch &dir_col, const RayBatch &dir_row,
+                                             double max_range) const {
+  // a direction of zero gives an infinite inverse, and then a t of inf or nan, both of which fail the tests below
+  RayBatch inv_dir_col, inv_dir_row, best;
+  int x0 = W, x1 = -1, y0 = W, y1 = -1;
+  for (int k = 0; k < BATCH; k++) {
+    inv_dir_col[k] = 1 / dir_col[k];
+    inv_dir_row[k] = 1 / dir_row[k];
+    best[k] = max_range;
+
+    int cx = (int) std::floor(origin_col[k] + 1);
+    int cy = (int) std::floor(origin_row[k] + 1);
+    x0 = std::min(x0, cx);
+    x1 = std::max(x1, cx);
+    y0 = std::min(y0, cy);
+    y1 = std::max(y1, cy);
+  }
+
+  // Rays from one robot mostly start in the same cell or two, and a lot of them end there too. The edges of those
+  // cells are tested against every lane at once. If the rays are spread out, every lane walks on its own instead.
+  bool shared = x0 >= 0 && y0 >= 0 && x1 < W && y1 < W && (x1 - x0 + 1) * (y1 - y0 + 1) <= MAX_SHARED_CELLS;
+  if (!shared) {
+    x0 = 0, x1 = -1, y0 = 0, y1 = -1;
+  }
+  for (int cy = y0; cy <= y1; cy++) {
+    for (int cx = x0; cx <= x1; cx++) {
+      unsigned int cell = (unsigned int) (cy * W + cx);
+
+      for (unsigned int i = vertical_.cell_start[cell]; i < vertical_.cell_start[cell + 1]; i++) {
+        const double at = vertical_.at[i];
+        const double lo = vertical_.lo[i];
+        const double hi = vertical_.hi[i];
+        // unrolling this before it's vectorized leaves it scalar, and then it's slower than walking every ray
+#pragma GCC unroll 1
+        for (int k = 0; k < BATCH; k++) {
+          double t = (at - origin_col[k]) * inv_dir_col[k];
+          double row = origin_row[k] + t * dir_row[k];
+          bool hit = (t >= 0) & (t < best[k]) & (row >= lo) & (row <= hi);
+          best[k] = hit ? t : best[k];
+        }
+      }
+
+      for (unsigned int i = horizontal_.cell_start[cell]; i < horizontal_.cell_start[cell + 1]; i++) {
+        const double at = horizontal_.at[i];
+        const double lo = horizontal_.lo[i];
+        const double hi = horizontal_.hi[i];
+        // unrolling this before it's vectorized leaves it scalar, and then it's slower than walking every ray
+#pragma GCC unroll 1
+        for (int k = 0; k < BATCH; k++) {
+          double t = (at - origin_row[k]) * inv_dir_row[k];
+          double col = origin_col[k] + t * dir_col[k];
+          bool hit = (t >= 0) & (t < best[k]) & (col >= lo) & (col <= hi);
+          best[k] = hit ? t : best[k];
+        }
+      }
+    }
+  }
+
+  // then each lane only goes on through the cells its own ray crosses, and only as far as it has to
+  for (int k = 0; k < BATCH; k++) {
+    best[k] = Walk(origin_col[k], origin_row[k], dir_col[k], dir_row[k], best[k], x0, x1, y0, y1);
+  }
+
+  return best;
+}
+
+double RayCastGrid::Walk(double origin_col, double origin_row, double dir_col, double dir_row, double best,
+                         int skip_x0, int skip_x1, int skip_y0, int skip_y1) const {
+  constexpr double inf = std::numeric_limits<double>::infinity();
+
+  // padded cell coordinates
+  double x = origin_col + 1;
+  double y = origin_row + 1;
+  int cx = (int) std::floor(x);
+  int cy = (int) std::floor(y);
+  if (cx < 0 || cy < 0 || cx >= W || cy >= W) {
+    return best;
+  }
+
+  int step_x = dir_col > 0 ? 1 : -1;
+  int step_y = dir_row > 0 ? 1 : -1;
+  double t_delta_x = dir_col != 0 ? 1 / std::fabs(dir_col) : inf;
+  double t_delta_y = dir_row != 0 ? 1 / std::fabs(dir_row) : inf;
+  double t_max_x = dir_col != 0 ? (dir_col > 0 ? cx + 1 - x : x - cx) * t_delta_x : inf;
+  double t_max_y = dir_row != 0 ? (dir_row > 0 ? cy + 1 - y : y - cy) * t_delta_y : inf;
+  double inv_dir_col = 1 / dir_col;
+  double inv_dir_row = 1 / dir_row;
+
+  while (true) {
+    bool skip = cx >= skip_x0 && cx <= skip_x1 && cy >= skip_y0 && cy <= skip_y1;
+    if (!skip) {
+      unsigned int cell = (unsigned int) (cy * W + cx);
+
+      // no branches on the hits, they're as good as random
+      for (unsigned int i = vertical_.cell_start[cell]; i < vertical_.cell_start[cell + 1]; i++) {
+        double t = (vertical_.at[i] - origin_col) * inv_dir_col;
+        double row = origin_row + t * dir_row;
+        bool hit = (t >= 0) & (t < best) & (row >= vertical_.lo[i]) & (row <= vertical_.hi[i]);
+        best = hit ? t : best;
+      }
+
+      for (unsigned int i = horizontal_.cell_start[cell]; i < horizontal_.cell_start[cell + 1]; i++) {
+        double t = (horizontal_.at[i] - origin_row) * inv_dir_row;
+        double col = origin_col + t * dir_col;
+        bool hit = (t >= 0) & (t < best) & (col >= horizontal_.lo[i]) & (col <= horizontal_.hi[i]);
+        best = hit ? t : best;
+      }
+    }
+
+    // every cell after this one is further along the ray than where we leave this one
+    double t_exit = std::min(t_max_x, t_max_y);
+    if (best <= t_exit) {
+      break;
+    }
+
+    if (t_max_x < t_max_y) {
+      cx += step_x;
+      t_max_x += t_delta_x;
+    } else {
+      cy += step_y;
+      t_max_y += t_delta_y;
+    }
+
+    if (cx < 0 || cy < 0 || cx >= W || cy >= W) {
+      break;
+    }
+  }
+
+  return best;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <common/core/AbstractMaze.h>
+
+/**
+ * \brief casts rays against the walls of a maze by walking the cells the ray passes through.
+ * Every wall is a rectangle, and its four edges are binned into each cell they touch. Vertical and horizontal edges
+ * are kept in separate flat arrays, indexed per cell, so a cell's edges are contiguous in memory.
+ * Cast() visits cells in order along the ray (Amanatides & Woo) and stops at the first cell that holds a hit, so the
+ * cost depends on how far the ray goes, not on how many walls are nearby.
+ *
+ * Coordinates are in cell units, with col as x and row as y, the same as the rest of the simulator.
+ */
+class RayCastGrid {
+ public:
+  struct WallRect {
+    double c1, r1, c2, r2;
+  };
+
+  /// \brief one lane per ray. Eight lanes fit the robot's seven sensors and split evenly into SSE or AVX registers
+  static constexpr int BATCH = 8;
+  typedef std::array<double, BATCH> RayBatch;
+
+  RayCastGrid();
+
+  /** \brief replace all the walls. Only this allocates, casting never does */
+  void Build(const std::vector<WallRect> &walls);
+
+  /**
+   * \brief distance from the origin along the direction to the nearest wall edge
+   * \param dir_col, dir_row must be a unit vector
+   * \return the distance in cell units, or max_range if no wall is closer than that
+   */
+  double Cast(double origin_col, double origin_row, double dir_col, double dir_row, double max_range) const;
+
+  /**
+   * \brief Cast() for a whole batch of rays that start close together, like the sensors on one robot.
+   * The edges of the few cells the rays start in are tested against all the rays at once, in loops over lanes with no
+   * branches that the compiler turns into SIMD. Then each ray walks on through only the cells it crosses, like Cast().
+   * Unused lanes can hold a copy of any other ray.
+   */
+  RayBatch CastBatch(const RayBatch &origin_col, const RayBatch &origin_row, const RayBatch &dir_col,
+                     const RayBatch &dir_row, double max_range) const;
+
+ private:
+  // one extra cell all the way around, because walls on the edge of the maze stick out past it
+  static constexpr int W = smartmouse::maze::SIZE + 2;
+
+  /** \brief edges at a fixed coordinate, spanning lo to hi along the other axis. SoA and grouped by cell */
+  struct EdgeTable {
+    std::vector<unsigned int> cell_start;
+    std::vector<double> at;
+    std::vector<double> lo;
+    std::vector<double> hi;
+  };
+
+  /// \brief at most this many cells are shared by all the lanes in CastBatch. A robot's sensors start in up to four
+  static constexpr int MAX_SHARED_CELLS = 4;
+
+  static void BuildTable(EdgeTable *table, const std::vector<WallRect> &walls, bool vertical);
+
+  /**
+   * \brief walk the cells along one ray, testing their edges, until nothing further on could beat best.
+   * Cells from skip_x0 to skip_x1 and skip_y0 to skip_y1, in padded cell coordinates, have already been tested.
+   */
+  double Walk(double origin_col, double origin_row, double dir_col, double dir_row, double best, int skip_x0,
+              int skip_x1, int skip_y0, int skip_y1) const;
+
+  EdgeTable vertical_;
+  EdgeTable horizontal_;
+};
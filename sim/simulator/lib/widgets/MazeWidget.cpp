@@ -145,7 +145,9 @@ const QString MazeWidget::GetTabName() {
 }
 
 void MazeWidget::OnMaze(const smartmouse::msgs::Maze &msg) {
-  smartmouse::msgs::Convert(msg, maze_walls_);
+  if (!smartmouse::msgs::Convert(msg, maze_walls_)) {
+    return;
+  }
   emit MyUpdate();
 }
 
@@ -1,17 +1,20 @@
+#include <cstdio>
+
 #include <sim/simulator/lib/common/json.hpp>
 #include "msgs.h"
 
 namespace smartmouse {
 namespace msgs {
 
-smartmouse::msgs::Maze Convert(AbstractMaze *maze, std::string name, int size) {
+template<unsigned int S>
+smartmouse::msgs::Maze Convert(BasicMaze<S> *maze, std::string name) {
   Maze maze_msg;
   maze_msg.set_name(name);
-  maze_msg.set_size(size);
+  maze_msg.set_size(S);
 
   unsigned int r, c;
-  for (r = 0; r < smartmouse::maze::SIZE; r++) {
-    for (c = 0; c < smartmouse::maze::SIZE; c++) {
+  for (r = 0; r < S; r++) {
+    for (c = 0; c < S; c++) {
       Node *n = maze->nodes[r][c];
       if (n->neighbor(::Direction::E) == nullptr) {
         Wall *wall = maze_msg.add_walls();
@@ -29,7 +32,7 @@ smartmouse::msgs::Maze Convert(AbstractMaze *maze, std::string name, int size) {
   }
 
   unsigned int i;
-  for (i = 0; i < smartmouse::maze::SIZE; i++) {
+  for (i = 0; i < S; i++) {
     Wall *left_col_wall = maze_msg.add_walls();
     left_col_wall->set_row(i);
     left_col_wall->set_col(0);
@@ -44,19 +47,55 @@ smartmouse::msgs::Maze Convert(AbstractMaze *maze, std::string name, int size) {
   return maze_msg;
 }
 
-AbstractMaze Convert(smartmouse::msgs::Maze maze_msg) {
-  AbstractMaze maze;
+template<unsigned int S>
+bool FitsMaze(const smartmouse::msgs::Maze &maze_msg) {
+  // messages from before the size was sent are taken to be the size we were built for
+  if (maze_msg.has_size() && maze_msg.size() != (int) S) {
+    return false;
+  }
+  for (const Wall &wall : maze_msg.walls()) {
+    if (wall.row() >= S || wall.col() >= S) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<unsigned int S>
+bool Convert(const smartmouse::msgs::Maze &maze_msg, BasicMaze<S> *maze) {
+  if (!FitsMaze<S>(maze_msg)) {
+    return false;
+  }
 
-  maze.connect_all_neighbors_in_maze();
-  for (Wall wall : maze_msg.walls()) {
+  maze->connect_all_neighbors_in_maze();
+  for (const Wall &wall : maze_msg.walls()) {
     smartmouse::msgs::Direction::Dir dir_msg = wall.direction();
     ::Direction dir = Convert(dir_msg);
-    maze.disconnect_neighbor(wall.row(), wall.col(), dir);
+    maze->disconnect_neighbor(wall.row(), wall.col(), dir);
   }
+  return true;
+}
 
+AbstractMaze Convert(smartmouse::msgs::Maze maze_msg) {
+  AbstractMaze maze;
+  if (!Convert(maze_msg, &maze)) {
+    printf("maze message of size %i doesn't fit a %u by %u maze\n", maze_msg.size(), smartmouse::maze::SIZE,
+          smartmouse::maze::SIZE);
+  }
   return maze;
 }
 
+smartmouse::msgs::Maze Convert(const MazeRecord &record) {
+  AbstractMaze maze;
+  record.to_abstract_maze(&maze);
+  return Convert(&maze, record.get_name());
+}
+
+MazeRecord ConvertToRecord(smartmouse::msgs::Maze maze_msg) {
+  AbstractMaze maze = Convert(maze_msg);
+  return MazeRecord::from_maze(&maze, maze_msg.name());
+}
+
 ::Direction Convert(smartmouse::msgs::Direction dir_msg) {
   return Convert(dir_msg.direction());
 }
@@ -152,9 +191,14 @@ unsigned long ConvertMSec(ignition::msgs::Time time) {
   return time.sec() * 1000ul + time.nsec() / 1000000ul;
 }
 
-void Convert(smartmouse::msgs::Maze maze, maze_walls_t &maze_lines) {
-  for (unsigned int r = 0; r < smartmouse::maze::SIZE; r++) {
-    for (unsigned int c = 0; c < smartmouse::maze::SIZE; c++) {
+template<unsigned int S>
+bool Convert(const smartmouse::msgs::Maze &maze, basic_maze_walls_t<S> &maze_lines) {
+  if (!FitsMaze<S>(maze)) {
+    return false;
+  }
+
+  for (unsigned int r = 0; r < S; r++) {
+    for (unsigned int c = 0; c < S; c++) {
       std::vector<smartmouse::msgs::WallPoints> &walls = maze_lines[r][c];
       walls.clear();
     }
@@ -171,6 +215,7 @@ void Convert(smartmouse::msgs::Maze maze, maze_walls_t &maze_lines) {
     wall_pts.set_r2(r2);
     walls.push_back(wall_pts);
   }
+  return true;
 }
 
 std::tuple<double, double, double, double> WallToCoordinates(smartmouse::msgs::Wall wall) {
@@ -220,5 +265,30 @@ ignition::msgs::Time Convert(int time_millis) {
   return t;
 }
 
+template smartmouse::msgs::Maze Convert<8>(BasicMaze<8> *maze, std::string name);
+template bool FitsMaze<8>(const smartmouse::msgs::Maze &maze_msg);
+template bool Convert<8>(const smartmouse::msgs::Maze &maze_msg, BasicMaze<8> *maze);
+template bool Convert<8>(const smartmouse::msgs::Maze &maze, basic_maze_walls_t<8> &maze_lines);
+
+template smartmouse::msgs::Maze Convert<16>(BasicMaze<16> *maze, std::string name);
+template bool FitsMaze<16>(const smartmouse::msgs::Maze &maze_msg);
+template bool Convert<16>(const smartmouse::msgs::Maze &maze_msg, BasicMaze<16> *maze);
+template bool Convert<16>(const smartmouse::msgs::Maze &maze, basic_maze_walls_t<16> &maze_lines);
+
+template smartmouse::msgs::Maze Convert<32>(BasicMaze<32> *maze, std::string name);
+template bool FitsMaze<32>(const smartmouse::msgs::Maze &maze_msg);
+template bool Convert<32>(const smartmouse::msgs::Maze &maze_msg, BasicMaze<32> *maze);
+template bool Convert<32>(const smartmouse::msgs::Maze &maze, basic_maze_walls_t<32> &maze_lines);
+
+#if SMARTMOUSE_MAZE_SIZE != 8 && SMARTMOUSE_MAZE_SIZE != 16 && SMARTMOUSE_MAZE_SIZE != 32
+template smartmouse::msgs::Maze Convert<smartmouse::maze::SIZE>(BasicMaze<smartmouse::maze::SIZE> *maze,
+                                                                std::string name);
+template bool FitsMaze<smartmouse::maze::SIZE>(const smartmouse::msgs::Maze &maze_msg);
+template bool Convert<smartmouse::maze::SIZE>(const smartmouse::msgs::Maze &maze_msg,
+                                              BasicMaze<smartmouse::maze::SIZE> *maze);
+template bool Convert<smartmouse::maze::SIZE>(const smartmouse::msgs::Maze &maze,
+                                              basic_maze_walls_t<smartmouse::maze::SIZE> &maze_lines);
+#endif
+
 }
 }
@@ -1,19 +1,39 @@
 #pragma once
 
 #include <common/core/AbstractMaze.h>
+#include <common/core/MazeFile.h>
 #include <sim/simulator/msgs/maze.pb.h>
 #include <sim/simulator/msgs/robot_description.pb.h>
 #include <ignition/math.hh>
 
 namespace smartmouse {
 namespace msgs {
-smartmouse::msgs::Maze Convert(AbstractMaze *maze, std::string name = "", int size = smartmouse::maze::SIZE);
+template<unsigned int S>
+smartmouse::msgs::Maze Convert(BasicMaze<S> *maze, std::string name = "");
 
+/** \brief whether the message is for an SxS maze and all of its walls are inside it */
+template<unsigned int S>
+bool FitsMaze(const smartmouse::msgs::Maze &maze_msg);
+
+/** \return false, leaving maze as it was, if the message doesn't fit an SxS maze */
+template<unsigned int S>
+bool Convert(const smartmouse::msgs::Maze &maze_msg, BasicMaze<S> *maze);
+
+/** \brief the maze in the message, or a maze of all walls if the message is for a different size of maze */
 AbstractMaze Convert(smartmouse::msgs::Maze maze_msg);
 
+smartmouse::msgs::Maze Convert(const MazeRecord &record);
+
+MazeRecord ConvertToRecord(smartmouse::msgs::Maze maze_msg);
+
+
+template<unsigned int S>
+using basic_maze_walls_t = std::vector<smartmouse::msgs::WallPoints>[S][S];
+typedef basic_maze_walls_t<smartmouse::maze::SIZE> maze_walls_t;
 
-typedef std::vector<smartmouse::msgs::WallPoints> maze_walls_t[smartmouse::maze::SIZE][smartmouse::maze::SIZE];
-void Convert(smartmouse::msgs::Maze maze, maze_walls_t &maze_lines);
+/** \return false, leaving maze_lines as they were, if the message doesn't fit an SxS maze */
+template<unsigned int S>
+bool Convert(const smartmouse::msgs::Maze &maze, basic_maze_walls_t<S> &maze_lines);
 
 ::Direction Convert(smartmouse::msgs::Direction dir_msg);
 
@@ -10,6 +10,10 @@
 #include <sim/simulator/lib/Server.h>
 #include <msgs/world_statistics.pb.h>
 #include <lib/common/RayTracing.h>
+#include <thread>
+#include <sim/lib/SimTimer.h>
+#include <sim/simulator/lib/LockStep.h>
+#include <sim/simulator/lib/common/RayCastGrid.h>
 
 TEST(MsgsTest, ConvertMillis) {
   ignition::msgs::Time t = smartmouse::msgs::Convert(10);
@@ -92,6 +96,49 @@ TEST(MsgsTest, MazeConversion) {
   EXPECT_EQ(maze, maze2);
 }
 
+TEST(MsgsTest, MazeSizeMismatch) {
+  BasicMaze<8> small_maze;
+  small_maze.connect_neighbor(3, 3, Direction::E);
+  smartmouse::msgs::Maze small_msg = smartmouse::msgs::Convert(&small_maze);
+  EXPECT_EQ(small_msg.size(), 8);
+
+  // an 8x8 maze only converts back into 8x8 types
+  BasicMaze<8> small_maze2;
+  EXPECT_TRUE(smartmouse::msgs::Convert(small_msg, &small_maze2));
+  EXPECT_EQ(small_maze, small_maze2);
+  BasicMaze<16> big_maze;
+  EXPECT_FALSE(smartmouse::msgs::Convert(small_msg, &big_maze));
+
+  smartmouse::msgs::basic_maze_walls_t<8> small_walls;
+  EXPECT_TRUE(smartmouse::msgs::Convert(small_msg, small_walls));
+  smartmouse::msgs::basic_maze_walls_t<16> big_walls;
+  EXPECT_FALSE(smartmouse::msgs::Convert(small_msg, big_walls));
+
+  // and a wall outside of the maze is rejected even if the size is right
+  smartmouse::msgs::Maze big_msg = smartmouse::msgs::Convert(&big_maze);
+  EXPECT_FALSE(smartmouse::msgs::Convert(big_msg, small_walls));
+  big_msg.clear_size();
+  EXPECT_FALSE(smartmouse::msgs::Convert(big_msg, small_walls));
+  EXPECT_TRUE(smartmouse::msgs::Convert(big_msg, big_walls));
+}
+
+TEST(MsgsTest, MazeRecordConversion) {
+  std::ifstream fs;
+  fs.open("../../../mazes/16x16.mz", std::ifstream::in);
+  ASSERT_TRUE(fs.good());
+  AbstractMaze maze(fs);
+  MazeRecord record = MazeRecord::from_maze(&maze, "16x16");
+
+  smartmouse::msgs::Maze maze_msg = smartmouse::msgs::Convert(record);
+  EXPECT_EQ(maze_msg.name(), "16x16");
+  EXPECT_EQ(smartmouse::msgs::Convert(maze_msg), maze);
+
+  MazeRecord round_trip = smartmouse::msgs::ConvertToRecord(maze_msg);
+  EXPECT_EQ(round_trip.get_name(), "16x16");
+  EXPECT_EQ(round_trip.route_length, record.route_length);
+  EXPECT_TRUE(round_trip.to_wall_grid() == record.to_wall_grid());
+}
+
 TEST(MsgsTest, WallToCoordinates) {
   smartmouse::msgs::Wall wall;
   double c1, r1, c2, r2;
@@ -178,6 +225,109 @@ TEST(ServerTest, StepTimeTest) {
   EXPECT_NEAR(actual_total_time, expected_total_time, 0.1 * N);
 }
 
+TEST(ServerTest, AsFastAsPossibleTest) {
+  // no Connect and no thread, the server is driven in-process
+  Server server;
+
+  smartmouse::msgs::PhysicsConfig physics_msg;
+  physics_msg.set_as_fast_as_possible(true);
+  physics_msg.set_publish_rate_hz(50);
+  server.OnPhysics(physics_msg);
+
+  smartmouse::msgs::ServerControl unpause_msg;
+  unpause_msg.set_pause(false);
+  server.OnServerControl(unpause_msg);
+
+  size_t N = 10000;
+  Time start = Time::GetWallTime();
+  for (size_t i = 0; i < N; i++) {
+    server.Run();
+  }
+  Time end = Time::GetWallTime();
+
+  // ten seconds of sim time should take nowhere near ten seconds
+  double expected_sim_time = (double) (N * server.getNsOfSimPerStep()) / 1000000000.0;
+  EXPECT_NEAR(server.GetSimTime().Double(), expected_sim_time, 1e-6);
+  EXPECT_LT((end - start).Double(), expected_sim_time / 10);
+
+  // stepping directly ignores pause
+  smartmouse::msgs::ServerControl pause_msg;
+  pause_msg.set_pause(true);
+  server.OnServerControl(pause_msg);
+  server.RunSteps(N);
+  EXPECT_NEAR(server.GetSimTime().Double(), 2 * expected_sim_time, 1e-6);
+}
+
+TEST(SimTimerTest, WaitUntilTest) {
+  SimTimer timer;
+  unsigned long woke_at = 0;
+  std::thread waiter([&]() { woke_at = timer.waitUntilMs(30); });
+  while (!timer.hasWaiters()) {
+    std::this_thread::yield();
+  }
+
+  // the waiter sleeps through these, and wakes on the first time at or past 30
+  for (unsigned long t_ms = 0; t_ms <= 50; t_ms += 20) {
+    timer.setSimTimeMs(t_ms);
+  }
+  waiter.join();
+
+  EXPECT_EQ(woke_at, 40ul);
+}
+
+TEST(SimTimerTest, WaitUntilResetTest) {
+  SimTimer timer;
+  timer.setSimTimeMs(500);
+
+  unsigned long woke_at = 0;
+  std::thread waiter([&]() { woke_at = timer.waitUntilMs(510); });
+  while (!timer.hasWaiters()) {
+    std::this_thread::yield();
+  }
+
+  // resetting the server's time would otherwise leave the waiter asleep until sim time gets back up to 510
+  timer.setSimTimeMs(0);
+  waiter.join();
+
+  EXPECT_EQ(woke_at, 0ul);
+  EXPECT_FALSE(timer.hasWaiters());
+}
+
+TEST(LockStepTest, ReproducibleTest) {
+  auto drive = []() {
+    std::ifstream maze_fs;
+    maze_fs.open("../../../mazes/16x16.mz", std::ifstream::in);
+    std::ifstream mouse_fs;
+    mouse_fs.open("../../../mice/2017.ms", std::ifstream::in);
+    EXPECT_TRUE(maze_fs.good());
+    EXPECT_TRUE(mouse_fs.good());
+    AbstractMaze maze(maze_fs);
+
+    Server server;
+    server.OnMaze(smartmouse::msgs::Convert(&maze));
+    server.OnRobotDescription(smartmouse::msgs::Convert(mouse_fs));
+
+    SimMouse mouse;
+    mouse.lockStepInit();
+    LockStep lock_step(&server, &mouse);
+    mouse.setSpeedCps(1, 1);
+    for (int i = 0; i < 100; i++) {
+      lock_step.Step();
+    }
+    return server.GetRobotState();
+  };
+
+  auto first = drive();
+  auto second = drive();
+
+  // one second of driving forward, and exactly the same both times
+  EXPECT_GT(first.p().col(), 0.5);
+  EXPECT_EQ(first.p().col(), second.p().col());
+  EXPECT_EQ(first.p().row(), second.p().row());
+  EXPECT_EQ(first.p().yaw(), second.p().yaw());
+  EXPECT_EQ(first.front(), second.front());
+}
+
 TEST(RayTracingTest, DistanceToWallTest) {
   {
     ignition::math::Line2d wall({1, -0.5}, {1, 0.5});
@@ -219,6 +369,89 @@ TEST(RayTracingTest, DistanceToWallTest) {
   }
 }
 
+TEST(RayCastGridTest, MatchesBruteForceTest) {
+  srand(0);
+  AbstractMaze maze = AbstractMaze::gen_random_legal_maze();
+  smartmouse::msgs::maze_walls_t maze_walls;
+  smartmouse::msgs::Convert(smartmouse::msgs::Convert(&maze), maze_walls);
+
+  std::vector<RayCastGrid::WallRect> walls;
+  std::vector<ignition::math::Line2d> lines;
+  for (unsigned int r = 0; r < smartmouse::maze::SIZE; r++) {
+    for (unsigned int c = 0; c < smartmouse::maze::SIZE; c++) {
+      for (auto wall : maze_walls[r][c]) {
+        walls.push_back({wall.c1(), wall.r1(), wall.c2(), wall.r2()});
+        lines.push_back(ignition::math::Line2d(wall.c1(), wall.r1(), wall.c1(), wall.r2()));
+        lines.push_back(ignition::math::Line2d(wall.c1(), wall.r2(), wall.c2(), wall.r2()));
+        lines.push_back(ignition::math::Line2d(wall.c2(), wall.r2(), wall.c2(), wall.r1()));
+        lines.push_back(ignition::math::Line2d(wall.c2(), wall.r1(), wall.c1(), wall.r1()));
+      }
+    }
+  }
+
+  RayCastGrid grid;
+  grid.Build(walls);
+
+  const double max_range = 2.0;
+  for (unsigned int i = 0; i < 1000; i++) {
+    double col = smartmouse::maze::SIZE * (double) rand() / RAND_MAX;
+    double row = smartmouse::maze::SIZE * (double) rand() / RAND_MAX;
+    double theta = 2 * M_PI * (double) rand() / RAND_MAX;
+    ignition::math::Vector2d origin(col, row);
+    ignition::math::Vector2d direction(cos(theta), sin(theta));
+
+    double expected = max_range;
+    for (auto line : lines) {
+      auto range = RayTracing::distance_to_wall(line, origin, direction);
+      if (range && *range < expected) {
+        expected = *range;
+      }
+    }
+
+    EXPECT_NEAR(grid.Cast(col, row, cos(theta), sin(theta), max_range), expected, 1e-6);
+  }
+}
+
+TEST(RayCastGridTest, BatchMatchesSingleTest) {
+  srand(1);
+  AbstractMaze maze = AbstractMaze::gen_random_legal_maze();
+  smartmouse::msgs::maze_walls_t maze_walls;
+  smartmouse::msgs::Convert(smartmouse::msgs::Convert(&maze), maze_walls);
+
+  std::vector<RayCastGrid::WallRect> walls;
+  for (unsigned int r = 0; r < smartmouse::maze::SIZE; r++) {
+    for (unsigned int c = 0; c < smartmouse::maze::SIZE; c++) {
+      for (auto wall : maze_walls[r][c]) {
+        walls.push_back({wall.c1(), wall.r1(), wall.c2(), wall.r2()});
+      }
+    }
+  }
+
+  RayCastGrid grid;
+  grid.Build(walls);
+
+  const double max_range = 1.0;
+  for (unsigned int i = 0; i < 1000; i++) {
+    double col = smartmouse::maze::SIZE * (double) rand() / RAND_MAX;
+    double row = smartmouse::maze::SIZE * (double) rand() / RAND_MAX;
+    RayCastGrid::RayBatch origin_col, origin_row, dir_col, dir_row;
+    for (int k = 0; k < RayCastGrid::BATCH; k++) {
+      // include rays straight along the grid, where one direction is exactly zero
+      double theta = (k == 0) ? M_PI / 2 : 2 * M_PI * (double) rand() / RAND_MAX;
+      // most of the time close together, like a robot's sensors, and sometimes too spread out to share any cells
+      origin_col[k] = col + ((i % 4 == 0) ? 1.0 : 0.1) * k;
+      origin_row[k] = row;
+      dir_col[k] = (k == 0) ? 0 : cos(theta);
+      dir_row[k] = sin(theta);
+    }
+
+    RayCastGrid::RayBatch ranges = grid.CastBatch(origin_col, origin_row, dir_col, dir_row, max_range);
+    for (int k = 0; k < RayCastGrid::BATCH; k++) {
+      EXPECT_DOUBLE_EQ(ranges[k], grid.Cast(origin_col[k], origin_row[k], dir_col[k], dir_row[k], max_range));
+    }
+  }
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();